@@ -5,6 +5,9 @@
 #include <stdint.h>
 
 #include <libavutil/avstring.h>
+#include <libavutil/crc.h>
+#include <libavutil/display.h>
+#include <libavutil/mastering_display_metadata.h>
 #include <libavutil/eval.h>
 #include <libavutil/mathematics.h>
 #include <libavutil/pixdesc.h>
@@ -14,12 +17,12 @@
 #include <libavutil/samplefmt.h>
 #include <libavutil/avassert.h>
 #include <libavutil/time.h>
+#include <libavutil/tx.h>
 #include <libavformat/avformat.h>
 #include <libavdevice/avdevice.h>
 #include <libswscale/swscale.h>
 #include <libavutil/opt.h>
 #include <libavcodec/avcodec.h>
-#include <libavcodec/avfft.h>
 #include <libswresample/swresample.h>
 
 #include <SDL2/SDL.h>
@@ -27,6 +30,33 @@
 
 #include <assert.h>
 
+#include "subtitle_font.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define HAVE_MMAP_IO 1
+#define HAVE_PREAD_IO 1
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+#endif
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_RW_CUR_POS)
+#define HAVE_IO_URING 1
+#else
+#define HAVE_IO_URING 0
+#endif
+#else
+#include <direct.h>
+#define HAVE_MMAP_IO 0
+#define HAVE_PREAD_IO 0
+#define HAVE_IO_URING 0
+#endif
+
 const char program_name[] = "ffplayer";
 const int program_birth_year = 2018;
 
@@ -66,12 +96,66 @@ const int program_birth_year = 2018;
 /* polls for possible required screen refresh at least this often, should be less than 1/fps */
 #define REFRESH_RATE 0.01
 
-/* NOTE: the size must be big enough to compensate the hardware audio buffersize size */
-/* TODO: We assume that a decoded and resampled frame fits into this buffer */
-#define SAMPLE_ARRAY_SIZE (8 * 65536)
+/* audio visualization: frames kept of the played audio, a power of two that covers the
+   hardware and decode buffers plus one FFT, and the largest FFT */
+#define VIS_RING_FRAMES 32768
+#define VIS_TX_BITS_MAX 13
 
 #define CURSOR_HIDE_DELAY 1000000
 
+/* AVIO buffer handed to avio_alloc_context() for custom I/O, reads bypass it in direct mode */
+#define CUSTOM_IO_BUFFER_SIZE 32768
+/* largest part of a file mapped at once, keeps 32-bit address spaces usable for huge files */
+#define MMAP_IO_WINDOW_SIZE (sizeof(void *) >= 8 ? ((int64_t)1 << 30) : ((int64_t)64 << 20))
+/* how far ahead of the read position the kernel is asked to prefetch */
+#define MMAP_IO_WILLNEED_SIZE (8 << 20)
+/* read-ahead I/O: block-aligned reads of this size are issued to the worker threads */
+#define READAHEAD_IO_BLOCK_SIZE (1 << 20)
+/* blocks kept in memory, either in flight or cached */
+#define READAHEAD_IO_NB_BLOCKS 8
+/* blocks requested ahead of the read position once access looks sequential */
+#define READAHEAD_IO_DEPTH 4
+#define READAHEAD_IO_NB_THREADS 3
+/* latency histogram buckets, bucket i counts reads that took less than 2^i us */
+#define READAHEAD_IO_HIST_SIZE 32
+
+/* byte to time map used by byte based seeking */
+#define BYTE_TIME_MAP_MAX_ENTRIES 4096
+#define BYTE_TIME_MAP_MIN_SPACING (64 * 1024)
+#define BYTE_TIME_MAP_PROBE_POINTS 64
+#define BYTE_TIME_MAP_PROBE_PACKETS 256
+#define BYTE_TIME_MAP_PROBE_INTERVAL 20
+/* a byte seek landing further than this from its target is retried once, in seconds */
+#define BYTE_SEEK_RETRY_THRESHOLD 2.0
+
+/* backoff between retries of a stalled read, doubled each time, in ms */
+#define IO_RETRY_BACKOFF_MIN 100
+#define IO_RETRY_BACKOFF_MAX 5000
+
+/* disk backed timeshift ring for live inputs */
+#define TIMESHIFT_SEGMENT_SIZE (4 * 1024 * 1024)
+#define TIMESHIFT_MAX_INDEX 16384
+#define TIMESHIFT_REPORT_INTERVAL 10000000
+
+/* bytes of packets the recorder may hold before dropping */
+#define RECORD_QUEUE_SIZE (32 * 1024 * 1024)
+
+/* the primary input plus its backups */
+#define MAX_INPUTS 8
+#define MAX_SIDECARS 4
+/* switched away inputs waiting for the decoders to be done with their streams */
+#define MAX_RETIRED_INPUTS 4
+
+/* I/O operation the interrupt callback currently enforces a deadline for */
+enum
+{
+    IO_OP_NONE,
+    IO_OP_OPEN,
+    IO_OP_PROBE,
+    IO_OP_READ,
+    IO_OP_SEEK,
+};
+
 static unsigned sws_flags = SWS_BICUBIC;
 
 typedef struct MyAVPacketList
@@ -94,7 +178,48 @@ typedef struct PacketQueue
 } PacketQueue;
 
 #define VIDEO_PICTURE_QUEUE_SIZE 3
+/* the shown picture plus the next two uploaded ahead of their deadline */
+#define VIDEO_TEXTURE_POOL 3
+/* rows per hashed band, even so that 4:2:0 chroma rows split with luma */
+#define UPLOAD_BAND_HEIGHT 16
+/* high bit depth reduction and tone mapping */
+#define SLICE_THREADS_MAX 16
+#define TONEMAP_LUT_SIZE 33
+#define TONEMAP_SDR_WHITE 203.0 /* nits, BT.2408 reference white */
+#define TONEMAP_CHUNK 64 /* pixels set up together before their lookups */
+/* startup renderer probe: picture size and number of timed presents per driver */
+#define RENDERER_PROBE_WIDTH 1920
+#define RENDERER_PROBE_HEIGHT 1080
+#define RENDERER_PROBE_FRAMES 30
+/* events waiting for the render thread, a power of two */
+#define EVENT_RING_SIZE 256
+/* longer gaps between presents are pauses, not jitter */
+#define PRESENT_INTERVAL_MAX 250000
+/* stats overlay: text grid in font cells, frame-time graph of the last presents, redraws at most every interval */
+#define OVERLAY_COLS 34
+#define OVERLAY_LINES 9
+#define OVERLAY_BARS 6
+#define OVERLAY_BAR_COLS 10
+#define OVERLAY_GRAPH_LEN 128
+#define OVERLAY_GRAPH_MAX 50000 /* microseconds at the top of the graph */
+#define OVERLAY_INTERVAL 100000
+#ifdef __APPLE__
+/* Cocoa wants windows and their renderer on the main thread */
+#define RENDER_THREAD_DEFAULT 0
+#else
+#define RENDER_THREAD_DEFAULT 1
+#endif
+#define ZOOM_MAX 16.0
+#define ZOOM_STEP 1.25
 #define SUBPICTURE_QUEUE_SIZE 16
+/* regions of sub_texture remembered for clearing, more rects are tracked by their bounding box */
+#define SUB_DIRTY_MAX 16
+/* text subtitles: limits of one event, glyphs cached per line height and code point */
+#define TEXT_SUB_MAX_CHARS 1024
+#define TEXT_SUB_MAX_LINES 16
+#define GLYPH_CACHE_SIZE 1024
+/* side of the texture the render thread keeps subtitle glyphs in */
+#define GLYPH_ATLAS_SIZE 2048
 #define SAMPLE_QUEUE_SIZE 9
 #define FRAME_QUEUE_SIZE FFMAX(SAMPLE_QUEUE_SIZE, FFMAX(VIDEO_PICTURE_QUEUE_SIZE, SUBPICTURE_QUEUE_SIZE))
 
@@ -118,6 +243,16 @@ typedef struct Clock
     int *queue_serial; /* pointer to the current packet queue serial, used for obsolete clock detection */
 } Clock;
 
+/* glyph of a text subtitle, placed and rasterized by the subtitle thread, drawn from the glyph atlas */
+typedef struct SubGlyph
+{
+    uint32_t cp;
+    int size; /* line height */
+    int x, y; /* pen position on the canvas, y is the top of the line */
+    int xoff, top, w, h, border;
+    AVBufferRef *bitmap; /* w x h coverage then the (w + 2 * border) x (h + 2 * border) outline, uploaded on an atlas miss */
+} SubGlyph;
+
 /* Common struct for handling all types of decoded data and allocated render buffers. */
 typedef struct Frame
 {
@@ -132,7 +267,17 @@ typedef struct Frame
     int format;
     AVRational sar;
     int uploaded;
+    int tex_index; /* slot of vid_slots holding the picture once uploaded */
+    uint64_t *band_hash; /* content hash per UPLOAD_BAND_HEIGHT rows, from the decoder thread */
+    unsigned int band_hash_size;
+    int nb_bands; /* 0 when not hashed */
     int flip_v;
+    int attached; /* decoded attached picture (album art), displayed from attached_pic_texture */
+    uint8_t *sub_pixels; /* subtitle rects rasterized to ARGB one after the other, pitch w * 4 */
+    unsigned int sub_pixels_size;
+    SubGlyph *sub_glyphs; /* text subtitles: glyphs placed on the canvas, drawn from the glyph atlas */
+    unsigned int sub_glyphs_size;
+    int nb_sub_glyphs;
 } Frame;
 
 typedef struct FrameQueue
@@ -156,6 +301,15 @@ enum
     AV_SYNC_EXTERNAL_CLOCK, /* synchronize to an external clock */
 };
 
+/* what the window shows for audio without video */
+enum ShowMode
+{
+    SHOW_MODE_NONE,
+    SHOW_MODE_WAVES,
+    SHOW_MODE_RDFT,
+    SHOW_MODE_NB
+};
+
 typedef struct Decoder
 {
     AVPacket pkt;
@@ -169,9 +323,392 @@ typedef struct Decoder
     AVRational start_pts_tb;
     int64_t next_pts;
     AVRational next_pts_tb;
+    double accurate_seek_pts; /* frames of accurate_seek_serial ending before this are dropped */
+    int accurate_seek_serial;
+    int64_t decode_busy; /* in send_packet and receive_frame since the last frame */
+    int64_t decode_time; /* running average per frame, microseconds */
     SDL_Thread *decoder_tid;
 } Decoder;
 
+typedef struct MmapIO
+{
+    AVIOContext *pb;
+    int fd;
+    int64_t file_size;
+    int64_t pos;
+    uint8_t *window; /* mapped part of the file, [window_offset, window_offset + window_size) */
+    int64_t window_offset;
+    int64_t window_size;
+    int64_t willneed_end; /* file offset up to which MADV_WILLNEED has been issued */
+    int64_t page_size;
+    int64_t nb_reads;
+    int64_t nb_syscalls;
+    int64_t bytes_read;
+    int64_t start_time;
+} MmapIO;
+
+enum
+{
+    READAHEAD_BLOCK_FREE,
+    READAHEAD_BLOCK_QUEUED,
+    READAHEAD_BLOCK_READING,
+    READAHEAD_BLOCK_READY,
+};
+
+typedef struct ReadaheadBlock
+{
+    uint8_t *data;
+    int64_t offset; /* block-aligned file offset */
+    int size;       /* valid bytes once READY, may be short at the end of the file */
+    int state;
+    int error;
+    int generation; /* bumped on cancel, a worker finishing an older generation drops its result */
+    int64_t last_used;
+} ReadaheadBlock;
+
+#if HAVE_IO_URING
+/* submission and completion rings shared with the kernel */
+typedef struct ReadaheadUring
+{
+    int fd;
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+} ReadaheadUring;
+#endif
+
+typedef struct ReadaheadIO
+{
+    AVIOContext *pb;
+    AVIOInterruptCB interrupt_callback;
+    int fd;
+    int64_t file_size;
+    int64_t pos;
+    int64_t next_pos; /* where a sequential reader continues */
+    int sequential;   /* number of consecutive sequential reads */
+    ReadaheadBlock blocks[READAHEAD_IO_NB_BLOCKS];
+    int64_t use_counter;
+    int abort_request;
+    SDL_mutex *mutex;
+    SDL_cond *work_cond;
+    SDL_cond *done_cond;
+    SDL_Thread *threads[READAHEAD_IO_NB_THREADS];
+#if HAVE_IO_URING
+    ReadaheadUring *uring; /* NULL when the pread workers serve the blocks */
+    int uring_inflight;
+#endif
+    int64_t nb_reads;
+    int64_t nb_hits;
+    int64_t nb_cancelled;
+    int64_t latency_max;
+    int64_t latency_hist[READAHEAD_IO_HIST_SIZE];
+} ReadaheadIO;
+
+typedef struct ByteTimeEntry
+{
+    int64_t pos;
+    int64_t ts; /* AV_TIME_BASE units */
+} ByteTimeEntry;
+
+/* packet header in the timeshift ring, followed by the payload padded to 8 bytes */
+typedef struct TimeshiftRecord
+{
+    int32_t size; /* -1 marks padding up to the end of the ring */
+    int32_t stream_index;
+    int32_t flags;
+    int32_t reserved;
+    int64_t pts;
+    int64_t dts;
+    int64_t duration;
+    int64_t pos;
+} TimeshiftRecord;
+
+typedef struct TimeshiftIndexEntry
+{
+    int64_t offset; /* absolute ring offset of a keyframe record */
+    int64_t ts;     /* AV_TIME_BASE units */
+} TimeshiftIndexEntry;
+
+/* offsets are absolute and only grow, the file position is offset % size */
+typedef struct TimeshiftRing
+{
+    int fd;
+    uint8_t *data;
+    int64_t size;
+    int64_t head;     /* next write */
+    int64_t tail;     /* oldest valid byte, always a segment start */
+    int64_t read_pos; /* next record for the feeder */
+    int flush_req;    /* read_pos jumped, the feeder starts a new serial */
+    int source_eof;   /* the input ended, the feeder drains the decoders once it reaches head */
+    int eof_queued;   /* the null packets for the current end are queued */
+
+    int index_stream; /* keyframes of this stream are indexed */
+    TimeshiftIndexEntry index[TIMESHIFT_MAX_INDEX];
+    int index_start;
+    int nb_index;
+    int64_t last_ts;
+
+    SDL_mutex *mutex;
+    SDL_cond *cond;
+    SDL_Thread *feeder_tid;
+    SDL_sem *feeder_done; /* posted when the feeder exits */
+    int abort;
+
+    int64_t start_time;
+    int64_t bytes_written;
+    int64_t write_time;
+    int64_t last_report;
+    int64_t report_bytes;
+    int nb_overruns;
+    int64_t bytes_lost;
+} TimeshiftRing;
+
+typedef struct GlyphCacheEntry
+{
+    int size; /* line height the glyph was scaled for, 0 for a free slot */
+    uint32_t cp;
+    int xoff, top, w, h;
+    int advance;
+    uint8_t *alpha;
+    AVBufferRef *bitmap; /* alpha and its outline for the glyph atlas, built on first use */
+} GlyphCacheEntry;
+
+typedef struct TextLine
+{
+    int start, end; /* code points of the line */
+    int width;
+} TextLine;
+
+/* draws text/ASS subtitles with the built-in font, owned by the subtitle thread */
+typedef struct TextRenderer
+{
+    GlyphCacheEntry glyphs[GLYPH_CACHE_SIZE]; /* open addressing on (size, code point) */
+    int nb_glyphs;
+    int64_t hits, misses;
+    uint8_t *fill, *edge; /* coverage of the text and of its outline */
+    unsigned int fill_size, edge_size;
+    int64_t render_time;
+    int nb_rendered;
+} TextRenderer;
+
+typedef struct GlyphAtlasEntry
+{
+    int size; /* 0 for a free slot */
+    uint32_t cp;
+    SDL_Rect fill, edge; /* the glyph and its outline in the atlas texture */
+} GlyphAtlasEntry;
+
+/* glyphs of text subtitles packed in rows into one texture, owned by the render thread */
+typedef struct GlyphAtlas
+{
+    SDL_Texture *texture;
+    int size;
+    GlyphAtlasEntry entries[GLYPH_CACHE_SIZE]; /* open addressing on (size, code point) */
+    int nb_entries;
+    int row_x, row_y, row_h; /* free space starts at (row_x, row_y), rows are as high as their tallest glyph */
+    uint32_t *pixels;
+    unsigned int pixels_size;
+    int nb_uploads, nb_resets;
+    int64_t upload_bytes;
+    int64_t draw_time;
+    int nb_draws;
+} GlyphAtlas;
+
+/* pictures scaled to the window format by the player when SDL only has its software renderer */
+typedef struct SoftOutput
+{
+    struct SwsContext *sws;
+    int src_w, src_h, src_format;
+    int dst_w, dst_h, dst_format;
+    int nb_threads;
+    AVFrame *src, *dst;
+    SDL_Texture *texture; /* display rect sized, copied 1:1 */
+    int64_t time;
+    int nb_frames;
+} SoftOutput;
+
+/* what the stats overlay shows, compared as a whole to skip redraws */
+typedef struct StatsOverlayContent
+{
+    char text[OVERLAY_LINES][OVERLAY_COLS + 1];
+    uint8_t bar[OVERLAY_BARS]; /* fill in 1/255 */
+    uint8_t graph[OVERLAY_GRAPH_LEN]; /* heights in pixels, oldest first */
+    uint8_t graph_mark; /* height of the nominal frame duration */
+} StatsOverlayContent;
+
+/* on-screen stats, composed on the CPU from a fixed-width atlas of the built-in font */
+typedef struct StatsOverlay
+{
+    uint8_t *font; /* alpha of the printable ASCII glyphs, one cell_w x cell_h cell each */
+    int font_size, cell_w, cell_h;
+    uint32_t *pixels;
+    SDL_Texture *texture;
+    int w, h;
+    StatsOverlayContent shown;
+    int64_t last_update;
+    int32_t frame_times[OVERLAY_GRAPH_LEN]; /* present intervals, a ring */
+    int frame_time_index, nb_frame_times;
+    int64_t present_time, present_block; /* running averages, microseconds */
+    int nb_redraws;
+} StatsOverlay;
+
+/* audio as played, written by the audio callback thread and read by the render thread */
+typedef struct SampleRing
+{
+    int16_t *samples; /* interleaved, VIS_RING_FRAMES frames */
+    int channels;
+    SDL_atomic_t write; /* frames written so far, wraps */
+} SampleRing;
+
+/* waves and spectrum display, everything allocated only while one of them is shown */
+typedef struct AudioVis
+{
+    SampleRing *ring; /* swapped with the audio device locked */
+    AVTXContext *tx;
+    av_tx_fn tx_fn;
+    int tx_bits;
+    AVComplexFloat *tx_in, *tx_out;
+    int16_t *window; /* frames copied out of the ring */
+    unsigned int window_size;
+    SDL_Point *points;
+    unsigned int points_size;
+    SDL_Texture *texture; /* spectrogram, one column per rdftspeed, xpos is the next to write */
+    int xpos;
+    double column_time;
+    double last_time;
+    unsigned int last_end; /* ring position shown last, kept while paused */
+} AudioVis;
+
+/* SDL events on their way from the main thread, which has to pump them, to the render thread */
+typedef struct EventRing
+{
+    SDL_Event events[EVENT_RING_SIZE];
+    SDL_atomic_t head; /* written by the main thread only */
+    SDL_atomic_t tail; /* written by the render thread only */
+    SDL_sem *wake;     /* posted per event, the render thread sleeps on it between refreshes */
+} EventRing;
+
+/* a texture of the video pool and the content it holds */
+typedef struct TextureSlot
+{
+    SDL_Texture *tex;
+    uint64_t *band_hash;
+    unsigned int band_hash_size;
+    int nb_bands; /* 0 when the content is unknown */
+    int width, height, format;
+    SDL_Rect area; /* part of the picture the texture holds */
+} TextureSlot;
+
+/* abort flag and deadline of the I/O a helper thread is in, polled by helper_io_interrupt_cb */
+typedef struct HelperIO
+{
+    int abort;
+    int64_t deadline; /* INT64_MAX when the current I/O has no deadline */
+} HelperIO;
+
+/* separate audio or subtitle file played along with the main input */
+typedef struct Sidecar
+{
+    struct VideoState *is;
+    const char *filename;
+    AVFormatContext *ic;
+    int stream_index;
+    enum AVMediaType type;
+    int64_t ts_offset; /* from sidecar to main input timestamps, AV_TIME_BASE units */
+    SDL_Thread *tid;
+    SDL_sem *done; /* posted when the thread exits */
+    HelperIO io;
+    SDL_mutex *mutex; /* held while queueing, so a seek can flush without racing the thread */
+    SDL_cond *cond;
+    int seek_req;
+    int64_t seek_pos;
+    int eof;
+} Sidecar;
+
+/* remuxes the played packets to a file on its own thread */
+typedef struct Recorder
+{
+    AVFormatContext *oc;
+    PacketQueue q; /* bounded by RECORD_QUEUE_SIZE, the read thread drops instead of waiting */
+    SDL_Thread *tid;
+    SDL_sem *done; /* posted when the thread exits */
+    HelperIO io;
+    int out_index[AVMEDIA_TYPE_NB];
+    int video_wait_keyframe;
+
+    /* what each output stream was opened from, a played stream that no longer matches is not muxed into it */
+    AVCodecParameters *src_par[AVMEDIA_TYPE_NB];
+    AVStream *src_st[AVMEDIA_TYPE_NB];
+    int src_match[AVMEDIA_TYPE_NB];
+    int stopped;
+
+    /* recording timeline, continuous across seeks, AV_TIME_BASE units */
+    int64_t ts_offset;
+    int64_t end_ts;
+    int64_t last_dts[AVMEDIA_TYPE_NB];
+
+    int64_t nb_written;
+    int64_t bytes_written;
+    int nb_overflows;
+    int nb_late;
+} Recorder;
+
+/* an alternate input opened in parallel while the current one plays or stalls */
+typedef struct InputOpener
+{
+    const char *filename;
+    int index; /* in input_filenames */
+    AVFormatContext *ic;
+    int ret;
+    HelperIO io;
+    SDL_Thread *tid;
+    SDL_sem *done;
+} InputOpener;
+
+/* an input replaced by a switch, with the queue serials the switch started */
+typedef struct RetiredInput
+{
+    AVFormatContext *ic;
+    int serial[3]; /* audioq, videoq and subtitleq */
+} RetiredInput;
+
+/* monotone byte position to timestamp map, learned from played packets and a background probe */
+typedef struct ByteTimeMap
+{
+    SDL_mutex *mutex;
+    ByteTimeEntry *entries; /* sorted by pos, ts never decreasing */
+    int nb_entries;
+    int nb_rejected; /* points breaking monotonicity, i.e. timestamp discontinuities */
+    int dirty;
+    int64_t file_size;
+    int64_t spacing;  /* minimum distance in bytes between two points */
+    int stream_index; /* packets of this stream feed the map */
+    int stream_id;    /* AVStream.id and codec of it, to find it again in the probe's own demuxer */
+    enum AVCodecID codec_id;
+    char *cache_path;
+
+    char *filename;
+    const AVInputFormat *iformat;
+    SDL_Thread *probe_tid;
+    SDL_sem *probe_done; /* posted when the probe thread exits */
+    HelperIO probe_io;
+
+    int nb_seeks;
+    int nb_retries;
+    double seek_error_sum;
+    double seek_error_max;
+} ByteTimeMap;
+
 typedef struct VideoState
 {
     SDL_Thread *read_tid;
@@ -187,6 +724,43 @@ typedef struct VideoState
     int64_t seek_rel;
     int read_pause_return;
     AVFormatContext *ic;
+    MmapIO *mmio;
+    ReadaheadIO *raio;
+    ByteTimeMap *btmap;
+    SDL_mutex *btmap_mutex; /* held while another thread than the read thread uses btmap, which an input switch replaces */
+    TimeshiftRing *tshift;
+    Recorder *rec;
+    Sidecar *sidecars[MAX_SIDECARS];
+    int nb_sidecars;
+    Sidecar *audio_sidecar; /* feeding audioq instead of the main input */
+    Sidecar *subtitle_sidecar;
+    int io_op;
+    int64_t io_deadline;
+    int io_timed_out; /* the current operation was interrupted by its deadline */
+    int io_retry;     /* consecutive stalled reads */
+    int nb_io_stalls;
+    int nb_io_retries;
+    SDL_sem *read_thread_done;
+    int input_index;             /* index in input_filenames of the input being read */
+    InputOpener *opener;
+    RetiredInput retired[MAX_RETIRED_INPUTS];
+    int nb_retired;
+    /* the read thread hands a switch to the event thread, which owns the streams, and waits under switch_mutex */
+    SDL_mutex *switch_mutex;
+    SDL_cond *switch_cond;
+    AVFormatContext *switch_ic; /* NULL once switched, or taken back on abort */
+    int switch_index;
+    int64_t input_stall_start;   /* when reading started failing, 0 while packets flow */
+    int64_t next_failback_time;
+    int video_wait_keyframe; /* drop video until a keyframe after an input switch */
+    int nb_input_switches;
+    int64_t seek_target_ts;   /* time a byte seek aims for, AV_NOPTS_VALUE if unknown */
+    int64_t byte_seek_target; /* landing of the last byte seek still to be checked */
+    int byte_seek_retry;      /* the last byte seek was the corrective retry */
+    int byte_seek_retry_req;
+    int64_t *stream_bytes_read; /* per stream, as returned by av_read_frame */
+    int64_t *stream_bytes_used; /* per stream, as queued to a decoder */
+    int nb_stream_bytes;
     int realtime;
 
     Clock audclk;
@@ -227,17 +801,38 @@ typedef struct VideoState
     struct SwrContext *swr_ctx;
     int frame_drops_early;
     int frame_drops_late;
-    int16_t sample_array[SAMPLE_ARRAY_SIZE];
-    int sample_array_index;
-    int last_i_start;
-    RDFTContext *rdft;
-    int rdft_bits;
-    FFTSample *rdft_data;
-    int xpos;
-    double last_vis_time;
-    SDL_Texture *vis_texture;
+    enum ShowMode show_mode; /* for audio without video */
+    AudioVis vis;
     SDL_Texture *sub_texture;
-    SDL_Texture *vid_texture;
+    SDL_Rect sub_dirty[SUB_DIRTY_MAX]; /* what sub_texture holds besides transparency */
+    TextRenderer *text; /* created on the first text subtitle */
+    GlyphAtlas atlas;
+    int nb_sub_dirty;
+    TextureSlot vid_slots[VIDEO_TEXTURE_POOL];
+    SoftOutput soft;
+    StatsOverlay overlay;
+    double rotation; /* clockwise, 0, 90, 180 or 270, applied at present time */
+    int rotation_hflip;
+    double zoom; /* 1 shows the whole picture */
+    double zoom_cx, zoom_cy; /* center of the view, fractions of the picture size */
+    SDL_Rect display_rect; /* where the picture was last drawn, maps the mouse to the picture */
+    int64_t upload_time; /* running average of one picture upload, microseconds */
+    int64_t upload_bytes, upload_bytes_reported, upload_report_time;
+    int nb_uploads_skipped, nb_uploads_partial;
+    int nb_uploads_idle, nb_uploads_late;
+    int64_t present_latency_total, present_latency_max; /* video_display start to present */
+    int64_t present_block_total, present_block_max;     /* inside SDL_RenderPresent, vsync waits included */
+    int64_t last_present;
+    double present_interval_mean, present_interval_m2; /* running mean and squared deviations, microseconds */
+    int nb_present_intervals;
+    int64_t input_latency_total, input_latency_max; /* key, button and wheel events, queued to handled */
+    int nb_input_events;
+    int nb_presented;
+
+    /* album art is decoded once, then requeued from here after every seek */
+    Frame attached_pic;
+    SDL_Texture *attached_pic_texture;
+    int attached_pic_uploaded;
 
     int subtitle_stream;
     AVStream *subtitle_st;
@@ -251,8 +846,10 @@ typedef struct VideoState
     PacketQueue videoq;
     double max_frame_duration; // maximum duration of a frame - above this, we consider the jump a timestamp discontinuity
     struct SwsContext *img_convert_ctx;
-    struct SwsContext *sub_convert_ctx;
     int eof;
+    int audio_past_play_range;
+    int video_past_play_range;
+    int play_range_done; /* every selected stream has passed the end of the play range */
 
     char *filename;
     int width, height, xleft, ytop;
@@ -287,23 +884,90 @@ static int exit_on_keydown;
 static int exit_on_mousedown;
 static int loop = 1;
 static int framedrop = -1;
+/* upload the next pictures while waiting for their deadline */
+static int preupload_frames = 1;
+/* hash pictures in bands, upload only the bands that changed */
+static int skip_unchanged_uploads = 1;
+/* ordered dithering when high bit depth video is reduced to 8 bit, plain rounding otherwise */
+static int reduce_depth_dither = 1;
+/* 4:2:2 and 4:4:4 chroma keeps every other row instead of averaging two, 8 bit 4:2:2 then needs no copy */
+static int chroma_decimate_fast = 0;
+/* map PQ and HLG video to SDR BT.709 on tonemap_threads workers, 0 for one per extra core */
+static int tonemap_hdr = 1;
+static int tonemap_threads = 0;
+/* with only the software renderer, scale and convert pictures on soft_output_threads, 0 for one per core */
+static int soft_output = 1;
+static int soft_output_threads = 0;
+/* time every render driver at startup and use the fastest, the choice is cached in ~/.ffplayer/renderer */
+static int renderer_auto_select = 0;
+/* render and present on a thread of their own so a blocking vsync present never delays input */
+static int render_thread = RENDER_THREAD_DEFAULT;
+/* on-screen A-V diff, queues, drops, decode and present times and a frame-time graph, toggled with i */
+static int stats_overlay = 0;
 static int infinite_buffer = -1;
 static const char *audio_codec_name = NULL;
 static const char *subtitle_codec_name = NULL;
 static const char *video_codec_name = NULL;
+/* audio without video: waves or spectrum, w cycles them and off; rdftspeed is seconds per spectrum column */
+static enum ShowMode show_mode = SHOW_MODE_RDFT;
 double rdftspeed = 0.02;
 static int64_t cursor_last_shown = 0;
 static int cursor_hidden = 0;
 static int autorotate = 1;
 static int find_stream_info = 1;
+static int mmap_io = 0;
+static int readahead_io = 0;
+/* I/O deadlines in microseconds, 0 disables */
+static int64_t io_open_timeout = 15000000;
+static int64_t io_probe_timeout = 15000000;
+static int64_t io_read_timeout = 5000000;
+static int64_t io_seek_timeout = 5000000;
+/* stalled reads in a row before the player quits, 0 keeps retrying: a live input may come back */
+static int io_max_retries = 0;
+/* how long stream_close waits for a read thread stuck in I/O */
+static int64_t shutdown_timeout = 3000000;
+/* remux what is played to this file, the format follows the extension */
+static const char *record_filename = NULL;
+/* spill live input to a disk backed ring so it can be paused and rewound */
+static int timeshift = 0;
+static int64_t timeshift_size = 512 * 1024 * 1024;
+static const char *timeshift_dir = NULL;
+/* audio or subtitle files demuxed in parallel with the main input */
+static const char *sidecar_filenames[MAX_SIDECARS];
+static int nb_sidecar_filenames = 0;
+/* input_filename followed by its backups */
+static const char *input_filenames[MAX_INPUTS];
+static int nb_input_filenames = 0;
+/* an input without packets for this long is replaced by the next one, in microseconds */
+static int64_t failover_timeout = 3000000;
+/* how often a backup checks whether the primary is back, in microseconds */
+static int64_t failback_interval = 10000000;
 
 /* current context */
 static int is_full_screen = 0;
+static SDL_Thread *render_tid; /* owns the renderer when rendering runs off the main thread */
+static SDL_threadID main_thread_id; /* the only thread SDL lets touch the window and the cursor */
+static Uint32 window_format;        /* SDL_GetWindowPixelFormat, refreshed on the main thread */
+static int render_quit;        /* a quit was requested on the render thread */
+static EventRing event_ring;
 static int64_t audio_callback_time = 0;
 
 static AVPacket flush_pkt;
 
 #define FF_QUIT_EVENT (SDL_USEREVENT + 2)
+/* the render thread has closed the stream, the main thread finishes the exit */
+#define FF_RENDER_DONE_EVENT (SDL_USEREVENT + 3)
+/* a window or cursor call the render thread leaves to the main thread, code is a WindowOp */
+#define FF_WINDOW_EVENT (SDL_USEREVENT + 4)
+/* the read thread has a new input ready and waits for the event thread to switch to it */
+#define FF_INPUT_SWITCH_EVENT (SDL_USEREVENT + 5)
+
+enum WindowOp
+{
+    WINDOW_OP_SHOW, /* title, size data1 x data2, centered, full screen if asked for, shown */
+    WINDOW_OP_FULLSCREEN,
+    WINDOW_OP_CURSOR, /* shown when data1 is set */
+};
 
 static SDL_Window *window;
 static SDL_Renderer *renderer;
@@ -560,6 +1224,19 @@ static void decoder_init(Decoder *d, AVCodecContext *avctx, PacketQueue *queue,
     d->empty_queue_cond = empty_queue_cond;
     d->start_pts = AV_NOPTS_VALUE;
     d->pkt_serial = -1;
+    d->accurate_seek_serial = -1;
+}
+
+/* return 1 if a decoded frame lies entirely before the target of an accurate seek */
+static int decoder_drop_before_accurate_seek(Decoder *d, double pts, double duration)
+{
+    return d->accurate_seek_serial == d->pkt_serial && !isnan(pts) && pts + duration <= d->accurate_seek_pts;
+}
+
+static void decoder_set_accurate_seek(Decoder *d, double pts)
+{
+    d->accurate_seek_pts = pts;
+    d->accurate_seek_serial = d->queue->serial;
 }
 
 // 参考：https://zhuanlan.zhihu.com/p/43948483
@@ -582,6 +1259,8 @@ static int decoder_decode_frame(Decoder *d, AVFrame *frame, AVSubtitle *sub)
                     return -1;
                 }
 
+                int64_t receive_start = av_gettime_relative();
+
                 switch (d->avctx->codec_type)
                 {
                 case AVMEDIA_TYPE_VIDEO:
@@ -627,6 +1306,8 @@ static int decoder_decode_frame(Decoder *d, AVFrame *frame, AVSubtitle *sub)
                     break;
                 }
 
+                d->decode_busy += av_gettime_relative() - receive_start;
+
                 if (ret == AVERROR_EOF)
                 {
                     d->finished = d->pkt_serial;
@@ -636,6 +1317,8 @@ static int decoder_decode_frame(Decoder *d, AVFrame *frame, AVSubtitle *sub)
 
                 if (ret >= 0)
                 {
+                    d->decode_time = d->decode_time ? (d->decode_time * 7 + d->decode_busy) / 8 : d->decode_busy;
+                    d->decode_busy = 0;
                     return 1;
                 }
 
@@ -701,7 +1384,11 @@ static int decoder_decode_frame(Decoder *d, AVFrame *frame, AVSubtitle *sub)
             else
             {
                 // 3. 将packet送入解码器
-                if (avcodec_send_packet(d->avctx, &pkt) == AVERROR(EAGAIN))
+                int64_t send_start = av_gettime_relative();
+                int err = avcodec_send_packet(d->avctx, &pkt);
+                d->decode_busy += av_gettime_relative() - send_start;
+
+                if (err == AVERROR(EAGAIN))
                 {
                     av_log(d->avctx, AV_LOG_ERROR, "Receive_frame and send_packet both returned EAGAIN, which is an API violation.\n");
                     d->packet_pending = 1;
@@ -723,10 +1410,21 @@ static void decoder_destroy(Decoder *d)
     avcodec_free_context(&d->avctx);
 }
 
+static void frame_sub_glyphs_unref(Frame *vp)
+{
+    for (int i = 0; i < vp->nb_sub_glyphs; i++)
+    {
+        av_buffer_unref(&vp->sub_glyphs[i].bitmap);
+    }
+
+    vp->nb_sub_glyphs = 0;
+}
+
 static void frame_queue_unref_item(Frame *vp)
 {
     av_frame_unref(vp->frame);
     avsubtitle_free(&vp->sub);
+    frame_sub_glyphs_unref(vp);
 }
 
 static int frame_queue_init(FrameQueue *f, PacketQueue *pktq, int max_size, int keep_last)
@@ -767,6 +1465,9 @@ static void frame_queue_destory(FrameQueue *f)
         Frame *vp = &f->queue[i];
         frame_queue_unref_item(vp);
         av_frame_free(&vp->frame);
+        av_freep(&vp->sub_pixels);
+        av_freep(&vp->sub_glyphs);
+        av_freep(&vp->band_hash);
     }
 
     SDL_DestroyMutex(f->mutex);
@@ -815,6 +1516,16 @@ static Frame *frame_queue_peek_writable(FrameQueue *f)
     return &f->queue[f->windex];
 }
 
+/* like frame_queue_peek_writable, but return NULL instead of waiting when the queue is full */
+static Frame *frame_queue_try_peek_writable(FrameQueue *f)
+{
+    SDL_LockMutex(f->mutex);
+    int room = f->size < f->max_size && !f->pktq->abort_request;
+    SDL_UnlockMutex(f->mutex);
+
+    return room ? &f->queue[f->windex] : NULL;
+}
+
 static Frame *frame_queue_peek_readable(FrameQueue *f)
 {
     /* wait until we have a readable a new frame */
@@ -1026,7 +1737,44 @@ static void get_sdl_pix_fmt_and_blendmode(int format, Uint32 *sdl_pix_fmt, SDL_B
     }
 }
 
-static int upload_texture(SDL_Texture **tex, AVFrame *frame, struct SwsContext **img_convert_ctx)
+/* update area of tex from the same area of frame, -1 when the format or a flipped frame needs a whole upload */
+static int upload_texture_rect(SDL_Texture *tex, AVFrame *frame, const SDL_Rect *area)
+{
+    Uint32 sdl_pix_fmt;
+    SDL_BlendMode sdl_blendmode;
+
+    get_sdl_pix_fmt_and_blendmode(frame->format, &sdl_pix_fmt, &sdl_blendmode);
+
+    switch (sdl_pix_fmt)
+    {
+    case SDL_PIXELFORMAT_UNKNOWN:
+        return -1;
+
+    case SDL_PIXELFORMAT_IYUV:
+        if (frame->linesize[0] <= 0 || frame->linesize[1] <= 0 || frame->linesize[2] <= 0)
+        {
+            return -1;
+        }
+
+        return SDL_UpdateYUVTexture(tex, area,
+                                    frame->data[0] + area->y * frame->linesize[0] + area->x, frame->linesize[0],
+                                    frame->data[1] + (area->y >> 1) * frame->linesize[1] + (area->x >> 1), frame->linesize[1],
+                                    frame->data[2] + (area->y >> 1) * frame->linesize[2] + (area->x >> 1), frame->linesize[2]);
+
+    default:
+        if (frame->linesize[0] <= 0)
+        {
+            return -1;
+        }
+
+        return SDL_UpdateTexture(tex, area,
+                                 frame->data[0] + area->y * frame->linesize[0] + av_image_get_linesize(frame->format, area->x, 0),
+                                 frame->linesize[0]);
+    }
+}
+
+/* area, NULL for the whole picture, limits what is converted and uploaded; its corners must be chroma aligned */
+static int upload_texture(SDL_Texture **tex, AVFrame *frame, struct SwsContext **img_convert_ctx, const SDL_Rect *area)
 {
     int ret = 0;
 
@@ -1045,17 +1793,29 @@ static int upload_texture(SDL_Texture **tex, AVFrame *frame, struct SwsContext *
         return -1;
     }
 
+    SDL_Rect whole = {0, 0, frame->width, frame->height};
+    if (!area)
+    {
+        area = &whole;
+    }
+
+    /* a zoomed view only needs its part of the picture */
+    if (sdl_pix_fmt != SDL_PIXELFORMAT_UNKNOWN && memcmp(area, &whole, sizeof(whole)) && upload_texture_rect(*tex, frame, area) >= 0)
+    {
+        return 0;
+    }
+
     switch (sdl_pix_fmt)
     {
     case SDL_PIXELFORMAT_UNKNOWN:
 
         /* This should only happen if we are not using avfilter... */
         *img_convert_ctx = sws_getCachedContext(*img_convert_ctx,
-                                                frame->width,
-                                                frame->height,
+                                                area->w,
+                                                area->h,
                                                 frame->format,
-                                                frame->width,
-                                                frame->height,
+                                                area->w,
+                                                area->h,
                                                 AV_PIX_FMT_BGRA,
                                                 sws_flags,
                                                 NULL,
@@ -1063,16 +1823,28 @@ static int upload_texture(SDL_Texture **tex, AVFrame *frame, struct SwsContext *
                                                 NULL);
         if (*img_convert_ctx != NULL)
         {
+            const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(frame->format);
+            const uint8_t *src[4] = {NULL};
             uint8_t *pixels[4];
             int pitch[4];
 
-            if (!SDL_LockTexture(*tex, NULL, (void **)pixels, pitch))
+            /* sws starts at the top left corner of the area, the palette stays as is */
+            for (int p = 0; p < 4 && frame->data[p]; p++)
+            {
+                int shift = (p == 1 || p == 2) ? desc->log2_chroma_h : 0;
+
+                src[p] = (p == 1 && (desc->flags & AV_PIX_FMT_FLAG_PAL))
+                             ? frame->data[p]
+                             : frame->data[p] + (area->y >> shift) * frame->linesize[p] + av_image_get_linesize(frame->format, area->x, p);
+            }
+
+            if (!SDL_LockTexture(*tex, area, (void **)pixels, pitch))
             {
                 sws_scale(*img_convert_ctx,
-                          (const uint8_t *const *)frame->data,
+                          src,
                           frame->linesize,
                           0,
-                          frame->height,
+                          area->h,
                           pixels,
                           pitch);
 
@@ -1135,971 +1907,6938 @@ static int upload_texture(SDL_Texture **tex, AVFrame *frame, struct SwsContext *
     return ret;
 }
 
-static Frame *subtitle_refresh_render(VideoState *is, Frame *vp)
+static int sub_font_index(uint32_t cp)
 {
-    Frame *sp = NULL;
+    if (cp >= 0x20 && cp < 0x7f)
+    {
+        return cp - 0x20;
+    }
 
-    if (frame_queue_nb_remaining(&is->subpq) > 0)
+    if (cp >= 0xa0 && cp <= 0xff)
     {
-        sp = frame_queue_peek(&is->subpq);
+        return cp - 0xa0 + 0x7f - 0x20;
+    }
 
-        if (vp->pts >= sp->pts + ((float)sp->sub.start_display_time / 1000))
+    return -1;
+}
+
+static void glyph_cache_clear(TextRenderer *tr)
+{
+    for (int i = 0; i < GLYPH_CACHE_SIZE; i++)
+    {
+        av_freep(&tr->glyphs[i].alpha);
+        av_buffer_unref(&tr->glyphs[i].bitmap);
+        tr->glyphs[i].size = 0;
+    }
+
+    tr->nb_glyphs = 0;
+}
+
+/* glyph scaled to a line height of size pixels, 4x4 supersampled from the built-in font */
+static GlyphCacheEntry *glyph_cache_get(TextRenderer *tr, int size, uint32_t cp)
+{
+    int idx = sub_font_index(cp);
+    if (idx < 0)
+    {
+        cp = '?';
+        idx = sub_font_index(cp);
+    }
+
+    unsigned int h = (cp * 2654435761u ^ size * 40503u) & (GLYPH_CACHE_SIZE - 1);
+    GlyphCacheEntry *e;
+
+    for (e = &tr->glyphs[h]; e->size; e = &tr->glyphs[h = (h + 1) & (GLYPH_CACHE_SIZE - 1)])
+    {
+        if (e->size == size && e->cp == cp)
         {
-            if (!sp->uploaded)
-            {
-                uint8_t *pixels[4];
-                int pitch[4];
+            tr->hits++;
+            return e;
+        }
+    }
 
-                if (!sp->width || !sp->height)
-                {
-                    sp->width = vp->width;
-                    sp->height = vp->height;
-                }
+    /* keep the table sparse, a new video size refills it quickly */
+    if (tr->nb_glyphs >= GLYPH_CACHE_SIZE * 3 / 4)
+    {
+        glyph_cache_clear(tr);
+        return glyph_cache_get(tr, size, cp);
+    }
 
-                if (realloc_texture(&is->sub_texture,
-                                    SDL_PIXELFORMAT_ARGB8888,
-                                    sp->width,
-                                    sp->height,
-                                    SDL_BLENDMODE_BLEND, 1) < 0)
-                {
-                    return NULL;
-                }
+    double s = size / (double)SUB_FONT_HEIGHT;
+    int x0 = floor(sub_font_glyphs[idx].xoff * s);
+    int y0 = floor(sub_font_glyphs[idx].top * s);
 
-                for (int i = 0; i < sp->sub.num_rects; i++)
-                {
-                    AVSubtitleRect *sub_rect = sp->sub.rects[i];
+    e->xoff = x0;
+    e->top = y0;
+    e->w = sub_font_glyphs[idx].w ? (int)ceil((sub_font_glyphs[idx].xoff + sub_font_glyphs[idx].w) * s) - x0 : 0;
+    e->h = sub_font_glyphs[idx].h ? (int)ceil((sub_font_glyphs[idx].top + sub_font_glyphs[idx].h) * s) - y0 : 0;
+    e->advance = lrint(sub_font_glyphs[idx].advance * s);
+
+    if (e->w && e->h)
+    {
+        const uint32_t *rows = sub_font_rows + sub_font_glyphs[idx].row;
+
+        if (!(e->alpha = av_malloc(e->w * e->h)))
+        {
+            return NULL;
+        }
+
+        for (int dy = 0; dy < e->h; dy++)
+        {
+            for (int dx = 0; dx < e->w; dx++)
+            {
+                int count = 0;
 
-                    sub_rect->x = av_clip(sub_rect->x, 0, sp->width);
-                    sub_rect->y = av_clip(sub_rect->y, 0, sp->height);
-                    sub_rect->w = av_clip(sub_rect->w, 0, sp->width - sub_rect->x);
-                    sub_rect->h = av_clip(sub_rect->h, 0, sp->height - sub_rect->y);
-
-                    is->sub_convert_ctx = sws_getCachedContext(is->sub_convert_ctx,
-                                                               sub_rect->w,
-                                                               sub_rect->h,
-                                                               AV_PIX_FMT_PAL8,
-                                                               sub_rect->w,
-                                                               sub_rect->h,
-                                                               AV_PIX_FMT_BGRA,
-                                                               0,
-                                                               NULL,
-                                                               NULL,
-                                                               NULL);
-
-                    if (!is->sub_convert_ctx)
+                for (int j = 0; j < 4; j++)
+                {
+                    double sy = (y0 + dy + (j + 0.5) / 4) / s - sub_font_glyphs[idx].top;
+                    if (sy < 0 || sy >= sub_font_glyphs[idx].h)
                     {
-                        av_log(NULL, AV_LOG_FATAL, "Cannot initialize the conversion context\n");
-                        return NULL;
+                        continue;
                     }
 
-                    if (!SDL_LockTexture(is->sub_texture, (SDL_Rect *)sub_rect, (void **)pixels, pitch))
+                    for (int i = 0; i < 4; i++)
                     {
-                        sws_scale(is->sub_convert_ctx,
-                                  (const uint8_t *const *)sub_rect->data,
-                                  sub_rect->linesize,
-                                  0,
-                                  sub_rect->h,
-                                  pixels,
-                                  pitch);
-
-                        SDL_UnlockTexture(is->sub_texture);
+                        double sx = (x0 + dx + (i + 0.5) / 4) / s - sub_font_glyphs[idx].xoff;
+
+                        count += sx >= 0 && sx < sub_font_glyphs[idx].w && (rows[(int)sy] >> (31 - (int)sx)) & 1;
                     }
                 }
 
-                sp->uploaded = 1;
+                e->alpha[dy * e->w + dx] = count * 255 / 16;
             }
         }
-        else
-        {
-            sp = NULL;
-        }
     }
 
-    return sp;
+    e->size = size;
+    e->cp = cp;
+    tr->nb_glyphs++;
+    tr->misses++;
+
+    return e;
 }
 
-static void video_image_display(VideoState *is)
+static void text_renderer_free(TextRenderer **ptr)
 {
-    Frame *vp, *sp;
-    SDL_Rect rect;
+    TextRenderer *tr = *ptr;
+    if (!tr)
+    {
+        return;
+    }
 
-    vp = frame_queue_peek_last(&is->pictq);
-    if (is->subtitle_st)
+    glyph_cache_clear(tr);
+    av_freep(&tr->fill);
+    av_freep(&tr->edge);
+    av_freep(ptr);
+}
+
+/* code points of the event text without override blocks, ASS alignment (numpad layout) from \an */
+static int text_sub_parse(const AVSubtitleRect *sub_rect, uint32_t *cps, int max, int *align)
+{
+    const uint8_t *p = (const uint8_t *)(sub_rect->ass ? sub_rect->ass : sub_rect->text);
+    int n = 0;
+
+    if (!p)
     {
-        sp = subtitle_refresh_render(is, vp);
+        return 0;
     }
 
-    calculate_display_rect(&rect, is->xleft, is->ytop, is->width, is->height, vp->width, vp->height, vp->sar);
+    /* ReadOrder,Layer,Style,Name,MarginL,MarginR,MarginV,Effect,Text */
+    if (sub_rect->ass)
+    {
+        const uint8_t *text = p;
+
+        for (int commas = 0; *text && commas < 8; text++)
+        {
+            commas += *text == ',';
+        }
+
+        if (*text || text > p)
+        {
+            p = text;
+        }
+    }
 
-    if (!vp->uploaded)
+    while (*p && n < max)
     {
-        if (upload_texture(&is->vid_texture, vp->frame, &is->img_convert_ctx) < 0)
+        if (*p == '{' && sub_rect->ass)
         {
-            return;
+            const uint8_t *end = (const uint8_t *)strchr((const char *)p, '}');
+            if (!end)
+            {
+                break;
+            }
+
+            for (const uint8_t *t = p; t + 3 < end; t++)
+            {
+                if (t[0] == '\\' && t[1] == 'a' && t[2] == 'n' && t[3] >= '1' && t[3] <= '9')
+                {
+                    *align = t[3] - '0';
+                }
+            }
+
+            p = end + 1;
+            continue;
+        }
+
+        if (*p == '\\' && (p[1] == 'N' || p[1] == 'n'))
+        {
+            cps[n++] = '\n';
+            p += 2;
+            continue;
+        }
+
+        if (*p == '\\' && p[1] == 'h')
+        {
+            cps[n++] = 0xa0;
+            p += 2;
+            continue;
+        }
+
+        if (*p == '\r')
+        {
+            p++;
+            continue;
         }
 
-        vp->uploaded = 1;
-        vp->flip_v = vp->frame->linesize[0] < 0;
+        uint32_t cp;
+        GET_UTF8(cp, *p++, cp = 0xfffd;)
+        cps[n++] = cp;
     }
 
-    SDL_RenderCopyEx(renderer, is->vid_texture, NULL, &rect, 0, NULL, vp->flip_v ? SDL_FLIP_VERTICAL : 0);
-    if (sp)
+    /* trailing line breaks would only add empty lines */
+    while (n && cps[n - 1] == '\n')
     {
-        SDL_RenderCopy(renderer, is->sub_texture, NULL, &rect);
+        n--;
     }
-}
 
-static inline int compute_mod(int a, int b)
-{
-    return a < 0 ? a % b + b : a % b;
+    return n;
 }
 
-static void stream_component_close(VideoState *is, int stream_index)
+/* break the text into lines no wider than max_w, at spaces when possible; returns the widest line */
+static int text_sub_layout(TextRenderer *tr, const uint32_t *cps, int n, int size, int max_w, TextLine *lines, int *nb_lines)
 {
-    AVFormatContext *ic = is->ic;
-    AVCodecParameters *codecpar;
-
-    if (stream_index < 0 || stream_index >= ic->nb_streams)
-    {
-        return;
-    }
+    int widest = 0;
+    int start = 0;
 
-    codecpar = ic->streams[stream_index]->codecpar;
+    *nb_lines = 0;
 
-    switch (codecpar->codec_type)
+    while (start <= n && *nb_lines < TEXT_SUB_MAX_LINES)
     {
-    case AVMEDIA_TYPE_AUDIO:
+        int width = 0, space = -1, space_width = 0;
+        int end = start;
 
-        decoder_abort(&is->auddec, &is->sampq);
+        for (; end < n && cps[end] != '\n'; end++)
+        {
+            const GlyphCacheEntry *g = glyph_cache_get(tr, size, cps[end]);
+            int advance = g ? g->advance : 0;
 
-        SDL_CloseAudioDevice(audio_dev);
+            if (width + advance > max_w && end > start)
+            {
+                if (space > start)
+                {
+                    end = space;
+                    width = space_width;
+                }
 
-        decoder_destroy(&is->auddec);
+                break;
+            }
 
-        swr_free(&is->swr_ctx);
-        av_freep(&is->audio_buf1);
+            if (cps[end] == ' ')
+            {
+                space = end;
+                space_width = width;
+            }
 
-        is->audio_buf1_size = 0;
-        is->audio_buf = NULL;
+            width += advance;
+        }
 
-        if (is->rdft)
+        lines[*nb_lines].start = start;
+        lines[*nb_lines].end = end;
+        lines[*nb_lines].width = width;
+        (*nb_lines)++;
+        widest = FFMAX(widest, width);
+
+        /* skip the break itself, a newline or the space that was wrapped at */
+        start = end < n && (cps[end] == '\n' || cps[end] == ' ') ? end + 1 : end;
+        if (end >= n)
         {
-            av_rdft_end(is->rdft);
-            av_freep(&is->rdft_data);
-            is->rdft = NULL;
-            is->rdft_bits = 0;
+            break;
         }
-        break;
+    }
 
-    case AVMEDIA_TYPE_VIDEO:
-        decoder_abort(&is->viddec, &is->pictq);
-        decoder_destroy(&is->viddec);
-        break;
+    return widest;
+}
 
-    case AVMEDIA_TYPE_SUBTITLE:
-        decoder_abort(&is->subdec, &is->subpq);
-        decoder_destroy(&is->subdec);
-        break;
+/* square dilation of the fill by radius r, separable, one shifted row at a time so the inner loops have no bounds */
+static void text_sub_outline(const uint8_t *restrict fill, uint8_t *restrict edge, uint8_t *restrict tmp, int w, int h, int r)
+{
+    for (int y = 0; y < h; y++)
+    {
+        const uint8_t *src = fill + y * w;
+        uint8_t *dst = tmp + y * w;
 
-    default:
-        break;
-    }
+        memcpy(dst, src, w);
 
-    ic->streams[stream_index]->discard = AVDISCARD_ALL;
+        for (int k = 1; k <= r && k < w; k++)
+        {
+            for (int x = 0; x < w - k; x++)
+            {
+                dst[x] = FFMAX(dst[x], src[x + k]);
+            }
 
-    switch (codecpar->codec_type)
+            for (int x = k; x < w; x++)
+            {
+                dst[x] = FFMAX(dst[x], src[x - k]);
+            }
+        }
+    }
+
+    for (int y = 0; y < h; y++)
     {
-    case AVMEDIA_TYPE_AUDIO:
-        is->audio_st = NULL;
-        is->audio_stream = -1;
-        break;
+        uint8_t *dst = edge + y * w;
 
-    case AVMEDIA_TYPE_VIDEO:
-        is->video_st = NULL;
-        is->video_stream = -1;
-        break;
+        memcpy(dst, tmp + y * w, w);
 
-    case AVMEDIA_TYPE_SUBTITLE:
-        is->subtitle_st = NULL;
-        is->subtitle_stream = -1;
-        break;
+        for (int k = FFMAX(y - r, 0); k <= FFMIN(y + r, h - 1); k++)
+        {
+            const uint8_t *src = tmp + k * w;
 
-    default:
-        break;
+            for (int x = 0; x < w; x++)
+            {
+                dst[x] = FFMAX(dst[x], src[x]);
+            }
+        }
     }
 }
 
-static void stream_close(VideoState *is)
+static int text_sub_border(int size)
 {
-    /* XXX: use a special url_shutdown call to abort parse cleanly */
-    is->abort_request = 1;
-    SDL_WaitThread(is->read_tid, NULL);
+    return FFMAX(size / 16, 1);
+}
 
-    /* close each stream */
-    if (is->audio_stream >= 0)
+/* coverage of the glyph followed by its outline, shared by the frames drawing the glyph until the cache drops it */
+static AVBufferRef *glyph_cache_bitmap(TextRenderer *tr, GlyphCacheEntry *g, int border)
+{
+    if (g->bitmap)
     {
-        stream_component_close(is, is->audio_stream);
+        return g->bitmap;
     }
 
-    if (is->video_stream >= 0)
+    int w = g->w + 2 * border, h = g->h + 2 * border;
+
+    av_fast_malloc(&tr->fill, &tr->fill_size, w * h);
+    av_fast_malloc(&tr->edge, &tr->edge_size, w * h);
+    if (!tr->fill || !tr->edge)
     {
-        stream_component_close(is, is->video_stream);
+        tr->fill_size = tr->edge_size = 0;
+        return NULL;
     }
 
-    if (is->subtitle_stream >= 0)
+    if (!(g->bitmap = av_buffer_alloc(g->w * g->h + w * h)))
     {
-        stream_component_close(is, is->subtitle_stream);
+        return NULL;
     }
 
-    avformat_close_input(&is->ic);
-
-    packet_queue_destroy(&is->videoq);
-    packet_queue_destroy(&is->audioq);
-    packet_queue_destroy(&is->subtitleq);
+    memset(tr->fill, 0, w * h);
 
-    /* free all pictures */
-    frame_queue_destory(&is->pictq);
-    frame_queue_destory(&is->sampq);
-    frame_queue_destory(&is->subpq);
+    for (int y = 0; y < g->h; y++)
+    {
+        memcpy(tr->fill + (y + border) * w + border, g->alpha + y * g->w, g->w);
+    }
 
-    SDL_DestroyCond(is->continue_read_thread);
+    memcpy(g->bitmap->data, g->alpha, g->w * g->h);
+    text_sub_outline(tr->fill, g->bitmap->data + g->w * g->h, tr->edge, w, h, border);
 
-    sws_freeContext(is->img_convert_ctx);
-    sws_freeContext(is->sub_convert_ctx);
+    return g->bitmap;
+}
 
-    av_free(is->filename);
+/* place the glyphs of the event on the canvas, each line aligned inside the box of the event; returns the glyph count */
+static int text_sub_place(TextRenderer *tr, const uint32_t *cps, const TextLine *lines, int nb_lines, int size, int align,
+                          int border, const AVSubtitleRect *sub_rect, SubGlyph *glyphs)
+{
+    int nb_glyphs = 0;
 
-    if (is->vis_texture)
+    for (int l = 0; l < nb_lines; l++)
     {
-        SDL_DestroyTexture(is->vis_texture);
-    }
+        int col = (align - 1) % 3;
+        int pen = border + (col == 0 ? 0 : col == 1 ? (sub_rect->w - 2 * border - lines[l].width) / 2 : sub_rect->w - 2 * border - lines[l].width);
+        int base = border + l * size;
 
-    if (is->vid_texture)
-    {
-        SDL_DestroyTexture(is->vid_texture);
-    }
+        for (int i = lines[l].start; i < lines[l].end; i++)
+        {
+            GlyphCacheEntry *g = glyph_cache_get(tr, size, cps[i]);
+            if (!g)
+            {
+                continue;
+            }
 
-    if (is->sub_texture)
-    {
-        SDL_DestroyTexture(is->sub_texture);
+            /* blank glyphs only move the pen */
+            AVBufferRef *bitmap = g->w && g->h ? glyph_cache_bitmap(tr, g, border) : NULL;
+            if (bitmap && (bitmap = av_buffer_ref(bitmap)))
+            {
+                glyphs[nb_glyphs++] = (SubGlyph){g->cp, size, sub_rect->x + pen, sub_rect->y + base, g->xoff, g->top, g->w, g->h, border, bitmap};
+            }
+
+            pen += g->advance;
+        }
     }
 
-    av_free(is);
+    return nb_glyphs;
 }
 
-static void do_exit(VideoState *is)
+/*
+ * Lay out the text/ASS rects of sp into sp->sub_glyphs, white text with a black outline stacked per
+ * ASS alignment; the render thread draws them from the glyph atlas. This is a fallback for builds
+ * without libass and has known gaps:
+ * - styles, \pos, \move, colors, fades, karaoke and every override tag other than \an are dropped
+ * - code points outside Latin-1 are drawn as '?'
+ * - a single built-in font, the atlas is keyed by line height and code point only
+ */
+static int subtitle_render_text(TextRenderer *tr, Frame *sp)
 {
-    if (is)
-    {
-        stream_close(is);
-    }
+    uint32_t cps[TEXT_SUB_MAX_CHARS];
+    TextLine lines[TEXT_SUB_MAX_LINES];
 
-    if (renderer)
-    {
-        SDL_DestroyRenderer(renderer);
-    }
+    int size = FFMAX(sp->height / 18, 12);
+    int border = text_sub_border(size);
+    int margin_h = sp->width / 20, margin_v = sp->height / 20;
+    int max_w = FFMAX(sp->width - 2 * margin_h - 2 * border, size);
+    int stack_top = 0, stack_bottom = 0;
+    size_t total = 0;
 
-    if (window)
+    /* geometry first, the glyphs of all rects go into one array */
+    for (unsigned i = 0; i < sp->sub.num_rects; i++)
     {
-        SDL_DestroyWindow(window);
+        AVSubtitleRect *sub_rect = sp->sub.rects[i];
+        int align = 2, nb_lines;
+
+        int n = text_sub_parse(sub_rect, cps, TEXT_SUB_MAX_CHARS, &align);
+        if (!n)
+        {
+            sub_rect->w = sub_rect->h = 0;
+            continue;
+        }
+
+        int width = text_sub_layout(tr, cps, n, size, max_w, lines, &nb_lines);
+        int w = width + 2 * border, h = nb_lines * size + 2 * border;
+        int col = (align - 1) % 3, row = (align - 1) / 3;
+
+        sub_rect->x = col == 0 ? margin_h : col == 1 ? (sp->width - w) / 2 : sp->width - margin_h - w;
+
+        if (row == 0)
+        {
+            sub_rect->y = sp->height - margin_v - stack_bottom - h;
+            stack_bottom += h;
+        }
+        else if (row == 2)
+        {
+            sub_rect->y = margin_v + stack_top;
+            stack_top += h;
+        }
+        else
+        {
+            sub_rect->y = (sp->height - h) / 2;
+        }
+
+        sub_rect->w = w;
+        sub_rect->h = h;
+        total += n;
     }
 
-    avformat_network_deinit();
+    frame_sub_glyphs_unref(sp);
 
-    if (show_status)
+    av_fast_malloc(&sp->sub_glyphs, &sp->sub_glyphs_size, FFMAX(total, 1) * sizeof(SubGlyph));
+    if (!sp->sub_glyphs)
     {
-        printf("\n");
+        sp->sub_glyphs_size = 0;
+        return AVERROR(ENOMEM);
     }
 
-    SDL_Quit();
+    for (unsigned i = 0; i < sp->sub.num_rects; i++)
+    {
+        AVSubtitleRect *sub_rect = sp->sub.rects[i];
+        int align = 2, nb_lines;
 
-    av_log(NULL, AV_LOG_QUIET, "%s", "");
+        if (!sub_rect->w || !sub_rect->h)
+        {
+            continue;
+        }
 
-    exit(0);
+        int n = text_sub_parse(sub_rect, cps, TEXT_SUB_MAX_CHARS, &align);
+        text_sub_layout(tr, cps, n, size, max_w, lines, &nb_lines);
+        sp->nb_sub_glyphs += text_sub_place(tr, cps, lines, nb_lines, size, align, border, sub_rect, sp->sub_glyphs + sp->nb_sub_glyphs);
+    }
+
+    return 0;
 }
 
-static void sigterm_handler(int sig)
+static void glyph_atlas_reset(GlyphAtlas *atlas)
 {
-    exit(123);
+    memset(atlas->entries, 0, sizeof(atlas->entries));
+    atlas->nb_entries = 0;
+    atlas->row_x = atlas->row_y = atlas->row_h = 0;
+    atlas->nb_resets++;
 }
 
-static void set_default_window_size(int width, int height, AVRational sar)
+static void glyph_atlas_free(GlyphAtlas *atlas)
 {
-    SDL_Rect rect;
+    if (atlas->nb_draws)
+    {
+        av_log(NULL, AV_LOG_VERBOSE, "glyph atlas: %d glyphs uploaded, %" PRId64 " KB, %d resets, %.3f ms per frame drawn\n",
+               atlas->nb_uploads, atlas->upload_bytes / 1024, atlas->nb_resets, atlas->draw_time / 1000.0 / atlas->nb_draws);
+    }
 
-    calculate_display_rect(&rect, 0, 0, INT_MAX, height, width, height, sar);
+    av_freep(&atlas->pixels);
+    atlas->pixels_size = 0;
 
-    default_width = rect.w;
-    default_height = rect.h;
+    if (atlas->texture)
+    {
+        SDL_DestroyTexture(atlas->texture);
+        atlas->texture = NULL;
+    }
 }
 
-static int video_open(VideoState *is)
+/* copy a w x h coverage map into the atlas as white with alpha, inside a transparent border of one pixel so filtering never picks up a neighbour */
+static int glyph_atlas_upload(GlyphAtlas *atlas, const uint8_t *alpha, int w, int h, SDL_Rect *rect)
 {
-    int w, h;
+    int pw = w + 2, ph = h + 2;
 
-    if (screen_width)
+    if (atlas->row_x + pw > atlas->size)
     {
-        w = screen_width;
-        h = screen_height;
+        atlas->row_x = 0;
+        atlas->row_y += atlas->row_h;
+        atlas->row_h = 0;
     }
-    else
+
+    if (pw > atlas->size || atlas->row_y + ph > atlas->size)
     {
-        w = default_width;
-        h = default_height;
+        return AVERROR(ENOSPC);
     }
 
-    if (!window_title)
+    av_fast_malloc(&atlas->pixels, &atlas->pixels_size, pw * ph * sizeof(*atlas->pixels));
+    if (!atlas->pixels)
     {
-        window_title = input_filename;
+        atlas->pixels_size = 0;
+        return AVERROR(ENOMEM);
     }
 
-    SDL_SetWindowTitle(window, window_title);
+    memset(atlas->pixels, 0, pw * ph * sizeof(*atlas->pixels));
+
+    for (int y = 0; y < h; y++)
+    {
+        uint32_t *dst = atlas->pixels + (y + 1) * pw + 1;
 
-    SDL_SetWindowSize(window, w, h);
-    SDL_SetWindowPosition(window, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED);
+        for (int x = 0; x < w; x++)
+        {
+            dst[x] = (uint32_t)alpha[y * w + x] << 24 | 0xffffff;
+        }
+    }
 
-    if (is_full_screen)
+    SDL_Rect r = {atlas->row_x, atlas->row_y, pw, ph};
+    if (SDL_UpdateTexture(atlas->texture, &r, atlas->pixels, pw * sizeof(*atlas->pixels)) < 0)
     {
-        SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN_DESKTOP);
+        return AVERROR_EXTERNAL;
     }
 
-    SDL_ShowWindow(window);
+    *rect = (SDL_Rect){r.x + 1, r.y + 1, w, h};
 
-    is->width = w;
-    is->height = h;
+    atlas->row_x += pw;
+    atlas->row_h = FFMAX(atlas->row_h, ph);
+    atlas->nb_uploads++;
+    atlas->upload_bytes += pw * ph * sizeof(*atlas->pixels);
 
     return 0;
 }
 
-/* display the current picture, if any */
-static void video_display(VideoState *is)
+/* the atlas entry of a glyph, uploaded from its bitmap on first use; NULL if it does not fit */
+static const GlyphAtlasEntry *glyph_atlas_get(GlyphAtlas *atlas, const SubGlyph *sg)
 {
-    if (!is->width)
-    {
-        video_open(is);
-    }
+    unsigned int h = (sg->cp * 2654435761u ^ sg->size * 40503u) & (GLYPH_CACHE_SIZE - 1);
+    GlyphAtlasEntry *e;
 
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-
-    if (is->video_st)
+    for (e = &atlas->entries[h]; e->size; e = &atlas->entries[h = (h + 1) & (GLYPH_CACHE_SIZE - 1)])
     {
-        video_image_display(is);
+        if (e->size == sg->size && e->cp == sg->cp)
+        {
+            return e;
+        }
     }
 
-    SDL_RenderPresent(renderer);
-}
+    int ret = AVERROR(ENOSPC);
 
-static double get_clock(Clock *c)
-{
-    if (*c->queue_serial != c->serial)
+    if (atlas->nb_entries < GLYPH_CACHE_SIZE * 3 / 4)
     {
-        return NAN;
+        ret = glyph_atlas_upload(atlas, sg->bitmap->data, sg->w, sg->h, &e->fill);
+        if (ret >= 0)
+        {
+            ret = glyph_atlas_upload(atlas, sg->bitmap->data + sg->w * sg->h, sg->w + 2 * sg->border, sg->h + 2 * sg->border, &e->edge);
+        }
     }
 
-    if (c->paused)
+    /*
+     * Out of room: start over. Draws already issued from the texture are flushed by SDL before it is
+     * updated, so only a subtitle needing more than the whole atlas in one frame keeps refilling it.
+     */
+    if (ret == AVERROR(ENOSPC) && atlas->nb_entries)
     {
-        return c->pts;
+        glyph_atlas_reset(atlas);
+        return glyph_atlas_get(atlas, sg);
     }
-    else
+
+    if (ret < 0)
     {
-        double time = av_gettime_relative() / 1000000.0;
-        return c->pts_drift + time - (time - c->last_updated) * (1.0 - c->speed);
+        return NULL;
     }
-}
 
-static void set_clock_at(Clock *c, double pts, int serial, double time)
-{
-    c->pts = pts;
-    c->last_updated = time;
-    c->pts_drift = c->pts - time;
-    c->serial = serial;
-}
+    e->size = sg->size;
+    e->cp = sg->cp;
+    atlas->nb_entries++;
 
-static void set_clock(Clock *c, double pts, int serial)
-{
-    double time = av_gettime_relative() / 1000000.0;
-    set_clock_at(c, pts, serial, time);
+    return e;
 }
 
-static void set_clock_speed(Clock *c, double speed)
+/* canvas coordinates of a text subtitle to the window */
+static SDL_Rect subtitle_canvas_to_window(const Frame *sp, const SDL_Rect *rect, int x, int y, int w, int h)
 {
-    set_clock(c, get_clock(c), c->serial);
-    c->speed = speed;
+    int x0 = rect->x + (int64_t)x * rect->w / sp->width;
+    int y0 = rect->y + (int64_t)y * rect->h / sp->height;
+    int x1 = rect->x + (int64_t)(x + w) * rect->w / sp->width;
+    int y1 = rect->y + (int64_t)(y + h) * rect->h / sp->height;
+
+    return (SDL_Rect){x0, y0, x1 - x0, y1 - y0};
 }
 
-static void init_clock(Clock *c, int *queue_serial)
+/* the outlines of all glyphs in black, then the glyphs in white on top, all copied from the atlas */
+static void subtitle_draw_text(VideoState *is, Frame *sp, const SDL_Rect *rect)
 {
-    c->speed = 1.0;
-    c->paused = 0;
-    c->queue_serial = queue_serial;
+    GlyphAtlas *atlas = &is->atlas;
+    int64_t start = av_gettime_relative();
 
-    set_clock(c, NAN, -1);
-}
+    if (!atlas->texture)
+    {
+        atlas->size = GLYPH_ATLAS_SIZE;
+        if (renderer_info.max_texture_width > 0 && renderer_info.max_texture_height > 0)
+        {
+            atlas->size = FFMIN(atlas->size, FFMIN(renderer_info.max_texture_width, renderer_info.max_texture_height));
+        }
 
-static void sync_clock_to_slave(Clock *c, Clock *slave)
-{
-    double clock = get_clock(c);
-    double slave_clock = get_clock(slave);
+        if (realloc_texture(&atlas->texture, SDL_PIXELFORMAT_ARGB8888, atlas->size, atlas->size, SDL_BLENDMODE_BLEND, 0) < 0)
+        {
+            return;
+        }
+    }
 
-    if (!isnan(slave_clock) && (isnan(clock) || fabs(clock - slave_clock) > AV_NOSYNC_THRESHOLD))
+    for (int pass = 0; pass < 2; pass++)
     {
-        set_clock(c, slave_clock, slave->serial);
+        Uint8 c = pass ? 255 : 0;
+        SDL_SetTextureColorMod(atlas->texture, c, c, c);
+
+        for (int i = 0; i < sp->nb_sub_glyphs; i++)
+        {
+            const SubGlyph *sg = &sp->sub_glyphs[i];
+
+            const GlyphAtlasEntry *e = glyph_atlas_get(atlas, sg);
+            if (!e)
+            {
+                continue;
+            }
+
+            const SDL_Rect *src = pass ? &e->fill : &e->edge;
+            int b = pass ? 0 : sg->border;
+            SDL_Rect dst = subtitle_canvas_to_window(sp, rect, sg->x + sg->xoff - b, sg->y + sg->top - b, src->w, src->h);
+
+            SDL_RenderCopy(renderer, atlas->texture, src, &dst);
+        }
     }
+
+    atlas->draw_time += av_gettime_relative() - start;
+    atlas->nb_draws++;
 }
 
-static int get_master_sync_type(VideoState *is)
+static int sub_rect_contains(const SDL_Rect *outer, const SDL_Rect *inner)
 {
-    if (is->av_sync_type == AV_SYNC_VIDEO_MASTER)
+    return inner->x >= outer->x && inner->y >= outer->y &&
+           inner->x + inner->w <= outer->x + outer->w && inner->y + inner->h <= outer->y + outer->h;
+}
+
+/* clear what the previous subtitle left on the texture, except where the new rects overwrite it anyway */
+static void subtitle_clear_dirty(VideoState *is, Frame *sp, int tex_w, int tex_h)
+{
+    for (int i = 0; i < is->nb_sub_dirty; i++)
     {
-        if (is->video_st)
+        SDL_Rect r = is->sub_dirty[i];
+        int covered = 0;
+
+        for (unsigned j = 0; j < sp->sub.num_rects && !covered; j++)
         {
-            return AV_SYNC_VIDEO_MASTER;
+            AVSubtitleRect *sub_rect = sp->sub.rects[j];
+            SDL_Rect n = {sub_rect->x, sub_rect->y, sub_rect->w, sub_rect->h};
+
+            covered = sub_rect_contains(&n, &r);
         }
 
-        return AV_SYNC_AUDIO_MASTER;
-    }
-    else if (is->av_sync_type == AV_SYNC_AUDIO_MASTER)
-    {
-        if (is->audio_st)
+        r.w = FFMIN(r.w, tex_w - r.x);
+        r.h = FFMIN(r.h, tex_h - r.y);
+
+        if (covered || r.w <= 0 || r.h <= 0)
         {
-            return AV_SYNC_AUDIO_MASTER;
+            continue;
         }
 
-        return AV_SYNC_EXTERNAL_CLOCK;
-    }
-    else
-    {
-        return AV_SYNC_EXTERNAL_CLOCK;
-    }
-}
-
-/* get the current master clock value */
-static double get_master_clock(VideoState *is)
-{
-    double val;
-
-    switch (get_master_sync_type(is))
-    {
-    case AV_SYNC_VIDEO_MASTER:
-        val = get_clock(&is->vidclk);
-        break;
+        uint8_t *pixels;
+        int pitch;
 
-    case AV_SYNC_AUDIO_MASTER:
-        val = get_clock(&is->audclk);
-        break;
+        if (!SDL_LockTexture(is->sub_texture, &r, (void **)&pixels, &pitch))
+        {
+            for (int j = 0; j < r.h; j++, pixels += pitch)
+            {
+                memset(pixels, 0, r.w << 2);
+            }
 
-    default:
-        val = get_clock(&is->extclk);
-        break;
+            SDL_UnlockTexture(is->sub_texture);
+        }
     }
 
-    return val;
+    is->nb_sub_dirty = 0;
 }
 
-static void check_external_clock_speed(VideoState *is)
+static void subtitle_mark_dirty(VideoState *is, const SDL_Rect *r)
 {
-    if (is->video_stream >= 0 && is->videoq.nb_packets <= EXTERNAL_CLOCK_MIN_FRAMES ||
-        is->audio_stream >= 0 && is->audioq.nb_packets <= EXTERNAL_CLOCK_MIN_FRAMES)
-    {
-        set_clock_speed(&is->extclk, FFMAX(EXTERNAL_CLOCK_SPEED_MIN, is->extclk.speed - EXTERNAL_CLOCK_SPEED_STEP));
-    }
-    else if ((is->video_stream < 0 || is->videoq.nb_packets > EXTERNAL_CLOCK_MAX_FRAMES) &&
-             (is->audio_stream < 0 || is->audioq.nb_packets > EXTERNAL_CLOCK_MAX_FRAMES))
-    {
-        set_clock_speed(&is->extclk, FFMIN(EXTERNAL_CLOCK_SPEED_MAX, is->extclk.speed + EXTERNAL_CLOCK_SPEED_STEP));
-    }
-    else
+    if (is->nb_sub_dirty < SUB_DIRTY_MAX)
     {
-        double speed = is->extclk.speed;
-        if (speed != 1.0)
-        {
-            set_clock_speed(&is->extclk, speed + EXTERNAL_CLOCK_SPEED_STEP * (1.0 - speed) / fabs(1.0 - speed));
-        }
+        is->sub_dirty[is->nb_sub_dirty++] = *r;
+        return;
     }
+
+    /* too many rects, grow the last one into their bounding box */
+    SDL_Rect *last = &is->sub_dirty[SUB_DIRTY_MAX - 1];
+    SDL_UnionRect(last, r, last);
 }
 
-/* seek in the stream */
-static void stream_seek(VideoState *is, int64_t pos, int64_t rel, int seek_by_bytes)
+/* the rects were rasterized by subtitle_thread, only copy them into the texture */
+static Frame *subtitle_refresh_render(VideoState *is, Frame *vp)
 {
-    if (!is->seek_req)
+    Frame *sp = NULL;
+
+    if (frame_queue_nb_remaining(&is->subpq) > 0)
     {
-        is->seek_pos = pos;
-        is->seek_rel = rel;
-        is->seek_flags &= ~AVSEEK_FLAG_BYTE;
+        sp = frame_queue_peek(&is->subpq);
 
-        if (seek_by_bytes)
+        if (vp->pts >= sp->pts + ((float)sp->sub.start_display_time / 1000))
         {
-            is->seek_flags |= AVSEEK_FLAG_BYTE;
-        }
+            /* text subtitles are drawn glyph by glyph from the atlas, they have nothing to upload */
+            if (!sp->uploaded && sp->sub.format == 0)
+            {
+                if (!sp->width || !sp->height)
+                {
+                    sp->width = vp->width;
+                    sp->height = vp->height;
+                }
 
-        is->seek_req = 1;
+                SDL_Texture *old_texture = is->sub_texture;
 
-        SDL_CondSignal(is->continue_read_thread);
-    }
-}
+                if (realloc_texture(&is->sub_texture,
+                                    SDL_PIXELFORMAT_ARGB8888,
+                                    sp->width,
+                                    sp->height,
+                                    SDL_BLENDMODE_BLEND, 1) < 0)
+                {
+                    return NULL;
+                }
 
-/* pause or resume the video */
-static void stream_toggle_pause(VideoState *is)
-{
-    if (is->paused)
-    {
-        is->frame_timer += av_gettime_relative() / 1000000.0 - is->vidclk.last_updated;
-        if (is->read_pause_return != AVERROR(ENOSYS))
+                /* a new texture starts out transparent */
+                if (is->sub_texture != old_texture)
+                {
+                    is->nb_sub_dirty = 0;
+                }
+
+                subtitle_clear_dirty(is, sp, sp->width, sp->height);
+
+                const uint8_t *src = sp->sub_pixels;
+
+                for (int i = 0; i < sp->sub.num_rects; i++)
+                {
+                    AVSubtitleRect *sub_rect = sp->sub.rects[i];
+                    SDL_Rect r = {sub_rect->x, sub_rect->y, FFMIN(sub_rect->w, sp->width - sub_rect->x), FFMIN(sub_rect->h, sp->height - sub_rect->y)};
+
+                    if (r.w > 0 && r.h > 0)
+                    {
+                        SDL_UpdateTexture(is->sub_texture, &r, src, sub_rect->w << 2);
+                        subtitle_mark_dirty(is, &r);
+                    }
+
+                    src += (size_t)sub_rect->w * sub_rect->h * 4;
+                }
+
+                sp->uploaded = 1;
+            }
+        }
+        else
         {
-            is->vidclk.paused = 0;
+            sp = NULL;
         }
-
-        set_clock(&is->vidclk, get_clock(&is->vidclk), is->vidclk.serial);
     }
 
-    set_clock(&is->extclk, get_clock(&is->extclk), is->extclk.serial);
-    is->paused = is->audclk.paused = is->vidclk.paused = is->extclk.paused = !is->paused;
+    return sp;
 }
 
-static void toggle_pause(VideoState *is)
+static int frame_same_content(const Frame *a, const Frame *b)
 {
-    stream_toggle_pause(is);
-    is->step = 0;
+    return a->nb_bands && a->nb_bands == b->nb_bands &&
+           a->width == b->width && a->height == b->height && a->format == b->format &&
+           !memcmp(a->band_hash, b->band_hash, a->nb_bands * sizeof(*a->band_hash));
 }
 
-static void toggle_mute(VideoState *is)
+/* part of the picture in view at the current zoom */
+static void video_zoom_view(VideoState *is, const Frame *vp, SDL_Rect *view)
 {
-    is->muted = !is->muted;
+    if (is->zoom <= 1.0)
+    {
+        *view = (SDL_Rect){0, 0, vp->width, vp->height};
+        return;
+    }
+
+    view->w = FFMAX(lrint(vp->width / is->zoom), 1);
+    view->h = FFMAX(lrint(vp->height / is->zoom), 1);
+    view->x = av_clip(lrint(is->zoom_cx * vp->width - view->w / 2.0), 0, vp->width - view->w);
+    view->y = av_clip(lrint(is->zoom_cy * vp->height - view->h / 2.0), 0, vp->height - view->h);
 }
 
-static void update_volume(VideoState *is, int sign, double step)
+/* the view grown to chroma and bitstream alignment, what gets converted and uploaded */
+static void video_zoom_area(VideoState *is, const Frame *vp, SDL_Rect *area)
 {
-    double volume_level = is->audio_volume ? (20 * log(is->audio_volume / (double)SDL_MIX_MAXVOLUME) / log(10)) : -1000.0;
-    int new_volume = lrint(SDL_MIX_MAXVOLUME * pow(10.0, (volume_level + sign * step) / 20.0));
-    is->audio_volume = av_clip(is->audio_volume == new_volume ? (is->audio_volume + sign) : new_volume, 0, SDL_MIX_MAXVOLUME);
+    SDL_Rect view;
+    video_zoom_view(is, vp, &view);
+
+    area->x = view.x & ~7;
+    area->y = view.y & ~3;
+    area->w = FFMIN(FFALIGN(view.x + view.w, 8), vp->width) - area->x;
+    area->h = FFMIN(FFALIGN(view.y + view.h, 4), vp->height) - area->y;
 }
 
-static void step_to_next_frame(VideoState *is)
+static int rect_equal(const SDL_Rect *a, const SDL_Rect *b)
 {
-    /* if the stream is paused unpause it, then step */
-    if (is->paused)
-    {
-        stream_toggle_pause(is);
-    }
-
-    is->step = 1;
+    return a->x == b->x && a->y == b->y && a->w == b->w && a->h == b->h;
 }
 
-static double compute_target_delay(double delay, VideoState *is)
+/* bring the area of the slot texture to the content of vp, uploading only the bands whose hash differs */
+static int texture_slot_upload(VideoState *is, TextureSlot *ts, Frame *vp, const SDL_Rect *area)
 {
-    double sync_threshold, diff = 0;
+    int partial = ts->tex && vp->nb_bands && ts->nb_bands == vp->nb_bands &&
+                  ts->width == vp->width && ts->height == vp->height && ts->format == vp->format &&
+                  rect_equal(&ts->area, area);
+    int64_t bytes = 0;
+    int bands = 0;
 
-    /* update delay to follow master synchronisation source */
-    if (get_master_sync_type(is) != AV_SYNC_VIDEO_MASTER)
+    for (int b = 0; partial && b < vp->nb_bands;)
     {
-        /* if video is slave, we try to correct big delays by
-           duplicating or deleting a frame */
-        diff = get_clock(&is->vidclk) - get_master_clock(is);
+        if (ts->band_hash[b] == vp->band_hash[b])
+        {
+            b++;
+            continue;
+        }
 
-        /* skip or repeat frame. We take into account the
-           delay to compute the threshold. I still don't know
-           if it is the best guess */
-        sync_threshold = FFMAX(AV_SYNC_THRESHOLD_MIN, FFMIN(AV_SYNC_THRESHOLD_MAX, delay));
+        /* consecutive dirty bands go in one update */
+        int e = b + 1;
+        while (e < vp->nb_bands && ts->band_hash[e] != vp->band_hash[e])
+        {
+            e++;
+        }
 
-        if (!isnan(diff) && fabs(diff) < is->max_frame_duration)
+        SDL_Rect r = {area->x, FFMAX(b * UPLOAD_BAND_HEIGHT, area->y), area->w, 0};
+        r.h = FFMIN(FFMIN(e * UPLOAD_BAND_HEIGHT, vp->height), area->y + area->h) - r.y;
+
+        /* bands out of view change nothing visible */
+        if (r.h > 0)
         {
-            if (diff <= -sync_threshold)
-            {
-                delay = FFMAX(0, delay + diff);
-            }
-            else if (diff >= sync_threshold && delay > AV_SYNC_FRAMEDUP_THRESHOLD)
-            {
-                delay = delay + diff;
-            }
-            else if (diff >= sync_threshold)
+            if (upload_texture_rect(ts->tex, vp->frame, &r) < 0)
             {
-                delay = 2 * delay;
+                partial = 0;
+                break;
             }
-        }
-    }
 
-    av_log(NULL, AV_LOG_TRACE, "video: delay=%0.3f A-V=%f\n", delay, -diff);
+            bytes += av_image_get_buffer_size(vp->format, r.w, r.h, 1);
+            bands += e - b;
+        }
 
-    return delay;
-}
+        b = e;
+    }
 
-static double vp_duration(VideoState *is, Frame *vp, Frame *nextvp)
-{
-    if (vp->serial == nextvp->serial)
+    if (partial)
     {
-        double duration = nextvp->pts - vp->pts;
-        if (isnan(duration) || duration <= 0 || duration > is->max_frame_duration)
+        if (bands)
         {
-            return vp->duration;
+            is->nb_uploads_partial++;
+        }
+        else
+        {
+            is->nb_uploads_skipped++;
         }
-
-        return duration;
     }
     else
     {
-        return 0.0;
+        ts->nb_bands = 0;
+
+        if (upload_texture(&ts->tex, vp->frame, &is->img_convert_ctx, area) < 0)
+        {
+            return -1;
+        }
+
+        bytes = av_image_get_buffer_size(vp->format, area->w, area->h, 1);
     }
-}
 
-static void update_video_pts(VideoState *is, double pts, int64_t pos, int serial)
-{
-    /* update current video pts */
-    set_clock(&is->vidclk, pts, serial);
-    sync_clock_to_slave(&is->extclk, &is->vidclk);
-}
+    is->upload_bytes += FFMAX(bytes, 0);
 
-static void show_status_in_video_refresh(VideoState *is)
-{
-    static int64_t last_time;
-    int64_t cur_time;
-    int aqsize, vqsize, sqsize;
-    double av_diff;
-    cur_time = av_gettime_relative();
+    ts->area = *area;
+    ts->width = vp->width;
+    ts->height = vp->height;
+    ts->format = vp->format;
+    ts->nb_bands = 0;
 
-    if (!last_time || (cur_time - last_time) >= 30000)
+    if (vp->nb_bands)
     {
-        aqsize = vqsize = sqsize = 0;
-
-        if (is->audio_st)
+        av_fast_malloc(&ts->band_hash, &ts->band_hash_size, vp->nb_bands * sizeof(*ts->band_hash));
+        if (ts->band_hash)
         {
-            aqsize = is->audioq.size;
+            memcpy(ts->band_hash, vp->band_hash, vp->nb_bands * sizeof(*ts->band_hash));
+            ts->nb_bands = vp->nb_bands;
         }
-
-        if (is->video_st)
+        else
         {
-            vqsize = is->videoq.size;
+            ts->band_hash_size = 0;
         }
+    }
 
-        if (is->subtitle_st)
+    return 0;
+}
+
+/* upload vp to a texture of the pool that no other queued picture holds, album art keeps its own texture */
+static int video_upload_frame(VideoState *is, Frame *vp)
+{
+    if (vp->attached)
+    {
+        /* the album art texture already holds the picture after the first upload */
+        if (!is->attached_pic_uploaded)
         {
-            sqsize = is->subtitleq.size;
+            if (upload_texture(&is->attached_pic_texture, vp->frame, &is->img_convert_ctx, NULL) < 0)
+            {
+                return -1;
+            }
+
+            is->attached_pic_uploaded = 1;
         }
+    }
+    else
+    {
+        int64_t start = av_gettime_relative();
+        int busy = 0, slot;
+        SDL_Rect area;
 
-        av_diff = 0;
+        video_zoom_area(is, vp, &area);
 
-        if (is->audio_st && is->video_st)
+        /* the frames from rindex on are the shown one and those still to show */
+        for (int i = 0; i < is->pictq.size; i++)
         {
-            av_diff = get_clock(&is->audclk) - get_clock(&is->vidclk);
+            Frame *f = &is->pictq.queue[(is->pictq.rindex + i) % is->pictq.max_size];
+
+            if (f != vp && f->uploaded && !f->attached)
+            {
+                /* a queued picture with the same content lends its texture */
+                if (frame_same_content(f, vp) && rect_equal(&is->vid_slots[f->tex_index].area, &area))
+                {
+                    vp->tex_index = f->tex_index;
+                    vp->uploaded = 1;
+                    vp->flip_v = f->flip_v;
+                    is->nb_uploads_skipped++;
+                    return 0;
+                }
+
+                busy |= 1 << f->tex_index;
+            }
         }
-        else if (is->video_st)
+
+        for (slot = 0; slot < VIDEO_TEXTURE_POOL && (busy & (1 << slot)); slot++)
         {
-            av_diff = get_master_clock(is) - get_clock(&is->vidclk);
         }
-        else if (is->audio_st)
+
+        if (slot == VIDEO_TEXTURE_POOL)
         {
-            av_diff = get_master_clock(is) - get_clock(&is->audclk);
+            return AVERROR(EAGAIN);
         }
 
-        av_log(NULL, AV_LOG_INFO,
-               "%7.2f %s:%7.3f fd=%4d aq=%5dKB vq=%5dKB sq=%5dB f=%" PRId64 "/%" PRId64 "   \r",
-               get_master_clock(is),
-               (is->audio_st && is->video_st) ? "A-V" : (is->video_st ? "M-V" : (is->audio_st ? "M-A" : "   ")),
-               av_diff,
-               is->frame_drops_early + is->frame_drops_late,
-               aqsize / 1024,
-               vqsize / 1024,
-               sqsize,
-               is->video_st ? is->viddec.avctx->pts_correction_num_faulty_dts : 0,
-               is->video_st ? is->viddec.avctx->pts_correction_num_faulty_pts : 0);
+        if (texture_slot_upload(is, &is->vid_slots[slot], vp, &area) < 0)
+        {
+            return -1;
+        }
 
-        fflush(stdout);
+        vp->tex_index = slot;
+        is->attached_pic_uploaded = 0;
 
-        last_time = cur_time;
+        int64_t elapsed = av_gettime_relative() - start;
+        is->upload_time = is->upload_time ? (is->upload_time * 7 + elapsed) / 8 : elapsed;
     }
+
+    vp->uploaded = 1;
+    vp->flip_v = vp->frame->linesize[0] < 0;
+
+    return 0;
 }
 
-static void subtitle_refresh_hide_or_skip(VideoState *is)
+/* the software renderer does YUV conversion and scaling in plain C, the player does them instead */
+static int soft_output_enabled(void)
 {
-    Frame *sp, *sp2;
+    return soft_output && (renderer_info.flags & SDL_RENDERER_SOFTWARE);
+}
 
-    while (frame_queue_nb_remaining(&is->subpq) > 0)
+/* upload the pictures due next while there is time left before the deadline of the first */
+static void video_preupload(VideoState *is, double remaining_time)
+{
+    if (!preupload_frames || !is->video_st || is->paused || soft_output_enabled())
     {
-        sp = frame_queue_peek(&is->subpq);
-        if (frame_queue_nb_remaining(&is->subpq) > 1)
+        return;
+    }
+
+    for (int i = 0; i < VIDEO_TEXTURE_POOL - 1 && i < frame_queue_nb_remaining(&is->pictq); i++)
+    {
+        Frame *vp = i ? frame_queue_peek_next(&is->pictq) : frame_queue_peek(&is->pictq);
+
+        /* an upload that would not fit before the deadline is left to video_display */
+        if (remaining_time * 1000000 < is->upload_time)
         {
-            sp2 = frame_queue_peek_next(&is->subpq);
+            return;
         }
-        else
+
+        if (vp->uploaded || vp->attached || vp->serial != is->videoq.serial)
         {
-            sp2 = NULL;
+            continue;
         }
 
-        if (sp->serial != is->subtitleq.serial ||
-            (is->vidclk.pts > (sp->pts + ((float)sp->sub.end_display_time / 1000))) ||
-            (sp2 && is->vidclk.pts > (sp2->pts + ((float)sp2->sub.start_display_time / 1000))))
+        int64_t start = av_gettime_relative();
+
+        if (video_upload_frame(is, vp) < 0)
         {
-            if (sp->uploaded)
-            {
-                for (int i = 0; i < sp->sub.num_rects; i++)
-                {
-                    AVSubtitleRect *sub_rect = sp->sub.rects[i];
+            return;
+        }
 
-                    uint8_t *pixels;
-                    int pitch;
+        is->nb_uploads_idle++;
+        remaining_time -= (av_gettime_relative() - start) / 1000000.0;
+    }
+}
 
-                    if (!SDL_LockTexture(is->sub_texture, (SDL_Rect *)sub_rect, (void **)&pixels, &pitch))
-                    {
-                        for (int j = 0; j < sub_rect->h; j++, pixels += pitch)
-                        {
-                            memset(pixels, 0, sub_rect->w << 2);
-                        }
+/* the window pixel format and its FFmpeg name, so the renderer copies the scaled picture without converting it */
+static void soft_output_format(Uint32 *sdl_pix_fmt, enum AVPixelFormat *pix_fmt)
+{
+    Uint32 window_fmt = window_format;
 
-                        SDL_UnlockTexture(is->sub_texture);
-                    }
-                }
-            }
+    *sdl_pix_fmt = SDL_PIXELFORMAT_ARGB8888;
+    *pix_fmt = AV_PIX_FMT_BGRA;
 
-            frame_queue_next(&is->subpq);
-        }
-        else
+    for (size_t i = 0; i < FF_ARRAY_ELEMS(sdl_texture_format_map) - 1; i++)
+    {
+        if (window_fmt == (Uint32)sdl_texture_format_map[i].texture_fmt)
         {
-            break;
+            *sdl_pix_fmt = window_fmt;
+            *pix_fmt = sdl_texture_format_map[i].format;
+            return;
         }
     }
 }
 
-/* called to display each frame */
-// 参考：https://zhuanlan.zhihu.com/p/44122324
-static void video_refresh(void *opaque, double *remaining_time)
+/* the pixels belong to the locked texture, the buffer only lends them to sws_scale_frame */
+static void soft_output_buffer_free(void *opaque, uint8_t *data)
 {
-    VideoState *is = opaque;
+    (void)opaque;
+    (void)data;
+}
 
-    if (!is->paused && get_master_sync_type(is) == AV_SYNC_EXTERNAL_CLOCK && is->realtime)
+/* scale the view of vp to rect in the window format on the sws slice threads and copy it 1:1 */
+static int soft_output_display(VideoState *is, Frame *vp, const SDL_Rect *rect)
+{
+    SoftOutput *so = &is->soft;
+    int64_t start = av_gettime_relative();
+    Uint32 sdl_pix_fmt;
+    enum AVPixelFormat pix_fmt;
+    SDL_Rect view;
+    void *pixels;
+    int pitch;
+    int ret;
+
+    soft_output_format(&sdl_pix_fmt, &pix_fmt);
+
+    if (realloc_texture(&so->texture, sdl_pix_fmt, rect->w, rect->h, SDL_BLENDMODE_NONE, 0) < 0)
     {
-        check_external_clock_speed(is);
+        return -1;
     }
 
-    if (is->video_st)
+    if ((!so->src && !(so->src = av_frame_alloc())) || (!so->dst && !(so->dst = av_frame_alloc())))
     {
-    retry:
-        if (frame_queue_nb_remaining(&is->pictq) == 0)
+        return -1;
+    }
+
+    /* a zoomed view is cropped, chroma alignment may widen it slightly */
+    video_zoom_view(is, vp, &view);
+    if ((ret = av_frame_ref(so->src, vp->frame)) < 0)
+    {
+        return ret;
+    }
+
+    so->src->crop_left = view.x;
+    so->src->crop_top = view.y;
+    so->src->crop_right = vp->width - view.x - view.w;
+    so->src->crop_bottom = vp->height - view.y - view.h;
+    if ((ret = av_frame_apply_cropping(so->src, AV_FRAME_CROP_UNALIGNED)) < 0)
+    {
+        av_frame_unref(so->src);
+        return ret;
+    }
+
+    if (!so->sws || so->src_w != so->src->width || so->src_h != so->src->height || so->src_format != so->src->format ||
+        so->dst_w != rect->w || so->dst_h != rect->h || so->dst_format != pix_fmt)
+    {
+        sws_freeContext(so->sws);
+
+        so->nb_threads = soft_output_threads > 0 ? soft_output_threads : SDL_GetCPUCount();
+        if (!(so->sws = sws_alloc_context()) ||
+            av_opt_set_int(so->sws, "srcw", so->src->width, 0) < 0 ||
+            av_opt_set_int(so->sws, "srch", so->src->height, 0) < 0 ||
+            av_opt_set_int(so->sws, "src_format", so->src->format, 0) < 0 ||
+            av_opt_set_int(so->sws, "dstw", rect->w, 0) < 0 ||
+            av_opt_set_int(so->sws, "dsth", rect->h, 0) < 0 ||
+            av_opt_set_int(so->sws, "dst_format", pix_fmt, 0) < 0 ||
+            av_opt_set_int(so->sws, "sws_flags", sws_flags, 0) < 0 ||
+            av_opt_set_int(so->sws, "threads", so->nb_threads, 0) < 0 ||
+            sws_init_context(so->sws, NULL, NULL) < 0)
         {
-            // nothing to do, no picture to display in the queue
+            av_log(NULL, AV_LOG_ERROR, "Cannot initialize the software output conversion context\n");
+            sws_freeContext(so->sws);
+            so->sws = NULL;
+            av_frame_unref(so->src);
+            return -1;
         }
-        else
+
+        so->src_w = so->src->width;
+        so->src_h = so->src->height;
+        so->src_format = so->src->format;
+        so->dst_w = rect->w;
+        so->dst_h = rect->h;
+        so->dst_format = pix_fmt;
+    }
+
+    if (SDL_LockTexture(so->texture, NULL, &pixels, &pitch) < 0)
+    {
+        av_frame_unref(so->src);
+        return -1;
+    }
+
+    /* sws_scale_frame only slice threads into a frame with buffers, wrap the texture memory in one */
+    so->dst->format = pix_fmt;
+    so->dst->width = rect->w;
+    so->dst->height = rect->h;
+    so->dst->data[0] = pixels;
+    so->dst->linesize[0] = pitch;
+    so->dst->buf[0] = av_buffer_create(pixels, pitch * rect->h, soft_output_buffer_free, NULL, 0);
+
+    ret = so->dst->buf[0] ? sws_scale_frame(so->sws, so->dst, so->src) : AVERROR(ENOMEM);
+
+    SDL_UnlockTexture(so->texture);
+    av_frame_unref(so->dst);
+    av_frame_unref(so->src);
+
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    SDL_RenderCopy(renderer, so->texture, NULL, rect);
+
+    so->time += av_gettime_relative() - start;
+    so->nb_frames++;
+
+    return 0;
+}
+
+static void soft_output_free(SoftOutput *so)
+{
+    if (so->nb_frames)
+    {
+        av_log(NULL, AV_LOG_INFO, "software output: %d pictures scaled on %d threads, %.2f ms average\n",
+               so->nb_frames, so->nb_threads, so->time / 1000.0 / so->nb_frames);
+    }
+
+    sws_freeContext(so->sws);
+    av_frame_free(&so->src);
+    av_frame_free(&so->dst);
+
+    if (so->texture)
+    {
+        SDL_DestroyTexture(so->texture);
+    }
+}
+
+/* fixed-width atlas of the built-in font at a line height of size, digits and lower case set the pitch */
+static int stats_overlay_layout(StatsOverlay *so, int size)
+{
+    TextRenderer *tr = av_mallocz(sizeof(TextRenderer));
+    if (!tr)
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    int cell_w = 0;
+    for (int c = '0'; c <= 'z'; c++)
+    {
+        const GlyphCacheEntry *g = (c <= '9' || c >= 'a') ? glyph_cache_get(tr, size, c) : NULL;
+        if (g)
         {
-            double last_duration, duration, delay;
-            Frame *vp, *lastvp;
+            cell_w = FFMAX(cell_w, g->advance);
+        }
+    }
 
-            /* dequeue the picture */
-            lastvp = frame_queue_peek_last(&is->pictq);
-            vp = frame_queue_peek(&is->pictq);
+    av_freep(&so->font);
+    av_freep(&so->pixels);
+    so->font_size = 0;
 
-            if (vp->serial != is->videoq.serial)
-            {
-                frame_queue_next(&is->pictq);
-                goto retry;
-            }
+    if (!cell_w || !(so->font = av_mallocz(('~' - ' ' + 1) * cell_w * size)))
+    {
+        text_renderer_free(&tr);
+        return AVERROR(ENOMEM);
+    }
 
-            if (lastvp->serial != vp->serial)
-                is->frame_timer = av_gettime_relative() / 1000000.0;
+    /* wider glyphs are centered in their cell and clipped */
+    for (int c = '!'; c <= '~'; c++)
+    {
+        const GlyphCacheEntry *g = glyph_cache_get(tr, size, c);
+        uint8_t *cell = so->font + (c - ' ') * cell_w * size;
 
-            if (is->paused)
+        for (int y = 0; g && y < g->h; y++)
+        {
+            int cy = g->top + y;
+            int x0 = (cell_w - g->advance) / 2 + g->xoff;
+
+            for (int x = 0; cy >= 0 && cy < size && x < g->w; x++)
             {
-                goto display;
+                if (x0 + x >= 0 && x0 + x < cell_w)
+                {
+                    cell[cy * cell_w + x0 + x] = g->alpha[y * g->w + x];
+                }
             }
+        }
+    }
 
-            /* compute nominal last_duration */
-            last_duration = vp_duration(is, lastvp, vp);
-            delay = compute_target_delay(last_duration, is);
+    text_renderer_free(&tr);
 
-            double time = av_gettime_relative() / 1000000.0;
-            if (time < is->frame_timer + delay)
-            {
-                *remaining_time = FFMIN(is->frame_timer + delay - time, *remaining_time);
-                goto display;
-            }
+    so->font_size = size;
+    so->cell_w = cell_w;
+    so->cell_h = size;
+    /* padding of half a line around the text, the graph is three lines high */
+    so->w = OVERLAY_COLS * cell_w + size / 2 * 2;
+    so->h = (OVERLAY_LINES + 3) * size + size / 2 * 2 + size / 4;
 
-            is->frame_timer += delay;
-            if (delay > 0 && time - is->frame_timer > AV_SYNC_THRESHOLD_MAX)
-            {
-                is->frame_timer = time;
-            }
+    if (!(so->pixels = av_malloc(so->w * so->h * sizeof(*so->pixels))))
+    {
+        so->font_size = 0;
+        return AVERROR(ENOMEM);
+    }
 
-            SDL_LockMutex(is->pictq.mutex);
+    /* a new size always redraws */
+    if (so->texture)
+    {
+        SDL_DestroyTexture(so->texture);
+        so->texture = NULL;
+    }
 
-            if (!isnan(vp->pts))
+    return 0;
+}
+
+/* straight alpha ARGB, for SDL_BLENDMODE_BLEND */
+static inline uint32_t overlay_argb(int a, int r, int g, int b)
+{
+    return (uint32_t)a << 24 | r << 16 | g << 8 | b;
+}
+
+static void overlay_fill(StatsOverlay *so, int x, int y, int w, int h, uint32_t argb)
+{
+    for (int j = FFMAX(y, 0); j < FFMIN(y + h, so->h); j++)
+    {
+        for (int i = FFMAX(x, 0); i < FFMIN(x + w, so->w); i++)
+        {
+            so->pixels[j * so->w + i] = argb;
+        }
+    }
+}
+
+static void stats_overlay_draw(StatsOverlay *so, const StatsOverlayContent *c)
+{
+    const int bg = 160;
+    int pad = so->cell_h / 2;
+    int bar_x = pad + 6 * so->cell_w, bar_w = OVERLAY_BAR_COLS * so->cell_w;
+
+    overlay_fill(so, 0, 0, so->w, so->h, overlay_argb(bg, 0, 0, 0));
+
+    /* white text over the background, blended here so the texture needs one blend on screen */
+    for (int l = 0; l < OVERLAY_LINES; l++)
+    {
+        for (int col = 0; c->text[l][col]; col++)
+        {
+            int ch = c->text[l][col];
+            if (ch <= ' ' || ch > '~')
             {
-                update_video_pts(is, vp->pts, vp->pos, vp->serial);
+                continue;
             }
 
-            SDL_UnlockMutex(is->pictq.mutex);
+            const uint8_t *cell = so->font + (ch - ' ') * so->cell_w * so->cell_h;
+            uint32_t *dst = so->pixels + (pad + l * so->cell_h) * so->w + pad + col * so->cell_w;
 
-            if (frame_queue_nb_remaining(&is->pictq) > 1)
+            for (int y = 0; y < so->cell_h; y++)
             {
-                Frame *nextvp = frame_queue_peek_next(&is->pictq);
-                duration = vp_duration(is, vp, nextvp);
-
-                if (!is->step && (framedrop > 0 || (framedrop && get_master_sync_type(is) != AV_SYNC_VIDEO_MASTER)) && time > is->frame_timer + duration)
+                for (int x = 0; x < so->cell_w; x++)
                 {
-                    is->frame_drops_late++;
-                    frame_queue_next(&is->pictq);
-                    goto retry;
+                    int ga = cell[y * so->cell_w + x];
+                    if (ga)
+                    {
+                        int a = bg + ga * (255 - bg) / 255;
+                        int v = ga * 255 / a;
+                        dst[y * so->w + x] = overlay_argb(a, v, v, v);
+                    }
                 }
             }
+        }
+    }
 
-            if (is->subtitle_st)
+    /* queue fill, amber when running low */
+    for (int i = 0; i < OVERLAY_BARS; i++)
+    {
+        int y = pad + (1 + i) * so->cell_h + so->cell_h / 4;
+        int h = so->cell_h / 2;
+        int fill = c->bar[i] * bar_w / 255;
+
+        overlay_fill(so, bar_x, y, bar_w, h, overlay_argb(200, 64, 64, 64));
+        overlay_fill(so, bar_x, y, fill, h, c->bar[i] < 64 ? overlay_argb(230, 224, 160, 32) : overlay_argb(230, 64, 192, 64));
+    }
+
+    /* frame times, oldest on the left, red above one and a half nominal frame durations */
+    int graph_w = OVERLAY_COLS * so->cell_w, graph_h = 3 * so->cell_h;
+    int base = pad + OVERLAY_LINES * so->cell_h + pad / 2 + graph_h;
+
+    overlay_fill(so, pad, base - graph_h, graph_w, graph_h, overlay_argb(200, 32, 32, 32));
+
+    for (int i = 0; i < OVERLAY_GRAPH_LEN; i++)
+    {
+        int x0 = pad + i * graph_w / OVERLAY_GRAPH_LEN, x1 = pad + (i + 1) * graph_w / OVERLAY_GRAPH_LEN;
+        int late = c->graph_mark && c->graph[i] > c->graph_mark * 3 / 2;
+
+        overlay_fill(so, x0, base - c->graph[i], FFMAX(x1 - x0 - 1, 1), c->graph[i],
+                     late ? overlay_argb(240, 224, 64, 64) : overlay_argb(240, 64, 192, 64));
+    }
+
+    if (c->graph_mark)
+    {
+        overlay_fill(so, pad, base - c->graph_mark, graph_w, 1, overlay_argb(255, 160, 160, 160));
+    }
+}
+
+static void stats_overlay_free(StatsOverlay *so)
+{
+    if (so->nb_redraws)
+    {
+        av_log(NULL, AV_LOG_VERBOSE, "stats overlay: %d redraws\n", so->nb_redraws);
+    }
+
+    av_freep(&so->font);
+    av_freep(&so->pixels);
+
+    if (so->texture)
+    {
+        SDL_DestroyTexture(so->texture);
+    }
+}
+
+static void video_image_display(VideoState *is)
+{
+    Frame *vp, *sp = NULL;
+    SDL_Rect rect;
+
+    vp = frame_queue_peek_last(&is->pictq);
+    if (is->subtitle_st)
+    {
+        sp = subtitle_refresh_render(is, vp);
+    }
+
+    /* rect is the box the turned picture fills, dst the unturned rect SDL rotates about its center into it */
+    int transposed = is->rotation == 90 || is->rotation == 270;
+    if (transposed)
+    {
+        calculate_display_rect(&rect, is->xleft, is->ytop, is->width, is->height, vp->height, vp->width, vp->sar.num ? av_inv_q(vp->sar) : vp->sar);
+    }
+    else
+    {
+        calculate_display_rect(&rect, is->xleft, is->ytop, is->width, is->height, vp->width, vp->height, vp->sar);
+    }
+
+    SDL_Rect dst = rect;
+    if (transposed)
+    {
+        dst.w = rect.h;
+        dst.h = rect.w;
+        dst.x = rect.x + (rect.w - rect.h) / 2;
+        dst.y = rect.y + (rect.h - rect.w) / 2;
+    }
+
+    is->display_rect = rect;
+
+    /* rotation and flips stay with the renderer */
+    int soft = soft_output_enabled() && !is->rotation && !is->rotation_hflip && !vp->flip_v &&
+               soft_output_display(is, vp, &rect) >= 0;
+
+    if (!soft)
+    {
+        /* normally done by video_preupload, this is the late path */
+        if (!vp->uploaded)
+        {
+            if (video_upload_frame(is, vp) < 0)
             {
-                subtitle_refresh_hide_or_skip(is);
+                return;
             }
 
-            frame_queue_next(&is->pictq);
-            is->force_refresh = 1;
+            is->nb_uploads_late++;
+        }
+        else if (!vp->attached)
+        {
+            /* zoom or pan moved the view since the upload */
+            SDL_Rect area;
+            video_zoom_area(is, vp, &area);
 
-            if (is->step && !is->paused)
+            if (!rect_equal(&is->vid_slots[vp->tex_index].area, &area) &&
+                texture_slot_upload(is, &is->vid_slots[vp->tex_index], vp, &area) < 0)
             {
-                stream_toggle_pause(is);
+                return;
             }
         }
 
-    display:
-        /* display picture */
-        if (is->force_refresh && is->pictq.rindex_shown)
+        SDL_Texture *tex = vp->attached ? is->attached_pic_texture : is->vid_slots[vp->tex_index].tex;
+
+        /* the texture of a flipped picture holds it bottom up */
+        SDL_Rect view;
+        video_zoom_view(is, vp, &view);
+        if (vp->flip_v)
+        {
+            view.y = vp->height - view.y - view.h;
+        }
+
+        SDL_RenderCopyEx(renderer, tex, is->zoom > 1.0 ? &view : NULL, &dst, is->rotation, NULL,
+                         (vp->flip_v ? SDL_FLIP_VERTICAL : 0) | (is->rotation_hflip ? SDL_FLIP_HORIZONTAL : 0));
+    }
+
+    if (sp)
+    {
+        /* subtitles stay upright, fitted into the turned box */
+        SDL_Rect sub_rect = rect;
+        if (transposed)
+        {
+            calculate_display_rect(&sub_rect, rect.x, rect.y, rect.w, rect.h, sp->width, sp->height, (AVRational){1, 1});
+        }
+
+        if (sp->sub.format == 1)
+        {
+            subtitle_draw_text(is, sp, &sub_rect);
+        }
+        else
+        {
+            SDL_RenderCopy(renderer, is->sub_texture, NULL, &sub_rect);
+        }
+    }
+}
+
+static inline int compute_mod(int a, int b)
+{
+    return a < 0 ? a % b + b : a % b;
+}
+
+#if HAVE_MMAP_IO
+static int mmap_io_map_window(MmapIO *mio, int64_t pos)
+{
+    if (mio->window)
+    {
+        munmap(mio->window, mio->window_size);
+        mio->window = NULL;
+        mio->nb_syscalls++;
+    }
+
+    int64_t offset = pos & ~(mio->page_size - 1);
+    int64_t size = FFMIN(MMAP_IO_WINDOW_SIZE, mio->file_size - offset);
+
+    void *addr = mmap(NULL, size, PROT_READ, MAP_SHARED, mio->fd, offset);
+    mio->nb_syscalls++;
+
+    if (addr == MAP_FAILED)
+    {
+        int err = errno;
+        av_log(NULL, AV_LOG_ERROR, "mmap io: mmap() at %" PRId64 " failed: %s\n", offset, strerror(err));
+        return AVERROR(err);
+    }
+
+    mio->window = addr;
+    mio->window_offset = offset;
+    mio->window_size = size;
+    mio->willneed_end = offset;
+
+    madvise(mio->window, mio->window_size, MADV_SEQUENTIAL);
+    mio->nb_syscalls++;
+
+    return 0;
+}
+
+static int mmap_io_read_packet(void *opaque, uint8_t *buf, int buf_size)
+{
+    MmapIO *mio = opaque;
+
+    if (mio->pos >= mio->file_size)
+    {
+        return AVERROR_EOF;
+    }
+
+    if (!mio->window || mio->pos < mio->window_offset || mio->pos >= mio->window_offset + mio->window_size)
+    {
+        int ret = mmap_io_map_window(mio, mio->pos);
+        if (ret < 0)
+        {
+            return ret;
+        }
+    }
+
+    int64_t window_end = mio->window_offset + mio->window_size;
+
+    /* keep the kernel prefetching a bounded distance ahead of the demuxer */
+    if (mio->pos + MMAP_IO_WILLNEED_SIZE / 2 > mio->willneed_end && mio->willneed_end < window_end)
+    {
+        int64_t start = FFMAX(mio->willneed_end, mio->pos & ~(mio->page_size - 1));
+        int64_t end = FFMIN(window_end, mio->pos + MMAP_IO_WILLNEED_SIZE);
+
+        madvise(mio->window + (start - mio->window_offset), end - start, MADV_WILLNEED);
+        mio->willneed_end = end;
+        mio->nb_syscalls++;
+    }
+
+    int len = FFMIN(buf_size, window_end - mio->pos);
+    memcpy(buf, mio->window + (mio->pos - mio->window_offset), len);
+
+    mio->pos += len;
+    mio->nb_reads++;
+    mio->bytes_read += len;
+
+    return len;
+}
+
+static int64_t mmap_io_seek(void *opaque, int64_t offset, int whence)
+{
+    MmapIO *mio = opaque;
+
+    switch (whence & ~AVSEEK_FORCE)
+    {
+    case AVSEEK_SIZE:
+        return mio->file_size;
+
+    case SEEK_SET:
+        break;
+
+    case SEEK_CUR:
+        offset += mio->pos;
+        break;
+
+    case SEEK_END:
+        offset += mio->file_size;
+        break;
+
+    default:
+        return AVERROR(EINVAL);
+    }
+
+    if (offset < 0)
+    {
+        return AVERROR(EINVAL);
+    }
+
+    /* the mapping is only moved lazily by the next read */
+    mio->pos = offset;
+
+    return offset;
+}
+
+static void mmap_io_close(MmapIO **pmio)
+{
+    MmapIO *mio = *pmio;
+
+    if (!mio)
+    {
+        return;
+    }
+
+    if (mio->nb_reads)
+    {
+        double elapsed = (av_gettime_relative() - mio->start_time) / 1000000.0;
+
+        av_log(NULL, AV_LOG_INFO,
+               "mmap io: %" PRId64 " reads, %" PRId64 " syscalls, %.1f MB in %.2fs (%.1f MB/s)\n",
+               mio->nb_reads,
+               mio->nb_syscalls,
+               mio->bytes_read / 1048576.0,
+               elapsed,
+               elapsed > 0 ? mio->bytes_read / 1048576.0 / elapsed : 0.0);
+    }
+
+    if (mio->window)
+    {
+        munmap(mio->window, mio->window_size);
+    }
+
+    if (mio->fd >= 0)
+    {
+        close(mio->fd);
+    }
+
+    if (mio->pb)
+    {
+        av_freep(&mio->pb->buffer);
+        avio_context_free(&mio->pb);
+    }
+
+    av_freep(pmio);
+}
+
+/* map a local file and wrap it in an AVIOContext, returns 0 without touching ic if not applicable */
+static int mmap_io_open(VideoState *is, AVFormatContext *ic)
+{
+    const char *protocol = avio_find_protocol_name(is->filename);
+    const char *path = is->filename;
+    struct stat st;
+
+    if (!protocol || strcmp(protocol, "file"))
+    {
+        return 0;
+    }
+
+    av_strstart(path, "file:", &path);
+
+    MmapIO *mio = av_mallocz(sizeof(MmapIO));
+    if (!mio)
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    is->mmio = mio;
+
+    mio->start_time = av_gettime_relative();
+    mio->page_size = sysconf(_SC_PAGESIZE);
+    mio->fd = open(path, O_RDONLY);
+
+    if (mio->fd < 0 || fstat(mio->fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+    {
+        /* pipes, devices and the like keep going through the file protocol */
+        mmap_io_close(&is->mmio);
+        return 0;
+    }
+
+    mio->file_size = st.st_size;
+
+    uint8_t *buffer = av_malloc(CUSTOM_IO_BUFFER_SIZE);
+    if (!buffer)
+    {
+        mmap_io_close(&is->mmio);
+        return AVERROR(ENOMEM);
+    }
+
+    mio->pb = avio_alloc_context(buffer, CUSTOM_IO_BUFFER_SIZE, 0, mio, mmap_io_read_packet, NULL, mmap_io_seek);
+    if (!mio->pb)
+    {
+        av_free(buffer);
+        mmap_io_close(&is->mmio);
+        return AVERROR(ENOMEM);
+    }
+
+    /* direct mode: avio_read() copies from the mapping straight into the packet, skipping the AVIO buffer */
+    mio->pb->direct = 1;
+
+    ic->pb = mio->pb;
+    ic->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    av_log(NULL, AV_LOG_VERBOSE, "mmap io: %s, %" PRId64 " bytes\n", path, mio->file_size);
+
+    return 0;
+}
+#endif
+
+#if HAVE_PREAD_IO
+/* read up to size bytes at offset, returns the bytes read, short at the end of the file or on error */
+static int readahead_io_pread(ReadaheadIO *raio, uint8_t *data, int64_t offset, int size, int *error)
+{
+    int done = 0;
+
+    while (done < size)
+    {
+        ssize_t n = pread(raio->fd, data + done, size - done, offset + done);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (n <= 0)
+        {
+            *error = n < 0 ? AVERROR(errno) : 0;
+            break;
+        }
+
+        done += n;
+    }
+
+    return done;
+}
+
+static int readahead_io_worker(void *arg)
+{
+    ReadaheadIO *raio = arg;
+
+    SDL_LockMutex(raio->mutex);
+
+    while (!raio->abort_request)
+    {
+        ReadaheadBlock *b = NULL;
+
+        /* serve the lowest offset first, that is the one the demuxer needs soonest */
+        for (int i = 0; i < READAHEAD_IO_NB_BLOCKS; i++)
+        {
+            ReadaheadBlock *c = &raio->blocks[i];
+            if (c->state == READAHEAD_BLOCK_QUEUED && (!b || c->offset < b->offset))
+            {
+                b = c;
+            }
+        }
+
+        if (!b)
+        {
+            SDL_CondWait(raio->work_cond, raio->mutex);
+            continue;
+        }
+
+        b->state = READAHEAD_BLOCK_READING;
+
+        int generation = b->generation;
+        int64_t offset = b->offset;
+        int size = FFMIN(READAHEAD_IO_BLOCK_SIZE, raio->file_size - offset);
+        int done, error = 0;
+
+        SDL_UnlockMutex(raio->mutex);
+
+        done = readahead_io_pread(raio, b->data, offset, size, &error);
+
+        SDL_LockMutex(raio->mutex);
+
+        if (b->generation != generation)
+        {
+            /* cancelled by a seek while the read was in flight */
+            b->state = READAHEAD_BLOCK_FREE;
+        }
+        else
+        {
+            b->size = done;
+            b->error = error;
+            b->state = READAHEAD_BLOCK_READY;
+        }
+
+        SDL_CondBroadcast(raio->done_cond);
+    }
+
+    SDL_UnlockMutex(raio->mutex);
+
+    return 0;
+}
+
+#if HAVE_IO_URING
+static void readahead_uring_free(ReadaheadUring **pring)
+{
+    ReadaheadUring *ring = *pring;
+
+    if (!ring)
+    {
+        return;
+    }
+
+    if (ring->sqes)
+    {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+
+    if (ring->cq_ring)
+    {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+
+    if (ring->sq_ring)
+    {
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    }
+
+    if (ring->fd >= 0)
+    {
+        close(ring->fd);
+    }
+
+    av_freep(pring);
+}
+
+static void *readahead_uring_map(ReadaheadUring *ring, size_t size, off_t offset)
+{
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, offset);
+
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+/* set up a ring deep enough for every block to be in flight, returns NULL if the kernel cannot serve reads through io_uring */
+static ReadaheadUring *readahead_uring_alloc(void)
+{
+    struct io_uring_params params = { 0 };
+    struct io_uring_probe *probe = NULL;
+    ReadaheadUring *ring = av_mallocz(sizeof(ReadaheadUring));
+    int ret;
+
+    if (!ring)
+    {
+        return NULL;
+    }
+
+    /* fails with ENOSYS on kernels without io_uring and EPERM where it is disabled or filtered */
+    ring->fd = syscall(__NR_io_uring_setup, READAHEAD_IO_NB_BLOCKS, &params);
+    if (ring->fd < 0)
+    {
+        ret = AVERROR(errno);
+        goto fail;
+    }
+
+    /* IORING_OP_READ needs 5.6, older kernels accept the ring but fail every read */
+    probe = av_mallocz(sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op));
+    if (!probe)
+    {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    if (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE, probe, 256) < 0 ||
+        probe->last_op < IORING_OP_READ ||
+        !(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED))
+    {
+        ret = AVERROR(ENOSYS);
+        goto fail;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    if (!(ring->sq_ring = readahead_uring_map(ring, ring->sq_ring_size, IORING_OFF_SQ_RING)) ||
+        !(ring->cq_ring = readahead_uring_map(ring, ring->cq_ring_size, IORING_OFF_CQ_RING)) ||
+        !(ring->sqes = readahead_uring_map(ring, ring->sqes_size, IORING_OFF_SQES)))
+    {
+        ret = AVERROR(errno);
+        goto fail;
+    }
+
+    ring->sq_tail = (unsigned *)((uint8_t *)ring->sq_ring + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)((uint8_t *)ring->sq_ring + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)((uint8_t *)ring->sq_ring + params.sq_off.array);
+    ring->cq_head = (unsigned *)((uint8_t *)ring->cq_ring + params.cq_off.head);
+    ring->cq_tail = (unsigned *)((uint8_t *)ring->cq_ring + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)((uint8_t *)ring->cq_ring + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)((uint8_t *)ring->cq_ring + params.cq_off.cqes);
+
+    av_free(probe);
+
+    return ring;
+
+fail:
+    av_log(NULL, AV_LOG_VERBOSE, "readahead io: io_uring not available (%s), using pread workers\n", av_err2str(ret));
+    av_free(probe);
+    readahead_uring_free(&ring);
+
+    return NULL;
+}
+
+/* submit a read of the rest of block b, called with the mutex held */
+static int readahead_uring_submit(ReadaheadIO *raio, ReadaheadBlock *b)
+{
+    ReadaheadUring *ring = raio->uring;
+    int size = FFMIN(READAHEAD_IO_BLOCK_SIZE, raio->file_size - b->offset);
+    unsigned tail = *ring->sq_tail;
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    int ret;
+
+    /* a block has at most one read in flight and the ring has an entry per block, so the queue is never full */
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = raio->fd;
+    sqe->addr = (uintptr_t)(b->data + b->size);
+    sqe->len = size - b->size;
+    sqe->off = b->offset + b->size;
+    sqe->user_data = (uint64_t)(uint32_t)b->generation << 32 | (uint64_t)(b - raio->blocks);
+    ring->sq_array[index] = index;
+
+    SDL_MemoryBarrierRelease();
+    *ring->sq_tail = tail + 1;
+
+    do
+    {
+        ret = syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0);
+    } while (ret < 0 && errno == EINTR);
+
+    if (ret < 1)
+    {
+        /* the kernel did not consume the entry, take it back */
+        ret = ret < 0 ? AVERROR(errno) : AVERROR(EAGAIN);
+        *ring->sq_tail = tail;
+        return ret;
+    }
+
+    b->state = READAHEAD_BLOCK_READING;
+
+    /* wake the completion thread if it was idle */
+    if (!raio->uring_inflight++)
+    {
+        SDL_CondBroadcast(raio->work_cond);
+    }
+
+    return 0;
+}
+
+/* continue reading block b through the ring, or synchronously if the submission fails, called with the mutex held */
+static void readahead_uring_read(ReadaheadIO *raio, ReadaheadBlock *b)
+{
+    int ret = readahead_uring_submit(raio, b);
+    if (ret >= 0)
+    {
+        return;
+    }
+
+    av_log(NULL, AV_LOG_DEBUG, "readahead io: io_uring submit failed (%s), reading synchronously\n", av_err2str(ret));
+
+    int size = FFMIN(READAHEAD_IO_BLOCK_SIZE, raio->file_size - b->offset);
+
+    b->size += readahead_io_pread(raio, b->data + b->size, b->offset + b->size, size - b->size, &b->error);
+    b->state = READAHEAD_BLOCK_READY;
+
+    SDL_CondBroadcast(raio->done_cond);
+}
+
+static void readahead_uring_complete(ReadaheadIO *raio, uint64_t user_data, int res)
+{
+    ReadaheadBlock *b = &raio->blocks[(uint32_t)user_data];
+    int size = FFMIN(READAHEAD_IO_BLOCK_SIZE, raio->file_size - b->offset);
+
+    raio->uring_inflight--;
+
+    if ((uint32_t)b->generation != (uint32_t)(user_data >> 32))
+    {
+        /* cancelled by a seek while the read was in flight */
+        b->state = READAHEAD_BLOCK_FREE;
+        SDL_CondBroadcast(raio->done_cond);
+        return;
+    }
+
+    if (res > 0)
+    {
+        b->size += res;
+    }
+    else if (res < 0 && res != -EINTR && res != -EAGAIN)
+    {
+        b->error = AVERROR(-res);
+    }
+
+    /* short read or interrupted, continue where it stopped unless the file ended */
+    if (!b->error && res != 0 && b->size < size)
+    {
+        readahead_uring_read(raio, b);
+        return;
+    }
+
+    b->state = READAHEAD_BLOCK_READY;
+
+    SDL_CondBroadcast(raio->done_cond);
+}
+
+/* reads are submitted by the demuxer thread as blocks are requested, this thread only reaps their completions */
+static int readahead_uring_worker(void *arg)
+{
+    ReadaheadIO *raio = arg;
+    ReadaheadUring *ring = raio->uring;
+
+    SDL_LockMutex(raio->mutex);
+
+    /* on abort, wait for the reads still in flight, the kernel writes into the block buffers until they complete */
+    while (raio->uring_inflight || !raio->abort_request)
+    {
+        if (!raio->uring_inflight)
+        {
+            SDL_CondWait(raio->work_cond, raio->mutex);
+            continue;
+        }
+
+        SDL_UnlockMutex(raio->mutex);
+
+        /* the completion queue is checked below either way, a failing wait only turns this into polling */
+        if (syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR)
+        {
+            SDL_Delay(1);
+        }
+
+        SDL_LockMutex(raio->mutex);
+
+        unsigned head = *ring->cq_head;
+        unsigned tail = *ring->cq_tail;
+
+        SDL_MemoryBarrierAcquire();
+
+        for (; head != tail; head++)
+        {
+            struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+            readahead_uring_complete(raio, cqe->user_data, cqe->res);
+        }
+
+        SDL_MemoryBarrierRelease();
+        *ring->cq_head = head;
+    }
+
+    SDL_UnlockMutex(raio->mutex);
+
+    return 0;
+}
+#endif
+
+static ReadaheadBlock *readahead_io_find_block(ReadaheadIO *raio, int64_t offset)
+{
+    for (int i = 0; i < READAHEAD_IO_NB_BLOCKS; i++)
+    {
+        ReadaheadBlock *b = &raio->blocks[i];
+        if (b->state != READAHEAD_BLOCK_FREE && b->offset == offset)
+        {
+            return b;
+        }
+    }
+
+    return NULL;
+}
+
+/* queue a read of the block at offset, evicting the least recently used cached block if needed */
+static ReadaheadBlock *readahead_io_request_block(ReadaheadIO *raio, int64_t offset, int64_t pos)
+{
+    ReadaheadBlock *b = readahead_io_find_block(raio, offset);
+    if (b)
+    {
+        return b;
+    }
+
+    for (int i = 0; i < READAHEAD_IO_NB_BLOCKS; i++)
+    {
+        ReadaheadBlock *c = &raio->blocks[i];
+
+        if (c->state == READAHEAD_BLOCK_FREE)
+        {
+            b = c;
+            break;
+        }
+
+        /* never evict the block being read from */
+        if (c->state == READAHEAD_BLOCK_READY &&
+            (pos < c->offset || pos >= c->offset + READAHEAD_IO_BLOCK_SIZE) &&
+            (!b || c->last_used < b->last_used))
+        {
+            b = c;
+        }
+    }
+
+    if (!b)
+    {
+        return NULL;
+    }
+
+    b->offset = offset;
+    b->size = 0;
+    b->error = 0;
+    b->state = READAHEAD_BLOCK_QUEUED;
+    b->last_used = ++raio->use_counter;
+
+#if HAVE_IO_URING
+    if (raio->uring)
+    {
+        readahead_uring_read(raio, b);
+        return b;
+    }
+#endif
+
+    SDL_CondSignal(raio->work_cond);
+
+    return b;
+}
+
+static void readahead_io_cancel(ReadaheadIO *raio, int64_t keep_offset)
+{
+    for (int i = 0; i < READAHEAD_IO_NB_BLOCKS; i++)
+    {
+        ReadaheadBlock *b = &raio->blocks[i];
+
+        if (b->offset == keep_offset)
+        {
+            continue;
+        }
+
+        if (b->state == READAHEAD_BLOCK_QUEUED)
+        {
+            b->state = READAHEAD_BLOCK_FREE;
+            raio->nb_cancelled++;
+        }
+        else if (b->state == READAHEAD_BLOCK_READING)
+        {
+            b->generation++;
+            raio->nb_cancelled++;
+        }
+    }
+}
+
+static int readahead_io_read_packet(void *opaque, uint8_t *buf, int buf_size)
+{
+    ReadaheadIO *raio = opaque;
+    int64_t start = av_gettime_relative();
+    int ret;
+
+    if (raio->pos >= raio->file_size)
+    {
+        return AVERROR_EOF;
+    }
+
+    int64_t offset = raio->pos & ~((int64_t)READAHEAD_IO_BLOCK_SIZE - 1);
+
+    SDL_LockMutex(raio->mutex);
+
+    raio->sequential = raio->pos == raio->next_pos ? raio->sequential + 1 : 0;
+
+    ReadaheadBlock *b = readahead_io_request_block(raio, offset, raio->pos);
+    if (b && b->state == READAHEAD_BLOCK_READY)
+    {
+        raio->nb_hits++;
+    }
+
+    /* keep several reads in flight only while the demuxer reads sequentially */
+    if (raio->sequential >= 2)
+    {
+        for (int i = 1; i <= READAHEAD_IO_DEPTH; i++)
+        {
+            int64_t ahead = offset + (int64_t)i * READAHEAD_IO_BLOCK_SIZE;
+            if (ahead >= raio->file_size || !readahead_io_request_block(raio, ahead, raio->pos))
+            {
+                break;
+            }
+        }
+    }
+
+    while (!b || b->state != READAHEAD_BLOCK_READY)
+    {
+        if (raio->interrupt_callback.callback && raio->interrupt_callback.callback(raio->interrupt_callback.opaque))
+        {
+            SDL_UnlockMutex(raio->mutex);
+            return AVERROR_EXIT;
+        }
+
+        SDL_CondWaitTimeout(raio->done_cond, raio->mutex, 10);
+
+        /* no block was free, or ours was cancelled while in flight and recycled */
+        if (!b || b->offset != offset || b->state == READAHEAD_BLOCK_FREE)
+        {
+            b = readahead_io_request_block(raio, offset, raio->pos);
+        }
+    }
+
+    if (b->error)
+    {
+        ret = b->error;
+        b->state = READAHEAD_BLOCK_FREE;
+    }
+    else
+    {
+        ret = FFMIN(buf_size, b->offset + b->size - raio->pos);
+
+        if (ret <= 0)
+        {
+            ret = AVERROR_EOF;
+        }
+        else
+        {
+            memcpy(buf, b->data + (raio->pos - b->offset), ret);
+            b->last_used = ++raio->use_counter;
+            raio->pos += ret;
+            raio->next_pos = raio->pos;
+        }
+    }
+
+    int64_t latency = av_gettime_relative() - start;
+
+    raio->nb_reads++;
+    raio->latency_max = FFMAX(raio->latency_max, latency);
+    raio->latency_hist[FFMIN(av_log2(latency) + (latency > 0), READAHEAD_IO_HIST_SIZE - 1)]++;
+
+    SDL_UnlockMutex(raio->mutex);
+
+    return ret;
+}
+
+static int64_t readahead_io_seek(void *opaque, int64_t offset, int whence)
+{
+    ReadaheadIO *raio = opaque;
+
+    switch (whence & ~AVSEEK_FORCE)
+    {
+    case AVSEEK_SIZE:
+        return raio->file_size;
+
+    case SEEK_SET:
+        break;
+
+    case SEEK_CUR:
+        offset += raio->pos;
+        break;
+
+    case SEEK_END:
+        offset += raio->file_size;
+        break;
+
+    default:
+        return AVERROR(EINVAL);
+    }
+
+    if (offset < 0)
+    {
+        return AVERROR(EINVAL);
+    }
+
+    SDL_LockMutex(raio->mutex);
+
+    /* outstanding read-ahead is for the old position, drop it so the workers serve the new one first */
+    readahead_io_cancel(raio, offset & ~((int64_t)READAHEAD_IO_BLOCK_SIZE - 1));
+
+    raio->pos = offset;
+    raio->sequential = 0;
+
+    SDL_UnlockMutex(raio->mutex);
+
+    return offset;
+}
+
+/* return the upper bound in us of the bucket holding the given percentile */
+static int64_t readahead_io_percentile(ReadaheadIO *raio, double percentile)
+{
+    int64_t target = ceil(raio->nb_reads * percentile / 100.0);
+    int64_t count = 0;
+
+    for (int i = 0; i < READAHEAD_IO_HIST_SIZE; i++)
+    {
+        count += raio->latency_hist[i];
+        if (count >= target)
+        {
+            return (int64_t)1 << i;
+        }
+    }
+
+    return raio->latency_max;
+}
+
+static void readahead_io_close(ReadaheadIO **praio)
+{
+    ReadaheadIO *raio = *praio;
+
+    if (!raio)
+    {
+        return;
+    }
+
+    if (raio->mutex)
+    {
+        SDL_LockMutex(raio->mutex);
+        raio->abort_request = 1;
+        SDL_CondBroadcast(raio->work_cond);
+        SDL_UnlockMutex(raio->mutex);
+    }
+
+    for (int i = 0; i < READAHEAD_IO_NB_THREADS; i++)
+    {
+        if (raio->threads[i])
+        {
+            SDL_WaitThread(raio->threads[i], NULL);
+        }
+    }
+
+    if (raio->nb_reads)
+    {
+        av_log(NULL, AV_LOG_INFO,
+               "readahead io: %" PRId64 " reads, %" PRId64 " hits, %" PRId64 " cancelled, latency p50<%" PRId64 "us p90<%" PRId64 "us p99<%" PRId64 "us max=%" PRId64 "us\n",
+               raio->nb_reads,
+               raio->nb_hits,
+               raio->nb_cancelled,
+               readahead_io_percentile(raio, 50),
+               readahead_io_percentile(raio, 90),
+               readahead_io_percentile(raio, 99),
+               raio->latency_max);
+    }
+
+#if HAVE_IO_URING
+    readahead_uring_free(&raio->uring);
+#endif
+
+    for (int i = 0; i < READAHEAD_IO_NB_BLOCKS; i++)
+    {
+        av_freep(&raio->blocks[i].data);
+    }
+
+    if (raio->fd >= 0)
+    {
+        close(raio->fd);
+    }
+
+    if (raio->pb)
+    {
+        av_freep(&raio->pb->buffer);
+        avio_context_free(&raio->pb);
+    }
+
+    SDL_DestroyCond(raio->done_cond);
+    SDL_DestroyCond(raio->work_cond);
+    SDL_DestroyMutex(raio->mutex);
+
+    av_freep(praio);
+}
+
+/* wrap a local file in an AVIOContext fed by read-ahead worker threads, returns 0 without touching ic if not applicable */
+static int readahead_io_open(VideoState *is, AVFormatContext *ic)
+{
+    const char *protocol = avio_find_protocol_name(is->filename);
+    const char *path = is->filename;
+    struct stat st;
+
+    if (!protocol || strcmp(protocol, "file"))
+    {
+        return 0;
+    }
+
+    av_strstart(path, "file:", &path);
+
+    ReadaheadIO *raio = av_mallocz(sizeof(ReadaheadIO));
+    if (!raio)
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    is->raio = raio;
+
+    raio->interrupt_callback = ic->interrupt_callback;
+    raio->fd = open(path, O_RDONLY);
+
+    if (raio->fd < 0 || fstat(raio->fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+    {
+        readahead_io_close(&is->raio);
+        return 0;
+    }
+
+    raio->file_size = st.st_size;
+
+    if (!(raio->mutex = SDL_CreateMutex()) ||
+        !(raio->work_cond = SDL_CreateCond()) ||
+        !(raio->done_cond = SDL_CreateCond()))
+    {
+        av_log(NULL, AV_LOG_FATAL, "SDL_CreateMutex/Cond(): %s\n", SDL_GetError());
+        readahead_io_close(&is->raio);
+        return AVERROR(ENOMEM);
+    }
+
+    for (int i = 0; i < READAHEAD_IO_NB_BLOCKS; i++)
+    {
+        if (!(raio->blocks[i].data = av_malloc(READAHEAD_IO_BLOCK_SIZE)))
+        {
+            readahead_io_close(&is->raio);
+            return AVERROR(ENOMEM);
+        }
+    }
+
+    uint8_t *buffer = av_malloc(CUSTOM_IO_BUFFER_SIZE);
+    if (!buffer)
+    {
+        readahead_io_close(&is->raio);
+        return AVERROR(ENOMEM);
+    }
+
+    raio->pb = avio_alloc_context(buffer, CUSTOM_IO_BUFFER_SIZE, 0, raio, readahead_io_read_packet, NULL, readahead_io_seek);
+    if (!raio->pb)
+    {
+        av_free(buffer);
+        readahead_io_close(&is->raio);
+        return AVERROR(ENOMEM);
+    }
+
+    int (*worker)(void *) = readahead_io_worker;
+    int nb_threads = READAHEAD_IO_NB_THREADS;
+
+#if HAVE_IO_URING
+    /* the ring keeps every block in flight from one thread, the pread workers are the fallback */
+    if ((raio->uring = readahead_uring_alloc()))
+    {
+        worker = readahead_uring_worker;
+        nb_threads = 1;
+    }
+#endif
+
+    for (int i = 0; i < nb_threads; i++)
+    {
+        if (!(raio->threads[i] = SDL_CreateThread(worker, "readahead_io", raio)))
+        {
+            av_log(NULL, AV_LOG_ERROR, "SDL_CreateThread(): %s\n", SDL_GetError());
+            readahead_io_close(&is->raio);
+            return AVERROR(ENOMEM);
+        }
+    }
+
+    ic->pb = raio->pb;
+    ic->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    const char *backend = "pread";
+#if HAVE_IO_URING
+    if (raio->uring)
+    {
+        backend = "io_uring";
+    }
+#endif
+
+    av_log(NULL, AV_LOG_VERBOSE, "readahead io: %s, %" PRId64 " bytes, %s\n", path, raio->file_size, backend);
+
+    return 0;
+}
+#endif
+
+static int helper_io_interrupt_cb(void *ctx)
+{
+    HelperIO *io = ctx;
+    return io->abort || av_gettime_relative() > io->deadline;
+}
+
+/* the next I/O of the helper gets timeout microseconds, 0 lets it take as long as it needs */
+static void helper_io_begin(HelperIO *io, int64_t timeout)
+{
+    io->deadline = timeout > 0 ? av_gettime_relative() + timeout : INT64_MAX;
+}
+
+/*
+ * join a helper thread that posts done when it exits, like the read thread it is abandoned after shutdown_timeout.
+ * on AVERROR(ETIMEDOUT) the caller leaks whatever the thread still uses
+ */
+static int helper_thread_join(SDL_Thread *tid, SDL_sem *done, const char *name)
+{
+    if (shutdown_timeout > 0 && SDL_SemWaitTimeout(done, shutdown_timeout / 1000) == SDL_MUTEX_TIMEDOUT)
+    {
+        av_log(NULL, AV_LOG_ERROR, "%s thread did not exit within %.1fs, abandoning it\n", name, shutdown_timeout / 1000000.0);
+        SDL_DetachThread(tid);
+        return AVERROR(ETIMEDOUT);
+    }
+
+    SDL_WaitThread(tid, NULL);
+
+    return 0;
+}
+
+static char *cache_file_path(const char *name)
+{
+    const char *home = getenv("HOME");
+#ifdef _WIN32
+    if (!home)
+    {
+        home = getenv("USERPROFILE");
+    }
+#endif
+
+    if (!home)
+    {
+        return NULL;
+    }
+
+    char *dir = av_asprintf("%s/.ffplayer", home);
+    if (!dir)
+    {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    _mkdir(dir);
+#else
+    mkdir(dir, 0755);
+#endif
+
+    char *path = av_asprintf("%s/%s", dir, name);
+    av_free(dir);
+
+    return path;
+}
+
+static int byte_time_map_insert_locked(ByteTimeMap *map, int64_t pos, int64_t ts)
+{
+    if (pos < 0 || ts == AV_NOPTS_VALUE || map->nb_entries >= BYTE_TIME_MAP_MAX_ENTRIES)
+    {
+        return 0;
+    }
+
+    /* first entry after pos */
+    int lo = 0, hi = map->nb_entries;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+
+        if (map->entries[mid].pos <= pos)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    ByteTimeEntry *prev = lo > 0 ? &map->entries[lo - 1] : NULL;
+    ByteTimeEntry *next = lo < map->nb_entries ? &map->entries[lo] : NULL;
+
+    if ((prev && pos - prev->pos < map->spacing) || (next && next->pos - pos < map->spacing))
+    {
+        return 0;
+    }
+
+    if ((prev && ts < prev->ts) || (next && ts > next->ts))
+    {
+        map->nb_rejected++;
+        return 0;
+    }
+
+    memmove(&map->entries[lo + 1], &map->entries[lo], (map->nb_entries - lo) * sizeof(*map->entries));
+    map->entries[lo].pos = pos;
+    map->entries[lo].ts = ts;
+    map->nb_entries++;
+    map->dirty = 1;
+
+    return 1;
+}
+
+static void byte_time_map_add(ByteTimeMap *map, int64_t pos, int64_t ts)
+{
+    SDL_LockMutex(map->mutex);
+    byte_time_map_insert_locked(map, pos, ts);
+    SDL_UnlockMutex(map->mutex);
+}
+
+/* interpolate between the bracketing points, extrapolate with the average rate outside the map */
+static int64_t byte_time_map_lookup(ByteTimeMap *map, int64_t key, int by_ts)
+{
+#define BTM_KEY(e) (by_ts ? (e)->ts : (e)->pos)
+#define BTM_VAL(e) (by_ts ? (e)->pos : (e)->ts)
+
+    int64_t ret = AV_NOPTS_VALUE;
+
+    if (!map || key == AV_NOPTS_VALUE)
+    {
+        return ret;
+    }
+
+    SDL_LockMutex(map->mutex);
+
+    if (map->nb_entries >= 2)
+    {
+        ByteTimeEntry *a = &map->entries[0];
+        ByteTimeEntry *b = &map->entries[map->nb_entries - 1];
+
+        if (key >= BTM_KEY(a) && key <= BTM_KEY(b))
+        {
+            int lo = 0, hi = map->nb_entries - 1;
+            while (hi - lo > 1)
+            {
+                int mid = (lo + hi) / 2;
+
+                if (BTM_KEY(&map->entries[mid]) <= key)
+                {
+                    lo = mid;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+
+            a = &map->entries[lo];
+            b = &map->entries[hi];
+        }
+
+        if (BTM_KEY(b) > BTM_KEY(a))
+        {
+            ret = BTM_VAL(a) + av_rescale(key - BTM_KEY(a), BTM_VAL(b) - BTM_VAL(a), BTM_KEY(b) - BTM_KEY(a));
+        }
+        else
+        {
+            ret = BTM_VAL(a);
+        }
+    }
+
+    SDL_UnlockMutex(map->mutex);
+
+    return ret;
+
+#undef BTM_KEY
+#undef BTM_VAL
+}
+
+/* byte position for a timestamp, -1 if the map cannot tell */
+static int64_t byte_time_map_pos(ByteTimeMap *map, int64_t ts)
+{
+    int64_t pos = byte_time_map_lookup(map, ts, 1);
+    if (pos == AV_NOPTS_VALUE)
+    {
+        return -1;
+    }
+
+    return av_clip64(pos, 0, map->file_size - 1);
+}
+
+static int64_t byte_time_map_ts(ByteTimeMap *map, int64_t pos)
+{
+    return pos < 0 ? AV_NOPTS_VALUE : byte_time_map_lookup(map, pos, 0);
+}
+
+static void byte_time_map_load(ByteTimeMap *map)
+{
+    FILE *f = fopen(map->cache_path, "r");
+    if (!f)
+    {
+        return;
+    }
+
+    int version = 0;
+    int64_t file_size = 0;
+
+    if (fscanf(f, "ffplayer-bytemap %d %" SCNd64, &version, &file_size) == 2 && version == 1 && file_size == map->file_size)
+    {
+        int64_t pos, ts;
+
+        while (fscanf(f, "%" SCNd64 " %" SCNd64, &pos, &ts) == 2)
+        {
+            byte_time_map_insert_locked(map, pos, ts);
+        }
+    }
+
+    fclose(f);
+
+    map->dirty = 0;
+
+    av_log(NULL, AV_LOG_VERBOSE, "byte/time map: %d points loaded from %s\n", map->nb_entries, map->cache_path);
+}
+
+static void byte_time_map_save(ByteTimeMap *map)
+{
+    if (!map->cache_path || !map->dirty)
+    {
+        return;
+    }
+
+    FILE *f = fopen(map->cache_path, "w");
+    if (!f)
+    {
+        av_log(NULL, AV_LOG_WARNING, "byte/time map: cannot write %s\n", map->cache_path);
+        return;
+    }
+
+    fprintf(f, "ffplayer-bytemap 1 %" PRId64 "\n", map->file_size);
+
+    for (int i = 0; i < map->nb_entries; i++)
+    {
+        fprintf(f, "%" PRId64 " %" PRId64 "\n", map->entries[i].pos, map->entries[i].ts);
+    }
+
+    fclose(f);
+}
+
+/* sparse probe on a private demuxer, coarse to fine so that an early stop still leaves an even spread */
+static int byte_time_map_probe_thread(void *arg)
+{
+    ByteTimeMap *map = arg;
+    int nb_probes = 0, nb_added = 0;
+
+    AVPacket *pkt = av_packet_alloc();
+    AVFormatContext *ic = avformat_alloc_context();
+    if (!pkt || !ic)
+    {
+        goto end;
+    }
+
+    ic->interrupt_callback.callback = helper_io_interrupt_cb;
+    ic->interrupt_callback.opaque = &map->probe_io;
+
+    helper_io_begin(&map->probe_io, io_open_timeout);
+    if (avformat_open_input(&ic, map->filename, map->iformat, NULL) < 0)
+    {
+        goto end;
+    }
+
+    /* the probe's demuxer numbers the streams on its own, the same index is only preferred among equal ids */
+    int probe_index = -1;
+    for (int i = 0; i < (int)ic->nb_streams; i++)
+    {
+        AVStream *st = ic->streams[i];
+        if (st->id == map->stream_id && st->codecpar->codec_id == map->codec_id && (probe_index < 0 || i == map->stream_index))
+        {
+            probe_index = i;
+        }
+    }
+
+    if (probe_index < 0)
+    {
+        av_log(NULL, AV_LOG_VERBOSE, "byte/time map: stream id %d not found by the probe\n", map->stream_id);
+        goto end;
+    }
+
+    for (int i = 0; i < (int)ic->nb_streams; i++)
+    {
+        ic->streams[i]->discard = i == probe_index ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+
+    AVRational tb = ic->streams[probe_index]->time_base;
+
+    for (int level = 1; nb_probes < BYTE_TIME_MAP_PROBE_POINTS && !map->probe_io.abort; level++)
+    {
+        for (int64_t j = 0; j < (1LL << (level - 1)) && nb_probes < BYTE_TIME_MAP_PROBE_POINTS && !map->probe_io.abort; j++)
+        {
+            int64_t pos = av_rescale(map->file_size, 2 * j + 1, 1LL << level);
+
+            nb_probes++;
+
+            helper_io_begin(&map->probe_io, io_seek_timeout);
+            if (av_seek_frame(ic, -1, pos, AVSEEK_FLAG_BYTE) < 0)
+            {
+                continue;
+            }
+
+            for (int n = 0; n < BYTE_TIME_MAP_PROBE_PACKETS && !map->probe_io.abort; n++)
+            {
+                helper_io_begin(&map->probe_io, io_read_timeout);
+                if (av_read_frame(ic, pkt) < 0)
+                {
+                    break;
+                }
+
+                int64_t ts = pkt->dts != AV_NOPTS_VALUE ? pkt->dts : pkt->pts;
+                int found = pkt->stream_index == probe_index && ts != AV_NOPTS_VALUE && pkt->pos >= 0;
+
+                if (found)
+                {
+                    SDL_LockMutex(map->mutex);
+                    nb_added += byte_time_map_insert_locked(map, pkt->pos, av_rescale_q(ts, tb, AV_TIME_BASE_Q));
+                    SDL_UnlockMutex(map->mutex);
+                }
+
+                av_packet_unref(pkt);
+
+                if (found)
+                {
+                    break;
+                }
+            }
+
+            SDL_Delay(BYTE_TIME_MAP_PROBE_INTERVAL);
+        }
+    }
+
+end:
+
+    av_log(NULL, AV_LOG_VERBOSE, "byte/time map: probed %d positions, %d points added\n", nb_probes, nb_added);
+
+    avformat_close_input(&ic);
+    av_packet_free(&pkt);
+    SDL_SemPost(map->probe_done);
+
+    return 0;
+}
+
+static void byte_time_map_close(ByteTimeMap **pmap)
+{
+    ByteTimeMap *map = *pmap;
+    if (!map)
+    {
+        return;
+    }
+
+    if (map->probe_tid)
+    {
+        map->probe_io.abort = 1;
+        if (helper_thread_join(map->probe_tid, map->probe_done, "byte/time map probe") < 0)
+        {
+            *pmap = NULL;
+            return;
+        }
+    }
+
+    if (map->nb_seeks)
+    {
+        av_log(NULL, AV_LOG_INFO,
+               "byte seeks: %d, mean error %.2fs, max error %.2fs, %d retries, %d map points (%d rejected)\n",
+               map->nb_seeks,
+               map->seek_error_sum / map->nb_seeks,
+               map->seek_error_max,
+               map->nb_retries,
+               map->nb_entries,
+               map->nb_rejected);
+    }
+
+    byte_time_map_save(map);
+
+    if (map->mutex)
+    {
+        SDL_DestroyMutex(map->mutex);
+    }
+
+    if (map->probe_done)
+    {
+        SDL_DestroySemaphore(map->probe_done);
+    }
+
+    av_freep(&map->entries);
+    av_freep(&map->cache_path);
+    av_freep(&map->filename);
+    av_freep(pmap);
+}
+
+static int byte_time_map_open(VideoState *is, AVFormatContext *ic, int stream_index)
+{
+    int64_t file_size = ic->pb ? avio_size(ic->pb) : -1;
+    if (file_size <= 0 || stream_index < 0)
+    {
+        return 0;
+    }
+
+    ByteTimeMap *map = av_mallocz(sizeof(ByteTimeMap));
+    if (!map)
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    map->file_size = file_size;
+    map->spacing = FFMAX(BYTE_TIME_MAP_MIN_SPACING, file_size / BYTE_TIME_MAP_MAX_ENTRIES);
+    map->stream_index = stream_index;
+    map->stream_id = ic->streams[stream_index]->id;
+    map->codec_id = ic->streams[stream_index]->codecpar->codec_id;
+    map->iformat = ic->iformat;
+    map->mutex = SDL_CreateMutex();
+    map->entries = av_malloc_array(BYTE_TIME_MAP_MAX_ENTRIES, sizeof(*map->entries));
+    map->filename = av_strdup(is->filename);
+
+    if (!map->mutex || !map->entries || !map->filename)
+    {
+        byte_time_map_close(&map);
+        return AVERROR(ENOMEM);
+    }
+
+    /* keyed by name and size, a changed file is unlikely to keep both */
+    char name[64];
+    snprintf(name, sizeof(name), "bytemap-%08x-%" PRId64,
+             av_crc(av_crc_get_table(AV_CRC_32_IEEE), 0, (const uint8_t *)is->filename, strlen(is->filename)),
+             file_size);
+
+    map->cache_path = cache_file_path(name);
+    if (map->cache_path)
+    {
+        byte_time_map_load(map);
+    }
+
+    /* a second open is cheap only on a seekable local file, other inputs learn the map from playback alone */
+    const char *protocol = avio_find_protocol_name(is->filename);
+    int probe = protocol && !strcmp(protocol, "file") && (ic->pb->seekable & AVIO_SEEKABLE_NORMAL);
+
+    if (probe && map->nb_entries < BYTE_TIME_MAP_PROBE_POINTS && (map->probe_done = SDL_CreateSemaphore(0)))
+    {
+        map->probe_tid = SDL_CreateThread(byte_time_map_probe_thread, "bytemap", map);
+        if (!map->probe_tid)
+        {
+            av_log(NULL, AV_LOG_WARNING, "SDL_CreateThread(): %s\n", SDL_GetError());
+        }
+    }
+
+    SDL_LockMutex(is->btmap_mutex);
+    is->btmap = map;
+    SDL_UnlockMutex(is->btmap_mutex);
+
+    return 0;
+}
+
+static int input_opener_thread(void *arg)
+{
+    InputOpener *op = arg;
+
+    AVFormatContext *ic = avformat_alloc_context();
+    if (!ic)
+    {
+        op->ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    ic->interrupt_callback.callback = helper_io_interrupt_cb;
+    ic->interrupt_callback.opaque = &op->io;
+
+    helper_io_begin(&op->io, io_open_timeout);
+    op->ret = avformat_open_input(&ic, op->filename, NULL, NULL);
+    if (op->ret < 0)
+    {
+        goto end;
+    }
+
+    if (genpts)
+    {
+        ic->flags |= AVFMT_FLAG_GENPTS;
+    }
+
+    av_format_inject_global_side_data(ic);
+
+    /* probing needs data, so success also tells a live input is flowing again */
+    if (find_stream_info)
+    {
+        helper_io_begin(&op->io, io_probe_timeout);
+        op->ret = avformat_find_stream_info(ic, NULL);
+        if (op->ret < 0)
+        {
+            goto end;
+        }
+    }
+
+    if (ic->pb)
+    {
+        ic->pb->eof_reached = 0;
+    }
+
+    op->ic = ic;
+    ic = NULL;
+
+end:
+
+    if (op->ret < 0 && !op->io.abort)
+    {
+        av_log(NULL, AV_LOG_WARNING, "input %d (%s): could not open: %s\n", op->index, op->filename, av_err2str(op->ret));
+    }
+
+    avformat_close_input(&ic);
+    SDL_SemPost(op->done);
+
+    return 0;
+}
+
+static void input_opener_free(InputOpener **pop)
+{
+    InputOpener *op = *pop;
+    if (!op)
+    {
+        return;
+    }
+
+    if (op->tid)
+    {
+        op->io.abort = 1;
+        if (helper_thread_join(op->tid, op->done, "input opener") < 0)
+        {
+            *pop = NULL;
+            return;
+        }
+    }
+
+    avformat_close_input(&op->ic);
+
+    if (op->done)
+    {
+        SDL_DestroySemaphore(op->done);
+    }
+
+    av_freep(pop);
+}
+
+static void input_opener_start(VideoState *is, int index)
+{
+    InputOpener *op = av_mallocz(sizeof(InputOpener));
+    if (!op)
+    {
+        return;
+    }
+
+    op->filename = input_filenames[index];
+    op->index = index;
+    op->done = SDL_CreateSemaphore(0);
+
+    if (op->done)
+    {
+        op->tid = SDL_CreateThread(input_opener_thread, "input_opener", op);
+    }
+
+    if (!op->tid)
+    {
+        av_log(NULL, AV_LOG_ERROR, "SDL_CreateThread(): %s\n", SDL_GetError());
+        input_opener_free(&op);
+        return;
+    }
+
+    is->opener = op;
+}
+
+static void recorder_close(Recorder **prec)
+{
+    Recorder *rec = *prec;
+    if (!rec)
+    {
+        return;
+    }
+
+    if (rec->tid)
+    {
+        /* a null packet without stream ends the muxer thread after what is queued, writes past the deadline are interrupted */
+        packet_queue_put_nullpacket(&rec->q, -1);
+        helper_io_begin(&rec->io, shutdown_timeout);
+        if (helper_thread_join(rec->tid, rec->done, "recorder") < 0)
+        {
+            *prec = NULL;
+            return;
+        }
+
+        av_log(NULL, AV_LOG_INFO,
+               "record: %" PRId64 " packets, %" PRId64 " KB written to %s, %d dropped on overflow, %d out of order\n",
+               rec->nb_written,
+               rec->bytes_written >> 10,
+               record_filename,
+               rec->nb_overflows,
+               rec->nb_late);
+    }
+
+    packet_queue_destroy(&rec->q);
+
+    if (rec->oc && !(rec->oc->oformat->flags & AVFMT_NOFILE))
+    {
+        avio_closep(&rec->oc->pb);
+    }
+
+    avformat_free_context(rec->oc);
+
+    for (int i = 0; i < AVMEDIA_TYPE_NB; i++)
+    {
+        avcodec_parameters_free(&rec->src_par[i]);
+    }
+
+    if (rec->done)
+    {
+        SDL_DestroySemaphore(rec->done);
+    }
+
+    av_freep(prec);
+}
+
+/* packets of b can go into a stream opened with a without the muxer or a decoder noticing */
+static int recorder_same_params(const AVCodecParameters *a, const AVCodecParameters *b)
+{
+    if (a->codec_id != b->codec_id || a->extradata_size != b->extradata_size ||
+        (a->extradata_size && memcmp(a->extradata, b->extradata, a->extradata_size)))
+    {
+        return 0;
+    }
+
+    switch (a->codec_type)
+    {
+    case AVMEDIA_TYPE_VIDEO:
+        return a->width == b->width && a->height == b->height && a->format == b->format;
+    case AVMEDIA_TYPE_AUDIO:
+        return a->sample_rate == b->sample_rate && a->format == b->format &&
+               a->ch_layout.nb_channels == b->ch_layout.nb_channels;
+    default:
+        return 1;
+    }
+}
+
+/* the played stream of a type changes on a stream cycle or an input failover */
+static int recorder_check_source(Recorder *rec, AVStream *st, enum AVMediaType type)
+{
+    if (st == rec->src_st[type])
+    {
+        return rec->src_match[type];
+    }
+
+    rec->src_st[type] = st;
+    rec->src_match[type] = recorder_same_params(rec->src_par[type], st->codecpar);
+
+    if (rec->src_match[type])
+    {
+        return 1;
+    }
+
+    /* audio or video from another codec would corrupt the file, end it where it is still valid */
+    if (type != AVMEDIA_TYPE_SUBTITLE)
+    {
+        av_log(NULL, AV_LOG_WARNING, "record: the played %s stream changed to %s, recording of %s stopped\n",
+               av_get_media_type_string(type), avcodec_get_name(st->codecpar->codec_id), record_filename);
+        rec->stopped = 1;
+        return 0;
+    }
+
+    av_log(NULL, AV_LOG_WARNING, "record: the played subtitle stream changed to %s, not recorded until it matches again\n",
+           avcodec_get_name(st->codecpar->codec_id));
+
+    return 0;
+}
+
+/* send a reference of a played packet to the muxer thread, never waits for it */
+static void recorder_tee(Recorder *rec, AVPacket *pkt, AVStream *st, enum AVMediaType type)
+{
+    int out = rec->out_index[type];
+    if (out < 0 || rec->stopped || !recorder_check_source(rec, st, type))
+    {
+        return;
+    }
+
+    /* after an overflow video restarts at a keyframe so the recording stays decodable */
+    if (type == AVMEDIA_TYPE_VIDEO && rec->video_wait_keyframe)
+    {
+        if (!(pkt->flags & AV_PKT_FLAG_KEY))
+        {
+            return;
+        }
+
+        rec->video_wait_keyframe = 0;
+    }
+
+    if (rec->q.size + pkt->size > RECORD_QUEUE_SIZE)
+    {
+        rec->nb_overflows++;
+        rec->video_wait_keyframe |= type == AVMEDIA_TYPE_VIDEO;
+        return;
+    }
+
+    AVPacket copy = {0};
+    if (av_packet_ref(&copy, pkt) < 0)
+    {
+        return;
+    }
+
+    copy.stream_index = out;
+    copy.time_base = st->time_base;
+
+    packet_queue_put(&rec->q, &copy);
+}
+
+static int recorder_thread(void *arg)
+{
+    Recorder *rec = arg;
+    AVFormatContext *oc = rec->oc;
+    AVPacket pkt1, *pkt = &pkt1;
+    int serial = -1, last_serial = -1;
+
+    int ret = 0;
+    helper_io_begin(&rec->io, io_open_timeout);
+    if (!(oc->oformat->flags & AVFMT_NOFILE))
+    {
+        ret = avio_open2(&oc->pb, record_filename, AVIO_FLAG_WRITE, &oc->interrupt_callback, NULL);
+    }
+
+    if (ret >= 0)
+    {
+        ret = avformat_write_header(oc, NULL);
+    }
+
+    /* muxing has no deadline until recorder_close sets one */
+    helper_io_begin(&rec->io, 0);
+
+    if (ret < 0)
+    {
+        av_log(NULL, AV_LOG_ERROR, "record: cannot start %s: %s\n", record_filename, av_err2str(ret));
+    }
+
+    int started = ret >= 0;
+
+    while (packet_queue_get(&rec->q, pkt, 1, &serial) > 0)
+    {
+        if (pkt->data == flush_pkt.data)
+        {
+            continue;
+        }
+
+        if (pkt->stream_index < 0)
+        {
+            break;
+        }
+
+        if (!started)
+        {
+            av_packet_unref(pkt);
+            continue;
+        }
+
+        /* a seek or input switch starts a new serial, shift it to continue where the recording is */
+        int64_t ts = pkt->dts != AV_NOPTS_VALUE ? pkt->dts : pkt->pts;
+        if (serial != last_serial && ts != AV_NOPTS_VALUE)
+        {
+            int64_t first = av_rescale_q(ts, pkt->time_base, AV_TIME_BASE_Q);
+            rec->ts_offset = rec->end_ts != AV_NOPTS_VALUE ? rec->end_ts - first : -first;
+            last_serial = serial;
+        }
+
+        AVStream *st = oc->streams[pkt->stream_index];
+        int64_t offset = av_rescale_q(rec->ts_offset, AV_TIME_BASE_Q, pkt->time_base);
+
+        if (pkt->pts != AV_NOPTS_VALUE)
+        {
+            pkt->pts += offset;
+        }
+
+        if (pkt->dts != AV_NOPTS_VALUE)
+        {
+            pkt->dts += offset;
+        }
+
+        av_packet_rescale_ts(pkt, pkt->time_base, st->time_base);
+        pkt->time_base = st->time_base;
+
+        /* streams of the new serial may start slightly before the shift point */
+        if (pkt->dts != AV_NOPTS_VALUE && rec->last_dts[pkt->stream_index] != AV_NOPTS_VALUE && pkt->dts <= rec->last_dts[pkt->stream_index])
+        {
+            rec->nb_late++;
+            av_packet_unref(pkt);
+            continue;
+        }
+
+        if (pkt->dts != AV_NOPTS_VALUE)
+        {
+            int64_t end = av_rescale_q(pkt->dts + pkt->duration, st->time_base, AV_TIME_BASE_Q);
+
+            rec->last_dts[pkt->stream_index] = pkt->dts;
+            rec->end_ts = rec->end_ts == AV_NOPTS_VALUE ? end : FFMAX(rec->end_ts, end);
+        }
+
+        int size = pkt->size;
+
+        ret = av_interleaved_write_frame(oc, pkt);
+        if (ret < 0)
+        {
+            av_log(NULL, AV_LOG_ERROR, "record: write error: %s, recording stopped\n", av_err2str(ret));
+            started = 0;
+            continue;
+        }
+
+        rec->nb_written++;
+        rec->bytes_written += size;
+    }
+
+    if (started)
+    {
+        av_write_trailer(oc);
+    }
+
+    SDL_SemPost(rec->done);
+
+    return 0;
+}
+
+/* mux the played audio, video and subtitle streams into record_filename without transcoding */
+static int recorder_open(VideoState *is)
+{
+    Recorder *rec = av_mallocz(sizeof(Recorder));
+    if (!rec)
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    rec->end_ts = AV_NOPTS_VALUE;
+    rec->video_wait_keyframe = 1;
+
+    for (int i = 0; i < AVMEDIA_TYPE_NB; i++)
+    {
+        rec->out_index[i] = -1;
+    }
+
+    for (size_t i = 0; i < FF_ARRAY_ELEMS(rec->last_dts); i++)
+    {
+        rec->last_dts[i] = AV_NOPTS_VALUE;
+    }
+
+    int ret = packet_queue_init(&rec->q);
+    if (ret < 0)
+    {
+        goto fail;
+    }
+
+    ret = avformat_alloc_output_context2(&rec->oc, NULL, NULL, record_filename);
+    if (ret < 0)
+    {
+        av_log(NULL, AV_LOG_ERROR, "record: no muxer for %s\n", record_filename);
+        goto fail;
+    }
+
+    rec->oc->interrupt_callback.callback = helper_io_interrupt_cb;
+    rec->oc->interrupt_callback.opaque = &rec->io;
+
+    AVStream *selected[] = {is->audio_st, is->video_st, is->subtitle_st};
+
+    for (size_t i = 0; i < FF_ARRAY_ELEMS(selected); i++)
+    {
+        AVStream *in = selected[i];
+        if (!in || (in->disposition & AV_DISPOSITION_ATTACHED_PIC))
+        {
+            continue;
+        }
+
+        /* a subtitle format the muxer cannot store would fail the header, record without it */
+        enum AVMediaType type = in->codecpar->codec_type;
+        if (type == AVMEDIA_TYPE_SUBTITLE && avformat_query_codec(rec->oc->oformat, in->codecpar->codec_id, FF_COMPLIANCE_NORMAL) == 0)
+        {
+            av_log(NULL, AV_LOG_WARNING, "record: %s subtitles cannot be stored in %s, recording without them\n",
+                   avcodec_get_name(in->codecpar->codec_id), rec->oc->oformat->name);
+            continue;
+        }
+
+        AVStream *out = avformat_new_stream(rec->oc, NULL);
+        if (!out)
+        {
+            ret = AVERROR(ENOMEM);
+            goto fail;
+        }
+
+        if ((ret = avcodec_parameters_copy(out->codecpar, in->codecpar)) < 0)
+        {
+            goto fail;
+        }
+
+        out->codecpar->codec_tag = 0;
+        out->time_base = in->time_base;
+
+        if (!(rec->src_par[type] = avcodec_parameters_alloc()))
+        {
+            ret = AVERROR(ENOMEM);
+            goto fail;
+        }
+
+        if ((ret = avcodec_parameters_copy(rec->src_par[type], in->codecpar)) < 0)
+        {
+            goto fail;
+        }
+
+        rec->src_st[type] = in;
+        rec->src_match[type] = 1;
+        rec->out_index[type] = out->index;
+    }
+
+    packet_queue_start(&rec->q);
+
+    if (!(rec->done = SDL_CreateSemaphore(0)))
+    {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    rec->tid = SDL_CreateThread(recorder_thread, "recorder", rec);
+    if (!rec->tid)
+    {
+        av_log(NULL, AV_LOG_ERROR, "SDL_CreateThread(): %s\n", SDL_GetError());
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    is->rec = rec;
+
+    return 0;
+
+fail:
+
+    recorder_close(&rec);
+
+    return ret;
+}
+
+/* index of the selected audio stream in the main input, -1 when a sidecar feeds audioq */
+static int main_audio_stream(VideoState *is)
+{
+    return is->audio_sidecar ? -1 : is->audio_stream;
+}
+
+static int main_subtitle_stream(VideoState *is)
+{
+    return is->subtitle_sidecar ? -1 : is->subtitle_stream;
+}
+
+static int stream_has_enough_packets(AVStream *st, int stream_id, PacketQueue *queue)
+{
+    return stream_id < 0 ||
+           queue->abort_request ||
+           (st->disposition & AV_DISPOSITION_ATTACHED_PIC) ||
+           queue->nb_packets > MIN_FRAMES && (!queue->duration || av_q2d(st->time_base) * queue->duration > 1.0);
+}
+
+static int stream_queues_full(VideoState *is)
+{
+    return infinite_buffer < 1 &&
+           (is->audioq.size + is->videoq.size + is->subtitleq.size > MAX_QUEUE_SIZE ||
+            (stream_has_enough_packets(is->audio_st, is->audio_stream, &is->audioq) &&
+             stream_has_enough_packets(is->video_st, is->video_stream, &is->videoq) &&
+             stream_has_enough_packets(is->subtitle_st, is->subtitle_stream, &is->subtitleq)));
+}
+
+/* drop queued packets and start a new serial, frames and clocks of the old one are discarded downstream */
+static void stream_flush_queues(VideoState *is)
+{
+    if (is->audio_stream >= 0)
+    {
+        packet_queue_flush(&is->audioq);
+        packet_queue_put(&is->audioq, &flush_pkt);
+    }
+
+    if (is->subtitle_stream >= 0)
+    {
+        packet_queue_flush(&is->subtitleq);
+        packet_queue_put(&is->subtitleq, &flush_pkt);
+    }
+
+    if (is->video_stream >= 0)
+    {
+        packet_queue_flush(&is->videoq);
+        packet_queue_put(&is->videoq, &flush_pkt);
+    }
+}
+
+/* push null packets so the decoders drain, sidecars end their queues themselves */
+static void stream_queue_eof(VideoState *is)
+{
+    if (is->video_stream >= 0)
+    {
+        packet_queue_put_nullpacket(&is->videoq, is->video_stream);
+    }
+
+    if (main_audio_stream(is) >= 0)
+    {
+        packet_queue_put_nullpacket(&is->audioq, is->audio_stream);
+    }
+
+    if (main_subtitle_stream(is) >= 0)
+    {
+        packet_queue_put_nullpacket(&is->subtitleq, is->subtitle_stream);
+    }
+}
+
+#if HAVE_MMAP_IO
+static void timeshift_index_prune(TimeshiftRing *ts)
+{
+    while (ts->nb_index && ts->index[ts->index_start].offset < ts->tail)
+    {
+        ts->index_start = (ts->index_start + 1) % TIMESHIFT_MAX_INDEX;
+        ts->nb_index--;
+    }
+}
+
+static TimeshiftIndexEntry *timeshift_index_at(TimeshiftRing *ts, int i)
+{
+    return &ts->index[(ts->index_start + i) % TIMESHIFT_MAX_INDEX];
+}
+
+/* reclaim whole segments until n more bytes fit, a reader left behind jumps to the oldest keyframe */
+static void timeshift_make_room(TimeshiftRing *ts, int64_t n, int64_t next_record)
+{
+    while (ts->head + n - ts->tail > ts->size)
+    {
+        ts->tail += TIMESHIFT_SEGMENT_SIZE;
+        timeshift_index_prune(ts);
+
+        if (ts->read_pos < ts->tail)
+        {
+            int64_t pos = ts->nb_index ? timeshift_index_at(ts, 0)->offset : next_record;
+
+            ts->nb_overruns++;
+            ts->bytes_lost += pos - ts->read_pos;
+            ts->read_pos = pos;
+            ts->flush_req = 1;
+        }
+    }
+}
+
+static void timeshift_write(TimeshiftRing *ts, AVPacket *pkt, AVRational tb)
+{
+    int64_t rec_size = FFALIGN(sizeof(TimeshiftRecord) + pkt->size, 8);
+    if (rec_size > TIMESHIFT_SEGMENT_SIZE)
+    {
+        av_log(NULL, AV_LOG_WARNING, "timeshift: dropping a %d bytes packet\n", pkt->size);
+        return;
+    }
+
+    int64_t t0 = av_gettime_relative();
+
+    SDL_LockMutex(ts->mutex);
+
+    /* records never wrap, the rest of the ring is skipped instead */
+    int64_t phys = ts->head % ts->size;
+    int64_t pad = phys + rec_size > ts->size ? ts->size - phys : 0;
+
+    timeshift_make_room(ts, pad + rec_size, ts->head + pad);
+
+    if (pad)
+    {
+        if (pad >= (int64_t)sizeof(TimeshiftRecord))
+        {
+            ((TimeshiftRecord *)(ts->data + phys))->size = -1;
+        }
+
+        ts->head += pad;
+        phys = 0;
+    }
+
+    /* the input delivers again, its end is still to come */
+    ts->source_eof = 0;
+    ts->eof_queued = 0;
+
+    TimeshiftRecord *rec = (TimeshiftRecord *)(ts->data + phys);
+    rec->size = pkt->size;
+    rec->stream_index = pkt->stream_index;
+    rec->flags = pkt->flags;
+    rec->reserved = 0;
+    rec->pts = pkt->pts;
+    rec->dts = pkt->dts;
+    rec->duration = pkt->duration;
+    rec->pos = pkt->pos;
+    memcpy(rec + 1, pkt->data, pkt->size);
+
+    int64_t pkt_ts = pkt->dts != AV_NOPTS_VALUE ? pkt->dts : pkt->pts;
+    if (pkt->stream_index == ts->index_stream && pkt_ts != AV_NOPTS_VALUE)
+    {
+        ts->last_ts = av_rescale_q(pkt_ts, tb, AV_TIME_BASE_Q);
+
+        if (pkt->flags & AV_PKT_FLAG_KEY)
+        {
+            if (ts->nb_index == TIMESHIFT_MAX_INDEX)
+            {
+                ts->index_start = (ts->index_start + 1) % TIMESHIFT_MAX_INDEX;
+                ts->nb_index--;
+            }
+
+            TimeshiftIndexEntry *e = timeshift_index_at(ts, ts->nb_index++);
+            e->offset = ts->head;
+            e->ts = ts->last_ts;
+        }
+    }
+
+    int64_t seg_end = (ts->head / TIMESHIFT_SEGMENT_SIZE + 1) * TIMESHIFT_SEGMENT_SIZE;
+    ts->head += rec_size;
+
+    /* a finished segment the feeder will not need soon goes back to the page cache */
+    if (ts->head >= seg_end && ts->read_pos < seg_end - TIMESHIFT_SEGMENT_SIZE)
+    {
+        madvise(ts->data + (seg_end - TIMESHIFT_SEGMENT_SIZE) % ts->size, TIMESHIFT_SEGMENT_SIZE, MADV_DONTNEED);
+    }
+
+    SDL_CondSignal(ts->cond);
+    SDL_UnlockMutex(ts->mutex);
+
+    ts->bytes_written += rec_size;
+    ts->write_time += av_gettime_relative() - t0;
+}
+
+/* move the feeder to the last keyframe at or before ts, the oldest one if ts is no longer in the ring */
+static int timeshift_seek(VideoState *is, int64_t target)
+{
+    TimeshiftRing *ts = is->tshift;
+    int ret = 0;
+
+    SDL_LockMutex(ts->mutex);
+
+    if (!ts->nb_index)
+    {
+        ret = AVERROR(EAGAIN);
+    }
+    else
+    {
+        int i = ts->nb_index - 1;
+        while (i > 0 && timeshift_index_at(ts, i)->ts > target)
+        {
+            i--;
+        }
+
+        ts->read_pos = timeshift_index_at(ts, i)->offset;
+        ts->flush_req = 0;
+        ts->eof_queued = 0;
+        stream_flush_queues(is);
+    }
+
+    SDL_UnlockMutex(ts->mutex);
+
+    return ret;
+}
+
+/* takes packets out of the ring into the decoder queues, at the pace the decoders consume them */
+static int timeshift_feeder(void *arg)
+{
+    VideoState *is = arg;
+    TimeshiftRing *ts = is->tshift;
+
+    AVPacket *pkt = av_packet_alloc();
+    if (!pkt)
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    SDL_LockMutex(ts->mutex);
+
+    while (!ts->abort)
+    {
+        if (ts->flush_req)
+        {
+            ts->flush_req = 0;
+            ts->eof_queued = 0;
+            stream_flush_queues(is);
+        }
+
+        /* the ring is played out after the end of the input, drain the decoders so loop and autoexit see the end */
+        if (ts->read_pos >= ts->head && ts->source_eof && !ts->eof_queued)
+        {
+            stream_queue_eof(is);
+            ts->eof_queued = 1;
+        }
+
+        if (ts->read_pos >= ts->head || stream_queues_full(is))
+        {
+            SDL_CondWaitTimeout(ts->cond, ts->mutex, 10);
+            continue;
+        }
+
+        int64_t phys = ts->read_pos % ts->size;
+        TimeshiftRecord *rec = (TimeshiftRecord *)(ts->data + phys);
+
+        if (ts->size - phys < (int64_t)sizeof(TimeshiftRecord) || rec->size < 0)
+        {
+            ts->read_pos += ts->size - phys;
+            continue;
+        }
+
+        int64_t seg = ts->read_pos / TIMESHIFT_SEGMENT_SIZE;
+        ts->read_pos += FFALIGN(sizeof(TimeshiftRecord) + rec->size, 8);
+
+        if (ts->read_pos / TIMESHIFT_SEGMENT_SIZE != seg)
+        {
+            madvise(ts->data + (seg * TIMESHIFT_SEGMENT_SIZE) % ts->size, TIMESHIFT_SEGMENT_SIZE, MADV_DONTNEED);
+        }
+
+        PacketQueue *q = rec->stream_index == main_audio_stream(is) ? &is->audioq : rec->stream_index == is->video_stream        ? &is->videoq
+                                                                                : rec->stream_index == main_subtitle_stream(is) ? &is->subtitleq
+                                                                                                                                : NULL;
+        if (!q || av_new_packet(pkt, rec->size) < 0)
+        {
+            continue;
+        }
+
+        memcpy(pkt->data, rec + 1, rec->size);
+        pkt->stream_index = rec->stream_index;
+        pkt->flags = rec->flags;
+        pkt->pts = rec->pts;
+        pkt->dts = rec->dts;
+        pkt->duration = rec->duration;
+        pkt->pos = rec->pos;
+
+        packet_queue_put(q, pkt);
+    }
+
+    SDL_UnlockMutex(ts->mutex);
+
+    av_packet_free(&pkt);
+    SDL_SemPost(ts->feeder_done);
+
+    return 0;
+}
+
+/* page cache holding ring data, reclaimable by the kernel */
+static int64_t timeshift_cached_bytes(TimeshiftRing *ts)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    size_t nb_pages = (ts->size + page - 1) / page;
+    int64_t cached = 0;
+
+    unsigned char *vec = av_malloc(nb_pages);
+    if (vec && !mincore(ts->data, ts->size, vec))
+    {
+        for (size_t i = 0; i < nb_pages; i++)
+        {
+            cached += vec[i] & 1;
+        }
+    }
+
+    av_free(vec);
+
+    return cached * page;
+}
+
+/* AVERROR(ETIMEDOUT) when the feeder was abandoned, it still uses the ring and the decoder queues */
+static int timeshift_close(TimeshiftRing **pts)
+{
+    TimeshiftRing *ts = *pts;
+    if (!ts)
+    {
+        return 0;
+    }
+
+    if (ts->feeder_tid)
+    {
+        SDL_LockMutex(ts->mutex);
+        ts->abort = 1;
+        SDL_CondSignal(ts->cond);
+        SDL_UnlockMutex(ts->mutex);
+
+        if (helper_thread_join(ts->feeder_tid, ts->feeder_done, "timeshift feeder") < 0)
+        {
+            *pts = NULL;
+            return AVERROR(ETIMEDOUT);
+        }
+    }
+
+    if (ts->bytes_written)
+    {
+        double elapsed = (av_gettime_relative() - ts->start_time) / 1000000.0;
+
+        av_log(NULL, AV_LOG_INFO,
+               "timeshift: %" PRId64 " MB written, %.2f MB/s average, %.0f MB/s copy speed, %d overruns (%" PRId64 " KB lost)\n",
+               ts->bytes_written >> 20,
+               elapsed > 0 ? ts->bytes_written / elapsed / (1 << 20) : 0,
+               ts->write_time > 0 ? ts->bytes_written / (ts->write_time / 1000000.0) / (1 << 20) : 0,
+               ts->nb_overruns,
+               ts->bytes_lost >> 10);
+    }
+
+    if (ts->data)
+    {
+        munmap(ts->data, ts->size);
+    }
+
+    if (ts->fd >= 0)
+    {
+        close(ts->fd);
+    }
+
+    if (ts->cond)
+    {
+        SDL_DestroyCond(ts->cond);
+    }
+
+    if (ts->mutex)
+    {
+        SDL_DestroyMutex(ts->mutex);
+    }
+
+    if (ts->feeder_done)
+    {
+        SDL_DestroySemaphore(ts->feeder_done);
+    }
+
+    av_freep(pts);
+
+    return 0;
+}
+
+static int timeshift_open(VideoState *is)
+{
+    TimeshiftRing *ts = av_mallocz(sizeof(TimeshiftRing));
+    if (!ts)
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    ts->fd = -1;
+    ts->size = FFMAX(timeshift_size / TIMESHIFT_SEGMENT_SIZE, 4) * TIMESHIFT_SEGMENT_SIZE;
+    ts->index_stream = is->video_stream >= 0 ? is->video_stream : main_audio_stream(is);
+    ts->last_ts = AV_NOPTS_VALUE;
+    ts->start_time = ts->last_report = av_gettime_relative();
+
+    const char *dir = timeshift_dir ? timeshift_dir : getenv("TMPDIR");
+    char *path = av_asprintf("%s/ffplayer-timeshift-XXXXXX", dir ? dir : "/tmp");
+    if (!path)
+    {
+        timeshift_close(&ts);
+        return AVERROR(ENOMEM);
+    }
+
+    /* the file only lives as long as the mapping */
+    ts->fd = mkstemp(path);
+    if (ts->fd >= 0)
+    {
+        unlink(path);
+    }
+
+    if (ts->fd < 0 || ftruncate(ts->fd, ts->size) < 0)
+    {
+        int err = errno;
+        av_log(NULL, AV_LOG_ERROR, "timeshift: cannot create %s: %s\n", path, strerror(err));
+        av_free(path);
+        timeshift_close(&ts);
+        return AVERROR(err);
+    }
+
+    ts->data = mmap(NULL, ts->size, PROT_READ | PROT_WRITE, MAP_SHARED, ts->fd, 0);
+    if (ts->data == MAP_FAILED)
+    {
+        int err = errno;
+        av_log(NULL, AV_LOG_ERROR, "timeshift: mmap failed: %s\n", strerror(err));
+        ts->data = NULL;
+        av_free(path);
+        timeshift_close(&ts);
+        return AVERROR(err);
+    }
+
+    ts->mutex = SDL_CreateMutex();
+    ts->cond = SDL_CreateCond();
+    ts->feeder_done = SDL_CreateSemaphore(0);
+    if (!ts->mutex || !ts->cond || !ts->feeder_done)
+    {
+        av_free(path);
+        timeshift_close(&ts);
+        return AVERROR(ENOMEM);
+    }
+
+    is->tshift = ts;
+
+    ts->feeder_tid = SDL_CreateThread(timeshift_feeder, "timeshift_feeder", is);
+    if (!ts->feeder_tid)
+    {
+        av_log(NULL, AV_LOG_ERROR, "SDL_CreateThread(): %s\n", SDL_GetError());
+        av_free(path);
+        timeshift_close(&is->tshift);
+        return AVERROR(ENOMEM);
+    }
+
+    av_log(NULL, AV_LOG_INFO, "timeshift: %" PRId64 " MB ring in %s\n", ts->size >> 20, path);
+    av_free(path);
+
+    return 0;
+}
+#endif
+
+/* start of the play range in AV_TIME_BASE, including the stream start time */
+static int64_t play_range_start(AVFormatContext *ic)
+{
+    int64_t timestamp = start_time != AV_NOPTS_VALUE ? start_time : 0;
+
+    /* add the stream start time */
+    if (ic->start_time != AV_NOPTS_VALUE)
+    {
+        timestamp += ic->start_time;
+    }
+
+    return timestamp;
+}
+
+/* position of a packet timestamp relative to the start of the play range, in seconds */
+static double play_range_offset(AVFormatContext *ic, AVPacket *pkt, int64_t ts)
+{
+    int64_t stream_start_time = ic->streams[pkt->stream_index]->start_time;
+
+    return (ts - (stream_start_time != AV_NOPTS_VALUE ? stream_start_time : 0)) * av_q2d(ic->streams[pkt->stream_index]->time_base) -
+           (double)(start_time != AV_NOPTS_VALUE ? start_time : 0) / 1000000;
+}
+
+static int sidecar_interrupt_cb(void *ctx)
+{
+    Sidecar *sc = ctx;
+    return sc->is->abort_request || helper_io_interrupt_cb(&sc->io);
+}
+
+/* demuxes one sidecar input into audioq or subtitleq, shifted onto the main input timeline */
+static int sidecar_thread(void *arg)
+{
+    Sidecar *sc = arg;
+    VideoState *is = sc->is;
+
+    PacketQueue *q = sc->type == AVMEDIA_TYPE_AUDIO ? &is->audioq : &is->subtitleq;
+    AVStream *st = sc->ic->streams[sc->stream_index];
+    int64_t offset = av_rescale_q(sc->ts_offset, AV_TIME_BASE_Q, st->time_base);
+
+    AVPacket *pkt = av_packet_alloc();
+    if (!pkt)
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    while (!is->abort_request)
+    {
+        SDL_LockMutex(sc->mutex);
+
+        if (sc->seek_req)
+        {
+            int64_t target = sc->seek_pos;
+
+            sc->seek_req = 0;
+            sc->eof = 0;
+            SDL_UnlockMutex(sc->mutex);
+
+            helper_io_begin(&sc->io, io_seek_timeout);
+            if (avformat_seek_file(sc->ic, -1, INT64_MIN, target, INT64_MAX, 0) < 0)
+            {
+                av_log(NULL, AV_LOG_WARNING, "%s: error while seeking\n", sc->filename);
+            }
+
+            continue;
+        }
+
+        if (sc->eof || stream_has_enough_packets(st, sc->stream_index, q))
+        {
+            SDL_CondWaitTimeout(sc->cond, sc->mutex, 10);
+            SDL_UnlockMutex(sc->mutex);
+            continue;
+        }
+
+        SDL_UnlockMutex(sc->mutex);
+
+        /* reading happens outside the lock, a slow sidecar never holds up a seek */
+        helper_io_begin(&sc->io, io_read_timeout);
+        int ret = av_read_frame(sc->ic, pkt);
+
+        SDL_LockMutex(sc->mutex);
+
+        if (ret < 0)
+        {
+            if ((ret == AVERROR_EOF || (sc->ic->pb && avio_feof(sc->ic->pb))) && !sc->seek_req)
+            {
+                packet_queue_put_nullpacket(q, sc->stream_index);
+                sc->eof = 1;
+            }
+            else
+            {
+                SDL_CondWaitTimeout(sc->cond, sc->mutex, 10);
+            }
+        }
+        else if (pkt->stream_index == sc->stream_index && !sc->seek_req)
+        {
+            int64_t ts = pkt->dts != AV_NOPTS_VALUE ? pkt->dts : pkt->pts;
+
+            /* the sidecar starts where the main input starts, so the play range applies as is */
+            if (duration != AV_NOPTS_VALUE && ts != AV_NOPTS_VALUE && play_range_offset(sc->ic, pkt, ts) > (double)duration / 1000000)
+            {
+                av_packet_unref(pkt);
+                packet_queue_put_nullpacket(q, sc->stream_index);
+                sc->eof = 1;
+                SDL_UnlockMutex(sc->mutex);
+                continue;
+            }
+
+            /* a pending seek means the queue is being flushed, this packet belongs to the old position */
+            if (pkt->pts != AV_NOPTS_VALUE)
+            {
+                pkt->pts += offset;
+            }
+
+            if (pkt->dts != AV_NOPTS_VALUE)
+            {
+                pkt->dts += offset;
+            }
+
+            packet_queue_put(q, pkt);
+        }
+        else
+        {
+            av_packet_unref(pkt);
+        }
+
+        SDL_UnlockMutex(sc->mutex);
+    }
+
+    av_packet_free(&pkt);
+    SDL_SemPost(sc->done);
+
+    return 0;
+}
+
+/* hold every sidecar between a seek request and the flush of the queues it feeds */
+static void sidecars_lock(VideoState *is)
+{
+    for (int i = 0; i < is->nb_sidecars; i++)
+    {
+        SDL_LockMutex(is->sidecars[i]->mutex);
+    }
+}
+
+static void sidecars_unlock(VideoState *is)
+{
+    for (int i = is->nb_sidecars - 1; i >= 0; i--)
+    {
+        SDL_UnlockMutex(is->sidecars[i]->mutex);
+    }
+}
+
+/* called with the sidecars locked, timestamp on the main input timeline in AV_TIME_BASE units */
+static void sidecars_seek(VideoState *is, int64_t timestamp)
+{
+    for (int i = 0; i < is->nb_sidecars; i++)
+    {
+        Sidecar *sc = is->sidecars[i];
+
+        sc->seek_pos = timestamp - sc->ts_offset;
+        sc->seek_req = 1;
+        SDL_CondSignal(sc->cond);
+    }
+}
+
+/* AVERROR(ETIMEDOUT) when a sidecar thread was abandoned, it still feeds the decoder queues */
+static int sidecars_stop(VideoState *is)
+{
+    int ret = 0;
+
+    for (int i = 0; i < is->nb_sidecars; i++)
+    {
+        Sidecar *sc = is->sidecars[i];
+
+        if (sc->tid)
+        {
+            sc->io.abort = 1;
+            SDL_CondSignal(sc->cond);
+            if (helper_thread_join(sc->tid, sc->done, "sidecar") < 0)
+            {
+                ret = AVERROR(ETIMEDOUT);
+            }
+
+            sc->tid = NULL;
+        }
+    }
+
+    return ret;
+}
+
+static void sidecar_free(Sidecar **psc)
+{
+    Sidecar *sc = *psc;
+
+    avformat_close_input(&sc->ic);
+
+    if (sc->done)
+    {
+        SDL_DestroySemaphore(sc->done);
+    }
+
+    if (sc->cond)
+    {
+        SDL_DestroyCond(sc->cond);
+    }
+
+    if (sc->mutex)
+    {
+        SDL_DestroyMutex(sc->mutex);
+    }
+
+    av_freep(psc);
+}
+
+static void sidecars_free(VideoState *is)
+{
+    for (int i = 0; i < is->nb_sidecars; i++)
+    {
+        sidecar_free(&is->sidecars[i]);
+    }
+
+    is->nb_sidecars = 0;
+    is->audio_sidecar = NULL;
+    is->subtitle_sidecar = NULL;
+}
+
+/* open a sidecar and pick its audio stream, or its subtitle stream if it has no audio */
+static int sidecar_open(VideoState *is, AVFormatContext *main_ic, const char *filename)
+{
+    Sidecar *sc = av_mallocz(sizeof(Sidecar));
+    if (!sc)
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    sc->is = is;
+    sc->filename = filename;
+    sc->mutex = SDL_CreateMutex();
+    sc->cond = SDL_CreateCond();
+    sc->done = SDL_CreateSemaphore(0);
+    sc->ic = avformat_alloc_context();
+
+    int ret = AVERROR(ENOMEM);
+    if (!sc->mutex || !sc->cond || !sc->done || !sc->ic)
+    {
+        goto fail;
+    }
+
+    sc->ic->interrupt_callback.callback = sidecar_interrupt_cb;
+    sc->ic->interrupt_callback.opaque = sc;
+
+    helper_io_begin(&sc->io, io_open_timeout);
+    if ((ret = avformat_open_input(&sc->ic, filename, NULL, NULL)) < 0)
+    {
+        av_log(NULL, AV_LOG_ERROR, "sidecar %s: could not open: %s\n", filename, av_err2str(ret));
+        goto fail;
+    }
+
+    helper_io_begin(&sc->io, io_probe_timeout);
+    if (find_stream_info && (ret = avformat_find_stream_info(sc->ic, NULL)) < 0)
+    {
+        av_log(NULL, AV_LOG_WARNING, "sidecar %s: could not find codec parameters\n", filename);
+        goto fail;
+    }
+
+    sc->type = AVMEDIA_TYPE_AUDIO;
+    sc->stream_index = av_find_best_stream(sc->ic, AVMEDIA_TYPE_AUDIO, -1, -1, NULL, 0);
+
+    if (sc->stream_index < 0)
+    {
+        sc->type = AVMEDIA_TYPE_SUBTITLE;
+        sc->stream_index = av_find_best_stream(sc->ic, AVMEDIA_TYPE_SUBTITLE, -1, -1, NULL, 0);
+    }
+
+    Sidecar **slot = sc->type == AVMEDIA_TYPE_AUDIO ? &is->audio_sidecar : &is->subtitle_sidecar;
+
+    if (sc->stream_index < 0 || *slot)
+    {
+        av_log(NULL, AV_LOG_WARNING, "sidecar %s: no audio or subtitle stream left to use\n", filename);
+        ret = AVERROR_STREAM_NOT_FOUND;
+        goto fail;
+    }
+
+    for (int i = 0; i < (int)sc->ic->nb_streams; i++)
+    {
+        sc->ic->streams[i]->discard = i == sc->stream_index ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+
+    /* both inputs start at the same moment */
+    sc->ts_offset = (main_ic->start_time != AV_NOPTS_VALUE ? main_ic->start_time : 0) -
+                    (sc->ic->start_time != AV_NOPTS_VALUE ? sc->ic->start_time : 0);
+
+    *slot = sc;
+    is->sidecars[is->nb_sidecars++] = sc;
+
+    av_log(NULL, AV_LOG_INFO, "sidecar %s: %s stream #%d, offset %.3fs\n",
+           filename, av_get_media_type_string(sc->type), sc->stream_index, sc->ts_offset / (double)AV_TIME_BASE);
+
+    return 0;
+
+fail:
+
+    sidecar_free(&sc);
+
+    return ret;
+}
+
+static void sample_ring_write(SampleRing *ring, const int16_t *samples, int channels, int nb_frames)
+{
+    if (ring->channels != channels)
+    {
+        return;
+    }
+
+    unsigned int end = (unsigned int)SDL_AtomicGet(&ring->write) + nb_frames;
+
+    /* only the newest frames fit */
+    if (nb_frames > VIS_RING_FRAMES)
+    {
+        samples += (nb_frames - VIS_RING_FRAMES) * channels;
+        nb_frames = VIS_RING_FRAMES;
+    }
+
+    for (int i = 0; i < nb_frames;)
+    {
+        int idx = (end - nb_frames + i) & (VIS_RING_FRAMES - 1);
+        int n = FFMIN(nb_frames - i, VIS_RING_FRAMES - idx);
+
+        memcpy(ring->samples + idx * channels, samples + i * channels, n * channels * sizeof(*samples));
+        i += n;
+    }
+
+    /* the samples before the position that publishes them */
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&ring->write, end);
+}
+
+static void sample_ring_read(const SampleRing *ring, int16_t *dst, unsigned int end, int nb_frames)
+{
+    for (int i = 0; i < nb_frames;)
+    {
+        int idx = (end - nb_frames + i) & (VIS_RING_FRAMES - 1);
+        int n = FFMIN(nb_frames - i, VIS_RING_FRAMES - idx);
+
+        memcpy(dst + i * ring->channels, ring->samples + idx * ring->channels, n * ring->channels * sizeof(*dst));
+        i += n;
+    }
+}
+
+static void sample_ring_free(SampleRing **pring)
+{
+    if (*pring)
+    {
+        av_freep(&(*pring)->samples);
+        av_freep(pring);
+    }
+}
+
+/* a ring for the current output format, installed with the audio callback locked out */
+static int audio_vis_ring_alloc(VideoState *is, AudioVis *vis)
+{
+    int channels = is->audio_tgt.ch_layout.nb_channels;
+
+    if (vis->ring && vis->ring->channels == channels)
+    {
+        return 0;
+    }
+
+    if (!channels)
+    {
+        return AVERROR(EINVAL);
+    }
+
+    SampleRing *ring = av_mallocz(sizeof(*ring));
+    if (!ring || !(ring->samples = av_calloc(VIS_RING_FRAMES * channels, sizeof(*ring->samples))))
+    {
+        av_free(ring);
+        return AVERROR(ENOMEM);
+    }
+
+    ring->channels = channels;
+
+    SampleRing *old = vis->ring;
+    SDL_LockAudioDevice(audio_dev);
+    vis->ring = ring;
+    SDL_UnlockAudioDevice(audio_dev);
+
+    sample_ring_free(&old);
+
+    return 0;
+}
+
+static void audio_vis_free(AudioVis *vis)
+{
+    SampleRing *ring = vis->ring;
+
+    SDL_LockAudioDevice(audio_dev);
+    vis->ring = NULL;
+    SDL_UnlockAudioDevice(audio_dev);
+
+    sample_ring_free(&ring);
+
+    av_tx_uninit(&vis->tx);
+    av_freep(&vis->tx_in);
+    av_freep(&vis->tx_out);
+    av_freep(&vis->window);
+    av_freep(&vis->points);
+
+    if (vis->texture)
+    {
+        SDL_DestroyTexture(vis->texture);
+    }
+
+    memset(vis, 0, sizeof(*vis));
+}
+
+/* ring position of the frame being heard now, at least min_delay frames behind the newest */
+static unsigned int audio_vis_play_end(VideoState *is, SampleRing *ring, int min_delay)
+{
+    unsigned int end = SDL_AtomicGet(&ring->write);
+    SDL_MemoryBarrierAcquire();
+
+    /* what the audio clock assumes: two hardware periods and the rest of audio_buf are still to be played */
+    int delay = (2 * is->audio_hw_buf_size + is->audio_write_buf_size) / is->audio_tgt.frame_size;
+    delay -= (av_gettime_relative() - audio_callback_time) * is->audio_tgt.freq / 1000000;
+
+    return end - av_clip(delay, min_delay, VIS_RING_FRAMES / 2);
+}
+
+/* one line per channel over the width, starting at a rising zero crossing so periodic waves stand still */
+static void audio_vis_waves(VideoState *is, AudioVis *vis, unsigned int play)
+{
+    const int search = 1000;
+    int ch = vis->ring->channels, w = is->width, band = is->height / ch;
+
+    av_fast_malloc(&vis->window, &vis->window_size, (w + search) * ch * sizeof(*vis->window));
+    av_fast_malloc(&vis->points, &vis->points_size, w * sizeof(*vis->points));
+    if (!vis->window || !vis->points)
+    {
+        return;
+    }
+
+    sample_ring_read(vis->ring, vis->window, play + w / 2, w + search);
+
+    int start = search;
+    for (int i = search; i > 0; i--)
+    {
+        if (vis->window[(i - 1) * ch] < 0 && vis->window[i * ch] >= 0)
+        {
+            start = i;
+            break;
+        }
+    }
+
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+
+    for (int c = 0; c < ch; c++)
+    {
+        int y0 = is->ytop + c * band + band / 2;
+
+        for (int x = 0; x < w; x++)
+        {
+            vis->points[x].x = is->xleft + x;
+            vis->points[x].y = y0 - vis->window[(start + x) * ch + c] * band / 65536;
+        }
+
+        SDL_RenderDrawLines(renderer, vis->points, w);
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
+
+    for (int c = 1; c < ch; c++)
+    {
+        fill_rectangle(is->xleft, is->ytop + c * band, w, 1);
+    }
+}
+
+/* at least two samples per row, capped for very tall windows */
+static int audio_vis_tx_init(AudioVis *vis, int h)
+{
+    int bits;
+    for (bits = 1; (1 << bits) < 2 * h && bits < VIS_TX_BITS_MAX; bits++)
+        ;
+
+    if (bits == vis->tx_bits)
+    {
+        return 0;
+    }
+
+    float scale = 1.0f;
+    int ret;
+
+    av_tx_uninit(&vis->tx);
+    av_freep(&vis->tx_in);
+    av_freep(&vis->tx_out);
+    vis->tx_bits = 0;
+
+    if ((ret = av_tx_init(&vis->tx, &vis->tx_fn, AV_TX_FLOAT_FFT, 0, 1 << bits, &scale, 0)) < 0)
+    {
+        return ret;
+    }
+
+    if (!(vis->tx_in = av_malloc_array(1 << bits, sizeof(*vis->tx_in))) ||
+        !(vis->tx_out = av_malloc_array(1 << bits, sizeof(*vis->tx_out))))
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    vis->tx_bits = bits;
+
+    return 0;
+}
+
+/* one spectrogram column, low frequencies at the bottom; two channels share a complex FFT,
+   red the first, green the second, blue their average so equal levels come out gray */
+static void audio_vis_column(AudioVis *vis, unsigned int end, uint32_t *pixels, int pitch, int h)
+{
+    int n = 1 << vis->tx_bits, nb_freq = n / 2, ch = vis->ring->channels;
+    float scale = 1.0f / sqrtf(nb_freq);
+
+    sample_ring_read(vis->ring, vis->window, end, n);
+
+    for (int i = 0; i < n; i++)
+    {
+        /* Welch window */
+        float w = (i - nb_freq) * (1.0f / nb_freq);
+        w = 1.0f - w * w;
+
+        vis->tx_in[i].re = vis->window[i * ch] * w;
+        vis->tx_in[i].im = ch > 1 ? vis->window[i * ch + 1] * w : 0.0f;
+    }
+
+    vis->tx_fn(vis->tx, vis->tx_out, vis->tx_in, sizeof(AVComplexFloat));
+
+    for (int y = 0; y < h; y++)
+    {
+        int k = (int64_t)y * nb_freq / h;
+        AVComplexFloat z = vis->tx_out[k], zc = vis->tx_out[(n - k) & (n - 1)];
+
+        /* X0 = (Z[k] + conj Z[n-k]) / 2, X1 = (Z[k] - conj Z[n-k]) / 2i */
+        float re0 = (z.re + zc.re) * 0.5f, im0 = (z.im - zc.im) * 0.5f;
+        float re1 = (z.im + zc.im) * 0.5f, im1 = (zc.re - z.re) * 0.5f;
+        int a = FFMIN(lrintf(sqrtf(scale * sqrtf(re0 * re0 + im0 * im0))), 255);
+        int b = ch > 1 ? FFMIN(lrintf(sqrtf(scale * sqrtf(re1 * re1 + im1 * im1))), 255) : a;
+
+        pixels[(h - 1 - y) * (pitch >> 2)] = a << 16 | b << 8 | (a + b) >> 1;
+    }
+}
+
+/* writes only the columns that became due, then shows the texture scrolled so the newest is on the right */
+static void audio_vis_spectrum(VideoState *is, AudioVis *vis, unsigned int play, int nb_columns)
+{
+    int w = is->width, h = is->height, n = 1 << vis->tx_bits;
+    int step = FFMAX(lrint(rdftspeed * is->audio_tgt.freq), 1);
+
+    av_fast_malloc(&vis->window, &vis->window_size, n * vis->ring->channels * sizeof(*vis->window));
+    if (!vis->window)
+    {
+        return;
+    }
+
+    SDL_Texture *old = vis->texture;
+    if (realloc_texture(&vis->texture, SDL_PIXELFORMAT_ARGB8888, w, h, SDL_BLENDMODE_NONE, 1) < 0)
+    {
+        return;
+    }
+
+    if (vis->texture != old)
+    {
+        vis->xpos = 0;
+    }
+
+    /* older columns would need audio the ring no longer holds */
+    nb_columns = FFMIN3(nb_columns, w, (VIS_RING_FRAMES / 2 - n) / step + 1);
+
+    for (int i = nb_columns - 1; i >= 0; i--)
+    {
+        SDL_Rect r = {vis->xpos, 0, 1, h};
+        uint32_t *pixels;
+        int pitch;
+
+        if (!SDL_LockTexture(vis->texture, &r, (void **)&pixels, &pitch))
+        {
+            /* centered on the audio heard when the column was due */
+            audio_vis_column(vis, play + n / 2 - i * step, pixels, pitch, h);
+            SDL_UnlockTexture(vis->texture);
+        }
+
+        vis->xpos = (vis->xpos + 1) % w;
+    }
+
+    SDL_Rect src = {vis->xpos, 0, w - vis->xpos, h};
+    SDL_Rect dst = {is->xleft, is->ytop, w - vis->xpos, h};
+    SDL_RenderCopy(renderer, vis->texture, &src, &dst);
+
+    if (vis->xpos)
+    {
+        src = (SDL_Rect){0, 0, vis->xpos, h};
+        dst = (SDL_Rect){is->xleft + w - vis->xpos, is->ytop, vis->xpos, h};
+        SDL_RenderCopy(renderer, vis->texture, &src, &dst);
+    }
+}
+
+static void audio_vis_display(VideoState *is)
+{
+    AudioVis *vis = &is->vis;
+
+    if (audio_vis_ring_alloc(is, vis) < 0 ||
+        (is->show_mode == SHOW_MODE_RDFT && audio_vis_tx_init(vis, is->height) < 0))
+    {
+        return;
+    }
+
+    double time = av_gettime_relative() / 1000000.0;
+    int nb_columns = 0;
+
+    if (!is->paused)
+    {
+        /* a long gap, a pause or the first call, starts the columns over */
+        if (time - vis->column_time > 1.0)
+        {
+            vis->column_time = time - rdftspeed;
+        }
+
+        nb_columns = (time - vis->column_time) / rdftspeed;
+        vis->column_time += nb_columns * rdftspeed;
+
+        int min_delay = is->show_mode == SHOW_MODE_RDFT ? (1 << vis->tx_bits) / 2 : is->width / 2;
+        vis->last_end = audio_vis_play_end(is, vis->ring, min_delay);
+    }
+
+    if (is->show_mode == SHOW_MODE_WAVES)
+    {
+        audio_vis_waves(is, vis, vis->last_end);
+    }
+    else
+    {
+        audio_vis_spectrum(is, vis, vis->last_end, nb_columns);
+    }
+}
+
+static void stream_component_close_input(VideoState *is, AVFormatContext *ic, int stream_index)
+{
+    AVCodecParameters *codecpar;
+
+    if (stream_index < 0 || stream_index >= ic->nb_streams)
+    {
+        return;
+    }
+
+    codecpar = ic->streams[stream_index]->codecpar;
+
+    switch (codecpar->codec_type)
+    {
+    case AVMEDIA_TYPE_AUDIO:
+
+        decoder_abort(&is->auddec, &is->sampq);
+
+        SDL_CloseAudioDevice(audio_dev);
+
+        decoder_destroy(&is->auddec);
+
+        swr_free(&is->swr_ctx);
+        av_freep(&is->audio_buf1);
+
+        is->audio_buf1_size = 0;
+        is->audio_buf = NULL;
+
+        break;
+
+    case AVMEDIA_TYPE_VIDEO:
+        decoder_abort(&is->viddec, &is->pictq);
+        decoder_destroy(&is->viddec);
+
+        /* the read thread may be requeueing it */
+        SDL_LockMutex(is->pictq.mutex);
+        av_frame_free(&is->attached_pic.frame);
+        SDL_UnlockMutex(is->pictq.mutex);
+
+        is->attached_pic_uploaded = 0;
+        break;
+
+    case AVMEDIA_TYPE_SUBTITLE:
+        decoder_abort(&is->subdec, &is->subpq);
+        decoder_destroy(&is->subdec);
+        break;
+
+    default:
+        break;
+    }
+
+    ic->streams[stream_index]->discard = AVDISCARD_ALL;
+
+    switch (codecpar->codec_type)
+    {
+    case AVMEDIA_TYPE_AUDIO:
+        is->audio_st = NULL;
+        is->audio_stream = -1;
+        break;
+
+    case AVMEDIA_TYPE_VIDEO:
+        is->video_st = NULL;
+        is->video_stream = -1;
+        break;
+
+    case AVMEDIA_TYPE_SUBTITLE:
+        is->subtitle_st = NULL;
+        is->subtitle_stream = -1;
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void stream_component_close(VideoState *is, int stream_index)
+{
+    stream_component_close_input(is, is->ic, stream_index);
+}
+
+static void log_stream_bytes(VideoState *is)
+{
+    AVFormatContext *ic = is->ic;
+
+    if (!ic || !is->nb_stream_bytes)
+    {
+        return;
+    }
+
+    for (int i = 0; i < is->nb_stream_bytes; i++)
+    {
+        const char *type = av_get_media_type_string(ic->streams[i]->codecpar->codec_type);
+
+        av_log(NULL, AV_LOG_INFO,
+               "stream #%d (%s%s): read %" PRId64 " KB, used %" PRId64 " KB\n",
+               i,
+               type ? type : "unknown",
+               ic->streams[i]->discard == AVDISCARD_ALL ? ", discarded" : "",
+               is->stream_bytes_read[i] / 1024,
+               is->stream_bytes_used[i] / 1024);
+    }
+
+    if (ic->pb)
+    {
+        av_log(NULL, AV_LOG_INFO, "input: %" PRId64 " KB read\n", ic->pb->bytes_read / 1024);
+    }
+}
+
+/*
+ * close the switched away inputs no decoder can still be using, all closes every one of them. a decoder that has not
+ * taken a packet of the serial its switch started may still be working on frames of the old streams
+ */
+static void input_retired_collect(VideoState *is, int all)
+{
+    Decoder *decoders[] = {&is->auddec, &is->viddec, &is->subdec};
+    int nb_kept = 0;
+
+    for (int i = 0; i < is->nb_retired; i++)
+    {
+        RetiredInput *r = &is->retired[i];
+        int in_use = 0;
+
+        for (size_t k = 0; k < FF_ARRAY_ELEMS(decoders) && !all; k++)
+        {
+            in_use |= decoders[k]->avctx && decoders[k]->pkt_serial < r->serial[k];
+        }
+
+        if (in_use)
+        {
+            is->retired[nb_kept++] = *r;
+        }
+        else
+        {
+            avformat_close_input(&r->ic);
+        }
+    }
+
+    is->nb_retired = nb_kept;
+}
+
+static void stream_close(VideoState *is)
+{
+    /* XXX: use a special url_shutdown call to abort parse cleanly */
+    is->abort_request = 1;
+    if (is->continue_read_thread)
+    {
+        SDL_CondSignal(is->continue_read_thread);
+    }
+
+    /* the interrupt callback stops any interruptible I/O, a read stuck in the kernel is left behind */
+    if (is->read_tid && shutdown_timeout > 0 && SDL_SemWaitTimeout(is->read_thread_done, shutdown_timeout / 1000) == SDL_MUTEX_TIMEDOUT)
+    {
+        av_log(NULL, AV_LOG_ERROR, "read thread did not exit within %.1fs, abandoning it\n", shutdown_timeout / 1000000.0);
+        SDL_DetachThread(is->read_tid);
+        return;
+    }
+
+    SDL_WaitThread(is->read_tid, NULL);
+
+    if (is->nb_io_stalls)
+    {
+        av_log(NULL, AV_LOG_INFO, "input: %d stalls, %d read retries\n", is->nb_io_stalls, is->nb_io_retries);
+    }
+
+    /* a helper thread that outlives its join still uses the decoder queues, then everything is left as is */
+#if HAVE_MMAP_IO
+    if (timeshift_close(&is->tshift) < 0)
+    {
+        return;
+    }
+#endif
+
+    recorder_close(&is->rec);
+
+    if (is->nb_input_switches)
+    {
+        av_log(NULL, AV_LOG_INFO, "input: %d switches, ended on input %d\n", is->nb_input_switches, is->input_index);
+    }
+
+    input_opener_free(&is->opener);
+
+    log_stream_bytes(is);
+
+    if (sidecars_stop(is) < 0)
+    {
+        return;
+    }
+
+    /* close each stream */
+    if (is->audio_stream >= 0)
+    {
+        stream_component_close_input(is, is->audio_sidecar ? is->audio_sidecar->ic : is->ic, is->audio_stream);
+    }
+
+    if (is->video_stream >= 0)
+    {
+        stream_component_close(is, is->video_stream);
+    }
+
+    if (is->subtitle_stream >= 0)
+    {
+        stream_component_close_input(is, is->subtitle_sidecar ? is->subtitle_sidecar->ic : is->ic, is->subtitle_stream);
+    }
+
+    sidecars_free(is);
+
+    avformat_close_input(&is->ic);
+    input_retired_collect(is, 1);
+
+    av_freep(&is->stream_bytes_read);
+    av_freep(&is->stream_bytes_used);
+
+#if HAVE_MMAP_IO
+    mmap_io_close(&is->mmio);
+#endif
+
+#if HAVE_PREAD_IO
+    readahead_io_close(&is->raio);
+#endif
+
+    byte_time_map_close(&is->btmap);
+
+    packet_queue_destroy(&is->videoq);
+    packet_queue_destroy(&is->audioq);
+    packet_queue_destroy(&is->subtitleq);
+
+    /* free all pictures */
+    frame_queue_destory(&is->pictq);
+    frame_queue_destory(&is->sampq);
+    frame_queue_destory(&is->subpq);
+    text_renderer_free(&is->text);
+
+    SDL_DestroyCond(is->continue_read_thread);
+
+    if (is->btmap_mutex)
+    {
+        SDL_DestroyMutex(is->btmap_mutex);
+    }
+
+    if (is->switch_mutex)
+    {
+        SDL_DestroyMutex(is->switch_mutex);
+    }
+
+    if (is->switch_cond)
+    {
+        SDL_DestroyCond(is->switch_cond);
+    }
+
+    if (is->read_thread_done)
+    {
+        SDL_DestroySemaphore(is->read_thread_done);
+    }
+
+    sws_freeContext(is->img_convert_ctx);
+    soft_output_free(&is->soft);
+    stats_overlay_free(&is->overlay);
+    glyph_atlas_free(&is->atlas);
+
+    av_free(is->filename);
+
+    audio_vis_free(&is->vis);
+
+    if (is->nb_presented)
+    {
+        av_log(NULL, AV_LOG_INFO, "video: %d presents, display to present %.2f ms average %.2f ms max, %d pictures uploaded ahead, %d late\n",
+               is->nb_presented, is->present_latency_total / 1000.0 / is->nb_presented, is->present_latency_max / 1000.0,
+               is->nb_uploads_idle, is->nb_uploads_late);
+        av_log(NULL, AV_LOG_INFO, "video: %" PRId64 " MB uploaded, %d unchanged pictures skipped, %d uploaded in bands\n",
+               is->upload_bytes >> 20, is->nb_uploads_skipped, is->nb_uploads_partial);
+        av_log(NULL, AV_LOG_INFO, "present: %.2f ms average %.2f ms max inside SDL_RenderPresent, interval %.2f ms, jitter %.2f ms, %s\n",
+               is->present_block_total / 1000.0 / is->nb_presented, is->present_block_max / 1000.0,
+               is->present_interval_mean / 1000.0,
+               is->nb_present_intervals > 1 ? sqrt(is->present_interval_m2 / (is->nb_present_intervals - 1)) / 1000.0 : 0.0,
+               render_tid ? "render thread" : "main thread");
+    }
+
+    if (is->nb_input_events)
+    {
+        av_log(NULL, AV_LOG_INFO, "input: %d events, %.1f ms average %.1f ms max from queued to handled\n",
+               is->nb_input_events, is->input_latency_total / 1000.0 / is->nb_input_events, is->input_latency_max / 1000.0);
+    }
+
+    for (int i = 0; i < VIDEO_TEXTURE_POOL; i++)
+    {
+        if (is->vid_slots[i].tex)
+        {
+            SDL_DestroyTexture(is->vid_slots[i].tex);
+        }
+
+        av_freep(&is->vid_slots[i].band_hash);
+    }
+
+    if (is->attached_pic_texture)
+    {
+        SDL_DestroyTexture(is->attached_pic_texture);
+    }
+
+    if (is->sub_texture)
+    {
+        SDL_DestroyTexture(is->sub_texture);
+    }
+
+    av_free(is);
+}
+
+static void do_exit(VideoState *is)
+{
+    if (is)
+    {
+        stream_close(is);
+    }
+
+    if (renderer)
+    {
+        SDL_DestroyRenderer(renderer);
+    }
+
+    if (window)
+    {
+        SDL_DestroyWindow(window);
+    }
+
+    avformat_network_deinit();
+
+    if (show_status)
+    {
+        printf("\n");
+    }
+
+    SDL_Quit();
+
+    av_log(NULL, AV_LOG_QUIET, "%s", "");
+
+    exit(0);
+}
+
+static void sigterm_handler(int sig)
+{
+    exit(123);
+}
+
+/* clockwise rotation of the display matrix rounded to a quarter turn, hflip set for a mirrored matrix */
+static double stream_rotation(AVStream *st, int *hflip)
+{
+    int32_t *displaymatrix = (int32_t *)av_stream_get_side_data(st, AV_PKT_DATA_DISPLAYMATRIX, NULL);
+
+    *hflip = 0;
+
+    if (!displaymatrix)
+    {
+        return 0;
+    }
+
+    int32_t matrix[9];
+    memcpy(matrix, displaymatrix, sizeof(matrix));
+
+    /* a negative determinant means a mirror, undo it to read the rotation */
+    if ((int64_t)matrix[0] * matrix[4] - (int64_t)matrix[1] * matrix[3] < 0)
+    {
+        *hflip = 1;
+        av_display_matrix_flip(matrix, 1, 0);
+    }
+
+    double theta = -av_display_rotation_get(matrix);
+    if (isnan(theta))
+    {
+        return 0;
+    }
+
+    theta = 90 * lrint(theta / 90);
+    theta -= 360 * floor(theta / 360);
+
+    return theta;
+}
+
+static void set_default_window_size(int width, int height, AVRational sar, double rotation)
+{
+    SDL_Rect rect;
+
+    /* a quarter turn swaps the sides of the window */
+    if (rotation == 90 || rotation == 270)
+    {
+        FFSWAP(int, width, height);
+        sar = sar.num ? av_inv_q(sar) : sar;
+    }
+
+    calculate_display_rect(&rect, 0, 0, INT_MAX, height, width, height, sar);
+
+    default_width = rect.w;
+    default_height = rect.h;
+}
+
+static void window_apply(int op, int a, int b)
+{
+    switch (op)
+    {
+    case WINDOW_OP_SHOW:
+        SDL_SetWindowTitle(window, window_title);
+
+        SDL_SetWindowSize(window, a, b);
+        SDL_SetWindowPosition(window, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED);
+
+        if (is_full_screen)
+        {
+            SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN_DESKTOP);
+        }
+
+        SDL_ShowWindow(window);
+        break;
+
+    case WINDOW_OP_FULLSCREEN:
+        SDL_SetWindowFullscreen(window, a ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0);
+        break;
+
+    case WINDOW_OP_CURSOR:
+        SDL_ShowCursor(a);
+        break;
+    }
+
+    window_format = SDL_GetWindowPixelFormat(window);
+}
+
+/* SDL window and cursor calls are main thread only, the render thread posts them there */
+static void window_request(int op, int a, int b)
+{
+    if (SDL_ThreadID() == main_thread_id)
+    {
+        window_apply(op, a, b);
+        return;
+    }
+
+    SDL_Event event = {.type = FF_WINDOW_EVENT};
+    event.user.code = op;
+    event.user.data1 = (void *)(intptr_t)a;
+    event.user.data2 = (void *)(intptr_t)b;
+
+    SDL_PushEvent(&event);
+}
+
+static int video_open(VideoState *is)
+{
+    int w, h;
+
+    if (screen_width)
+    {
+        w = screen_width;
+        h = screen_height;
+    }
+    else
+    {
+        w = default_width;
+        h = default_height;
+    }
+
+    if (!window_title)
+    {
+        window_title = input_filename;
+    }
+
+    is->width = w;
+    is->height = h;
+
+    window_request(WINDOW_OP_SHOW, w, h);
+
+    return 0;
+}
+
+/* display the current picture, if any */
+static void video_display(VideoState *is)
+{
+    int64_t start = av_gettime_relative();
+
+    if (!is->width)
+    {
+        video_open(is);
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    if (is->video_st)
+    {
+        video_image_display(is);
+    }
+    else if (is->audio_st && is->show_mode != SHOW_MODE_NONE)
+    {
+        audio_vis_display(is);
+    }
+
+    if (stats_overlay && is->overlay.texture)
+    {
+        int margin = is->overlay.cell_h / 2;
+        SDL_Rect r = {margin, margin, is->overlay.w, is->overlay.h};
+
+        SDL_RenderCopy(renderer, is->overlay.texture, NULL, &r);
+    }
+
+    int64_t present_start = av_gettime_relative();
+    SDL_RenderPresent(renderer);
+    int64_t present_end = av_gettime_relative();
+
+    is->present_block_total += present_end - present_start;
+    is->present_block_max = FFMAX(is->present_block_max, present_end - present_start);
+
+    /* jitter between consecutive presents, gaps from pauses and seeks are not counted */
+    int64_t interval = present_end - is->last_present;
+    if (is->last_present && interval < PRESENT_INTERVAL_MAX)
+    {
+        double delta = interval - is->present_interval_mean;
+
+        is->nb_present_intervals++;
+        is->present_interval_mean += delta / is->nb_present_intervals;
+        is->present_interval_m2 += delta * (interval - is->present_interval_mean);
+
+        StatsOverlay *so = &is->overlay;
+        so->frame_times[so->frame_time_index] = interval;
+        so->frame_time_index = (so->frame_time_index + 1) % OVERLAY_GRAPH_LEN;
+        so->nb_frame_times = FFMIN(so->nb_frame_times + 1, OVERLAY_GRAPH_LEN);
+    }
+
+    is->last_present = present_end;
+
+    int64_t latency = present_end - start;
+    int64_t block = present_end - present_start;
+    is->overlay.present_time = is->overlay.present_time ? (is->overlay.present_time * 7 + latency) / 8 : latency;
+    is->overlay.present_block = is->overlay.present_block ? (is->overlay.present_block * 7 + block) / 8 : block;
+
+    is->present_latency_total += latency;
+    is->present_latency_max = FFMAX(is->present_latency_max, latency);
+    is->nb_presented++;
+
+    int64_t now = start + latency;
+    if (now - is->upload_report_time >= 1000000)
+    {
+        if (is->upload_report_time)
+        {
+            av_log(NULL, AV_LOG_VERBOSE, "texture uploads: %.2f MB/s\n",
+                   (is->upload_bytes - is->upload_bytes_reported) / 1048576.0 * 1000000 / (now - is->upload_report_time));
+        }
+
+        is->upload_bytes_reported = is->upload_bytes;
+        is->upload_report_time = now;
+    }
+}
+
+static double get_clock(Clock *c)
+{
+    if (*c->queue_serial != c->serial)
+    {
+        return NAN;
+    }
+
+    if (c->paused)
+    {
+        return c->pts;
+    }
+    else
+    {
+        double time = av_gettime_relative() / 1000000.0;
+        return c->pts_drift + time - (time - c->last_updated) * (1.0 - c->speed);
+    }
+}
+
+static void set_clock_at(Clock *c, double pts, int serial, double time)
+{
+    c->pts = pts;
+    c->last_updated = time;
+    c->pts_drift = c->pts - time;
+    c->serial = serial;
+}
+
+static void set_clock(Clock *c, double pts, int serial)
+{
+    double time = av_gettime_relative() / 1000000.0;
+    set_clock_at(c, pts, serial, time);
+}
+
+static void set_clock_speed(Clock *c, double speed)
+{
+    set_clock(c, get_clock(c), c->serial);
+    c->speed = speed;
+}
+
+static void init_clock(Clock *c, int *queue_serial)
+{
+    c->speed = 1.0;
+    c->paused = 0;
+    c->queue_serial = queue_serial;
+
+    set_clock(c, NAN, -1);
+}
+
+static void sync_clock_to_slave(Clock *c, Clock *slave)
+{
+    double clock = get_clock(c);
+    double slave_clock = get_clock(slave);
+
+    if (!isnan(slave_clock) && (isnan(clock) || fabs(clock - slave_clock) > AV_NOSYNC_THRESHOLD))
+    {
+        set_clock(c, slave_clock, slave->serial);
+    }
+}
+
+static int get_master_sync_type(VideoState *is)
+{
+    if (is->av_sync_type == AV_SYNC_VIDEO_MASTER)
+    {
+        if (is->video_st)
+        {
+            return AV_SYNC_VIDEO_MASTER;
+        }
+
+        return AV_SYNC_AUDIO_MASTER;
+    }
+    else if (is->av_sync_type == AV_SYNC_AUDIO_MASTER)
+    {
+        if (is->audio_st)
+        {
+            return AV_SYNC_AUDIO_MASTER;
+        }
+
+        return AV_SYNC_EXTERNAL_CLOCK;
+    }
+    else
+    {
+        return AV_SYNC_EXTERNAL_CLOCK;
+    }
+}
+
+/* get the current master clock value */
+static double get_master_clock(VideoState *is)
+{
+    double val;
+
+    switch (get_master_sync_type(is))
+    {
+    case AV_SYNC_VIDEO_MASTER:
+        val = get_clock(&is->vidclk);
+        break;
+
+    case AV_SYNC_AUDIO_MASTER:
+        val = get_clock(&is->audclk);
+        break;
+
+    default:
+        val = get_clock(&is->extclk);
+        break;
+    }
+
+    return val;
+}
+
+static void check_external_clock_speed(VideoState *is)
+{
+    if (is->video_stream >= 0 && is->videoq.nb_packets <= EXTERNAL_CLOCK_MIN_FRAMES ||
+        is->audio_stream >= 0 && is->audioq.nb_packets <= EXTERNAL_CLOCK_MIN_FRAMES)
+    {
+        set_clock_speed(&is->extclk, FFMAX(EXTERNAL_CLOCK_SPEED_MIN, is->extclk.speed - EXTERNAL_CLOCK_SPEED_STEP));
+    }
+    else if ((is->video_stream < 0 || is->videoq.nb_packets > EXTERNAL_CLOCK_MAX_FRAMES) &&
+             (is->audio_stream < 0 || is->audioq.nb_packets > EXTERNAL_CLOCK_MAX_FRAMES))
+    {
+        set_clock_speed(&is->extclk, FFMIN(EXTERNAL_CLOCK_SPEED_MAX, is->extclk.speed + EXTERNAL_CLOCK_SPEED_STEP));
+    }
+    else
+    {
+        double speed = is->extclk.speed;
+        if (speed != 1.0)
+        {
+            set_clock_speed(&is->extclk, speed + EXTERNAL_CLOCK_SPEED_STEP * (1.0 - speed) / fabs(1.0 - speed));
+        }
+    }
+}
+
+/* seek in the stream, target_ts is the time a byte seek aims for */
+static void stream_seek_with_target(VideoState *is, int64_t pos, int64_t rel, int seek_by_bytes, int64_t target_ts)
+{
+    if (!is->seek_req)
+    {
+        is->seek_pos = pos;
+        is->seek_rel = rel;
+        is->seek_target_ts = target_ts;
+        is->seek_flags &= ~AVSEEK_FLAG_BYTE;
+
+        if (seek_by_bytes)
+        {
+            is->seek_flags |= AVSEEK_FLAG_BYTE;
+        }
+
+        is->seek_req = 1;
+
+        SDL_CondSignal(is->continue_read_thread);
+    }
+}
+
+static void stream_seek(VideoState *is, int64_t pos, int64_t rel, int seek_by_bytes)
+{
+    stream_seek_with_target(is, pos, rel, seek_by_bytes, AV_NOPTS_VALUE);
+}
+
+/* pause or resume the video */
+static void stream_toggle_pause(VideoState *is)
+{
+    if (is->paused)
+    {
+        is->frame_timer += av_gettime_relative() / 1000000.0 - is->vidclk.last_updated;
+        if (is->read_pause_return != AVERROR(ENOSYS))
+        {
+            is->vidclk.paused = 0;
+        }
+
+        set_clock(&is->vidclk, get_clock(&is->vidclk), is->vidclk.serial);
+    }
+
+    set_clock(&is->extclk, get_clock(&is->extclk), is->extclk.serial);
+    is->paused = is->audclk.paused = is->vidclk.paused = is->extclk.paused = !is->paused;
+}
+
+static void toggle_pause(VideoState *is)
+{
+    stream_toggle_pause(is);
+    is->step = 0;
+}
+
+static void toggle_mute(VideoState *is)
+{
+    is->muted = !is->muted;
+}
+
+static void update_volume(VideoState *is, int sign, double step)
+{
+    double volume_level = is->audio_volume ? (20 * log(is->audio_volume / (double)SDL_MIX_MAXVOLUME) / log(10)) : -1000.0;
+    int new_volume = lrint(SDL_MIX_MAXVOLUME * pow(10.0, (volume_level + sign * step) / 20.0));
+    is->audio_volume = av_clip(is->audio_volume == new_volume ? (is->audio_volume + sign) : new_volume, 0, SDL_MIX_MAXVOLUME);
+}
+
+static void step_to_next_frame(VideoState *is)
+{
+    /* if the stream is paused unpause it, then step */
+    if (is->paused)
+    {
+        stream_toggle_pause(is);
+    }
+
+    is->step = 1;
+}
+
+static double compute_target_delay(double delay, VideoState *is)
+{
+    double sync_threshold, diff = 0;
+
+    /* update delay to follow master synchronisation source */
+    if (get_master_sync_type(is) != AV_SYNC_VIDEO_MASTER)
+    {
+        /* if video is slave, we try to correct big delays by
+           duplicating or deleting a frame */
+        diff = get_clock(&is->vidclk) - get_master_clock(is);
+
+        /* skip or repeat frame. We take into account the
+           delay to compute the threshold. I still don't know
+           if it is the best guess */
+        sync_threshold = FFMAX(AV_SYNC_THRESHOLD_MIN, FFMIN(AV_SYNC_THRESHOLD_MAX, delay));
+
+        if (!isnan(diff) && fabs(diff) < is->max_frame_duration)
+        {
+            if (diff <= -sync_threshold)
+            {
+                delay = FFMAX(0, delay + diff);
+            }
+            else if (diff >= sync_threshold && delay > AV_SYNC_FRAMEDUP_THRESHOLD)
+            {
+                delay = delay + diff;
+            }
+            else if (diff >= sync_threshold)
+            {
+                delay = 2 * delay;
+            }
+        }
+    }
+
+    av_log(NULL, AV_LOG_TRACE, "video: delay=%0.3f A-V=%f\n", delay, -diff);
+
+    return delay;
+}
+
+static double vp_duration(VideoState *is, Frame *vp, Frame *nextvp)
+{
+    if (vp->serial == nextvp->serial)
+    {
+        double duration = nextvp->pts - vp->pts;
+        if (isnan(duration) || duration <= 0 || duration > is->max_frame_duration)
+        {
+            return vp->duration;
+        }
+
+        return duration;
+    }
+    else
+    {
+        return 0.0;
+    }
+}
+
+static void update_video_pts(VideoState *is, double pts, int64_t pos, int serial)
+{
+    /* update current video pts */
+    set_clock(&is->vidclk, pts, serial);
+    sync_clock_to_slave(&is->extclk, &is->vidclk);
+}
+
+/* difference of the two clocks that matter, label names them */
+static double status_av_diff(VideoState *is, const char **label)
+{
+    if (is->audio_st && is->video_st)
+    {
+        *label = "A-V";
+        return get_clock(&is->audclk) - get_clock(&is->vidclk);
+    }
+
+    if (is->video_st)
+    {
+        *label = "M-V";
+        return get_master_clock(is) - get_clock(&is->vidclk);
+    }
+
+    if (is->audio_st)
+    {
+        *label = "M-A";
+        return get_master_clock(is) - get_clock(&is->audclk);
+    }
+
+    *label = "   ";
+    return 0;
+}
+
+static void show_status_in_video_refresh(VideoState *is)
+{
+    static int64_t last_time;
+    int64_t cur_time;
+    int aqsize, vqsize, sqsize;
+    const char *label;
+    double av_diff;
+    cur_time = av_gettime_relative();
+
+    if (!last_time || (cur_time - last_time) >= 30000)
+    {
+        aqsize = vqsize = sqsize = 0;
+
+        if (is->audio_st)
+        {
+            aqsize = is->audioq.size;
+        }
+
+        if (is->video_st)
+        {
+            vqsize = is->videoq.size;
+        }
+
+        if (is->subtitle_st)
+        {
+            sqsize = is->subtitleq.size;
+        }
+
+        av_diff = status_av_diff(is, &label);
+
+        av_log(NULL, AV_LOG_INFO,
+               "%7.2f %s:%7.3f fd=%4d aq=%5dKB vq=%5dKB sq=%5dB f=%" PRId64 "/%" PRId64 "   \r",
+               get_master_clock(is),
+               label,
+               av_diff,
+               is->frame_drops_early + is->frame_drops_late,
+               aqsize / 1024,
+               vqsize / 1024,
+               sqsize,
+               is->video_st ? is->viddec.avctx->pts_correction_num_faulty_dts : 0,
+               is->video_st ? is->viddec.avctx->pts_correction_num_faulty_pts : 0);
+
+        fflush(stdout);
+
+        last_time = cur_time;
+    }
+}
+
+static void stats_overlay_packet_queue(StatsOverlayContent *c, int i, const char *name, AVStream *st, PacketQueue *q)
+{
+    if (!st)
+    {
+        snprintf(c->text[1 + i], sizeof(c->text[0]), "%-5s %*s -", name, OVERLAY_BAR_COLS, "");
+        return;
+    }
+
+    /* full at what stream_has_enough_packets asks for */
+    double duration = q->duration * av_q2d(st->time_base);
+    double fill = FFMIN(q->nb_packets / (double)MIN_FRAMES, 1.0);
+    if (q->duration)
+    {
+        fill = FFMIN(fill, duration);
+    }
+
+    c->bar[i] = lrint(fill * 255);
+    /* clamped to the columns, a huge queue shows as full instead of cutting the line */
+    snprintf(c->text[1 + i], sizeof(c->text[0]), "%-5.5s %*s %3d %4.1fs %5dK",
+             name, OVERLAY_BAR_COLS, "", av_clip(q->nb_packets, 0, 999), av_clipd(duration, 0, 99.9), av_clip(q->size / 1024, 0, 99999));
+}
+
+static void stats_overlay_frame_queue(StatsOverlayContent *c, int i, const char *name, AVStream *st, FrameQueue *f)
+{
+    if (!st)
+    {
+        snprintf(c->text[1 + i], sizeof(c->text[0]), "%-5s %*s -", name, OVERLAY_BAR_COLS, "");
+        return;
+    }
+
+    int remaining = frame_queue_nb_remaining(f);
+
+    c->bar[i] = remaining * 255 / f->max_size;
+    snprintf(c->text[1 + i], sizeof(c->text[0]), "%-5s %*s %d/%d", name, OVERLAY_BAR_COLS, "", remaining, f->max_size);
+}
+
+static void stats_overlay_content(VideoState *is, StatsOverlayContent *c)
+{
+    StatsOverlay *so = &is->overlay;
+    const char *label;
+    double av_diff = status_av_diff(is, &label);
+
+    memset(c, 0, sizeof(*c));
+
+    snprintf(c->text[0], sizeof(c->text[0]), "%s %+7.3f  drop %d/%d",
+             label, av_diff, is->frame_drops_early, is->frame_drops_late);
+
+    stats_overlay_packet_queue(c, 0, "vq", is->video_st, &is->videoq);
+    stats_overlay_packet_queue(c, 1, "aq", is->audio_st, &is->audioq);
+    stats_overlay_packet_queue(c, 2, "sq", is->subtitle_st, &is->subtitleq);
+    stats_overlay_frame_queue(c, 3, "pictq", is->video_st, &is->pictq);
+    stats_overlay_frame_queue(c, 4, "sampq", is->audio_st, &is->sampq);
+    stats_overlay_frame_queue(c, 5, "subpq", is->subtitle_st, &is->subpq);
+
+    snprintf(c->text[7], sizeof(c->text[0]), "decode %5.1f ms  upload %5.1f ms",
+             is->video_st ? is->viddec.decode_time / 1000.0 : 0.0, is->upload_time / 1000.0);
+    snprintf(c->text[8], sizeof(c->text[0]), "present %5.1f ms block %5.1f ms",
+             so->present_time / 1000.0, so->present_block / 1000.0);
+
+    int graph_h = 3 * so->cell_h;
+    for (int i = 0; i < so->nb_frame_times; i++)
+    {
+        int t = so->frame_times[(so->frame_time_index - so->nb_frame_times + i + OVERLAY_GRAPH_LEN) % OVERLAY_GRAPH_LEN];
+        c->graph[OVERLAY_GRAPH_LEN - so->nb_frame_times + i] = FFMIN(t, OVERLAY_GRAPH_MAX) * (int64_t)graph_h / OVERLAY_GRAPH_MAX;
+    }
+
+    AVRational fr = is->video_st ? is->video_st->avg_frame_rate : (AVRational){0, 1};
+    if (fr.num && fr.den)
+    {
+        c->graph_mark = FFMIN(1000000 / av_q2d(fr), OVERLAY_GRAPH_MAX) * graph_h / OVERLAY_GRAPH_MAX;
+    }
+}
+
+/* at most every OVERLAY_INTERVAL, 1 when the texture changed and the picture has to be presented again */
+static int stats_overlay_update(VideoState *is)
+{
+    StatsOverlay *so = &is->overlay;
+    int64_t now = av_gettime_relative();
+
+    if (so->last_update && now - so->last_update < OVERLAY_INTERVAL)
+    {
+        return 0;
+    }
+
+    so->last_update = now;
+
+    /* readable from across a room in full screen */
+    int size = av_clip(is->height / 48, 16, 64);
+    if (size != so->font_size && stats_overlay_layout(so, size) < 0)
+    {
+        return 0;
+    }
+
+    StatsOverlayContent c;
+    stats_overlay_content(is, &c);
+
+    if (so->texture && !memcmp(&c, &so->shown, sizeof(c)))
+    {
+        return 0;
+    }
+
+    stats_overlay_draw(so, &c);
+
+    if (realloc_texture(&so->texture, SDL_PIXELFORMAT_ARGB8888, so->w, so->h, SDL_BLENDMODE_BLEND, 0) < 0 ||
+        SDL_UpdateTexture(so->texture, NULL, so->pixels, so->w * sizeof(*so->pixels)) < 0)
+    {
+        return 0;
+    }
+
+    so->shown = c;
+    so->nb_redraws++;
+
+    return 1;
+}
+
+static void subtitle_refresh_hide_or_skip(VideoState *is)
+{
+    Frame *sp, *sp2;
+
+    while (frame_queue_nb_remaining(&is->subpq) > 0)
+    {
+        sp = frame_queue_peek(&is->subpq);
+        if (frame_queue_nb_remaining(&is->subpq) > 1)
+        {
+            sp2 = frame_queue_peek_next(&is->subpq);
+        }
+        else
+        {
+            sp2 = NULL;
+        }
+
+        if (sp->serial != is->subtitleq.serial ||
+            (is->vidclk.pts > (sp->pts + ((float)sp->sub.end_display_time / 1000))) ||
+            (sp2 && is->vidclk.pts > (sp2->pts + ((float)sp2->sub.start_display_time / 1000))))
+        {
+            /* sub_texture is drawn only with a subtitle showing, the next upload clears what this one left */
+            frame_queue_next(&is->subpq);
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+/* called to display each frame */
+// 参考：https://zhuanlan.zhihu.com/p/44122324
+static void video_refresh(void *opaque, double *remaining_time)
+{
+    VideoState *is = opaque;
+
+    if (!is->paused && get_master_sync_type(is) == AV_SYNC_EXTERNAL_CLOCK && is->realtime)
+    {
+        check_external_clock_speed(is);
+    }
+
+    /* audio without video, once more on a forced refresh so switching the display off clears the window */
+    if (!is->video_st && is->audio_st && (is->show_mode != SHOW_MODE_NONE || (is->force_refresh && is->width)))
+    {
+        double time = av_gettime_relative() / 1000000.0;
+
+        if (is->force_refresh || is->vis.last_time + rdftspeed < time)
+        {
+            video_display(is);
+            is->vis.last_time = time;
+        }
+
+        *remaining_time = FFMIN(*remaining_time, is->vis.last_time + rdftspeed - time);
+    }
+
+    if (is->video_st)
+    {
+    retry:
+        if (frame_queue_nb_remaining(&is->pictq) == 0)
+        {
+            // nothing to do, no picture to display in the queue
+        }
+        else
+        {
+            double last_duration, duration, delay;
+            Frame *vp, *lastvp;
+
+            /* dequeue the picture */
+            lastvp = frame_queue_peek_last(&is->pictq);
+            vp = frame_queue_peek(&is->pictq);
+
+            if (vp->serial != is->videoq.serial)
+            {
+                frame_queue_next(&is->pictq);
+                goto retry;
+            }
+
+            if (lastvp->serial != vp->serial)
+                is->frame_timer = av_gettime_relative() / 1000000.0;
+
+            if (is->paused)
+            {
+                goto display;
+            }
+
+            /* compute nominal last_duration */
+            last_duration = vp_duration(is, lastvp, vp);
+            delay = compute_target_delay(last_duration, is);
+
+            double time = av_gettime_relative() / 1000000.0;
+            if (time < is->frame_timer + delay)
+            {
+                *remaining_time = FFMIN(is->frame_timer + delay - time, *remaining_time);
+                goto display;
+            }
+
+            is->frame_timer += delay;
+            if (delay > 0 && time - is->frame_timer > AV_SYNC_THRESHOLD_MAX)
+            {
+                is->frame_timer = time;
+            }
+
+            SDL_LockMutex(is->pictq.mutex);
+
+            if (!isnan(vp->pts))
+            {
+                update_video_pts(is, vp->pts, vp->pos, vp->serial);
+            }
+
+            SDL_UnlockMutex(is->pictq.mutex);
+
+            if (frame_queue_nb_remaining(&is->pictq) > 1)
+            {
+                Frame *nextvp = frame_queue_peek_next(&is->pictq);
+                duration = vp_duration(is, vp, nextvp);
+
+                if (!is->step && (framedrop > 0 || (framedrop && get_master_sync_type(is) != AV_SYNC_VIDEO_MASTER)) && time > is->frame_timer + duration)
+                {
+                    is->frame_drops_late++;
+                    frame_queue_next(&is->pictq);
+                    goto retry;
+                }
+            }
+
+            if (is->subtitle_st)
+            {
+                subtitle_refresh_hide_or_skip(is);
+            }
+
+            frame_queue_next(&is->pictq);
+            is->force_refresh = 1;
+
+            if (is->step && !is->paused)
+            {
+                stream_toggle_pause(is);
+            }
+        }
+
+    display:
+        if (stats_overlay && stats_overlay_update(is))
+        {
+            is->force_refresh = 1;
+        }
+
+        /* display picture */
+        if (is->force_refresh && is->pictq.rindex_shown)
+        {
+            video_display(is);
+        }
+    }
+
+    is->force_refresh = 0;
+
+    /* the overlay shows the same and more */
+    if (show_status && !stats_overlay)
+    {
+        show_status_in_video_refresh(is);
+    }
+}
+
+/* murmur3 finalizer, every input bit reaches every output bit */
+static inline uint64_t hash_mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+
+    return x;
+}
+
+static inline void hash_stripe(uint64_t *restrict acc, const uint64_t *restrict v, const uint64_t *restrict key)
+{
+    for (int k = 0; k < 8; k += 2)
+    {
+        uint64_t d0 = v[k] ^ key[k], d1 = v[k + 1] ^ key[k + 1];
+
+        acc[k] += v[k + 1] + (uint64_t)(uint32_t)d0 * (uint32_t)(d0 >> 32);
+        acc[k + 1] += v[k] + (uint64_t)(uint32_t)d1 * (uint32_t)(d1 >> 32);
+    }
+}
+
+/*
+ * xxh3 style accumulation over 64 byte stripes: each 64 bit word is added to the neighbour lane and the product
+ * of its keyed 32 bit halves to its own, which gcc vectorizes into paddq and pmuludq; the lanes are finalized
+ * separately so no bit of any lane can cancel out
+ */
+static uint64_t hash_bytes(const uint8_t *p, int n, uint64_t h)
+{
+    static const uint64_t key[8] = {
+        0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+        0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL, 0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL,
+    };
+    uint64_t acc[8], v[8];
+    int i = 0;
+
+    for (int k = 0; k < 8; k++)
+    {
+        acc[k] = h ^ key[k];
+    }
+
+    for (; i + 64 <= n; i += 64)
+    {
+        memcpy(v, p + i, sizeof(v));
+        hash_stripe(acc, v, key);
+    }
+
+    /* the tail is a zero padded stripe, the length goes into the result */
+    if (i < n)
+    {
+        memset(v, 0, sizeof(v));
+        memcpy(v, p + i, n - i);
+        hash_stripe(acc, v, key);
+    }
+
+    uint64_t r = hash_mix(h ^ (uint64_t)n);
+    for (int k = 0; k < 8; k++)
+    {
+        r += hash_mix(acc[k] + k);
+    }
+
+    return hash_mix(r);
+}
+
+/*
+ * Hash every UPLOAD_BAND_HEIGHT luma rows together with the matching rows of the other planes.
+ * All bytes are hashed: sampling would miss small changes such as a moving cursor.
+ */
+static void frame_hash_bands(Frame *vp)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(vp->format);
+    if (!desc || (desc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL)) || vp->height <= 0)
+    {
+        return;
+    }
+
+    int nb_bands = (vp->height + UPLOAD_BAND_HEIGHT - 1) / UPLOAD_BAND_HEIGHT;
+    int nb_planes = av_pix_fmt_count_planes(vp->format);
+
+    av_fast_malloc(&vp->band_hash, &vp->band_hash_size, nb_bands * sizeof(*vp->band_hash));
+    if (!vp->band_hash)
+    {
+        vp->band_hash_size = 0;
+        return;
+    }
+
+    for (int b = 0; b < nb_bands; b++)
+    {
+        uint64_t h = b;
+
+        for (int p = 0; p < nb_planes; p++)
+        {
+            int shift = (p == 1 || p == 2) ? desc->log2_chroma_h : 0;
+            int bytes = av_image_get_linesize(vp->format, vp->width, p);
+            int y1 = AV_CEIL_RSHIFT(FFMIN((b + 1) * UPLOAD_BAND_HEIGHT, vp->height), shift);
+
+            for (int y = AV_CEIL_RSHIFT(b * UPLOAD_BAND_HEIGHT, shift); y < y1; y++)
+            {
+                h = hash_bytes(vp->frame->data[p] + (ptrdiff_t)y * vp->frame->linesize[p], bytes, h);
+            }
+        }
+
+        vp->band_hash[b] = h;
+    }
+
+    vp->nb_bands = nb_bands;
+}
+
+static int queue_picture(VideoState *is, AVFrame *src_frame, double pts, double duration, int64_t pos, int serial)
+{
+    Frame *vp = frame_queue_peek_writable(&is->pictq);
+    if (!vp)
+    {
+        return -1;
+    }
+
+    vp->sar = src_frame->sample_aspect_ratio;
+    vp->uploaded = 0;
+    vp->attached = !!(is->video_st->disposition & AV_DISPOSITION_ATTACHED_PIC);
+
+    vp->width = src_frame->width;
+    vp->height = src_frame->height;
+    vp->format = src_frame->format;
+
+    vp->pts = pts;
+    vp->duration = duration;
+    vp->pos = pos;
+    vp->serial = serial;
+
+    set_default_window_size(vp->width, vp->height, vp->sar, is->rotation);
+
+    av_frame_move_ref(vp->frame, src_frame);
+
+    /* the decoder thread pays for the hashes, the display thread only compares them */
+    vp->nb_bands = 0;
+    if (skip_unchanged_uploads && !vp->attached)
+    {
+        frame_hash_bands(vp);
+    }
+
+    frame_queue_push(&is->pictq);
+
+    return 0;
+}
+
+static int get_video_frame(VideoState *is, AVFrame *frame)
+{
+    int got_picture = decoder_decode_frame(&is->viddec, frame, NULL);
+
+    if (got_picture < 0)
+    {
+        return -1;
+    }
+
+    if (got_picture)
+    {
+        double dpts = NAN;
+
+        if (frame->pts != AV_NOPTS_VALUE)
+        {
+            dpts = av_q2d(is->video_st->time_base) * frame->pts;
+        }
+
+        frame->sample_aspect_ratio = av_guess_sample_aspect_ratio(is->ic, is->video_st, frame);
+
+        if (framedrop > 0 || (framedrop && get_master_sync_type(is) != AV_SYNC_VIDEO_MASTER))
+        {
+            if (frame->pts != AV_NOPTS_VALUE)
+            {
+                double diff = dpts - get_master_clock(is);
+
+                if (!isnan(diff) && fabs(diff) < AV_NOSYNC_THRESHOLD &&
+                    diff - is->frame_last_filter_delay < 0 && // 如果diff < 0，说明已经时间已过，不能显示了，drop；frame_last_filter_delay用上次filter耗时估计本次耗时时间；dpts < (get_master_clock(is) + is->frame_last_filter_delay)，等效于认为在filter计算完后才拿到解码后的帧，此时，如果时间已过，则不能显示了。
+                    is->viddec.pkt_serial == is->vidclk.serial &&
+                    is->videoq.nb_packets)
+                {
+                    av_log(NULL, AV_LOG_ERROR, "drop early: %d\n", is->videoq.nb_packets);
+
+                    is->frame_drops_early++;
+
+                    av_frame_unref(frame);
+                    got_picture = 0;
+                }
+            }
+        }
+    }
+
+    return got_picture;
+}
+
+static int audio_thread(void *arg)
+{
+    VideoState *is = arg;
+
+    AVFrame *frame = av_frame_alloc();
+
+    if (!frame)
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    while (1)
+    {
+        int got_frame = decoder_decode_frame(&is->auddec, frame, NULL);
+        if (got_frame < 0)
+        {
+            goto the_end;
+        }
+
+        if (got_frame)
+        {
+            AVRational tb = (AVRational){1, frame->sample_rate};
+
+            if (decoder_drop_before_accurate_seek(&is->auddec,
+                                                  (frame->pts == AV_NOPTS_VALUE) ? NAN : frame->pts * av_q2d(tb),
+                                                  av_q2d((AVRational){frame->nb_samples, frame->sample_rate})))
+            {
+                av_frame_unref(frame);
+                continue;
+            }
+
+            Frame *af = frame_queue_peek_writable(&is->sampq);
+            if (!af)
+            {
+                goto the_end;
+            }
+
+            af->pts = (frame->pts == AV_NOPTS_VALUE) ? NAN : frame->pts * av_q2d(tb);
+            af->pos = frame->pkt_pos;
+            af->serial = is->auddec.pkt_serial;
+            af->duration = av_q2d((AVRational){frame->nb_samples, frame->sample_rate});
+
+            av_frame_move_ref(af->frame, frame);
+            frame_queue_push(&is->sampq);
+        }
+    }
+
+the_end:
+
+    av_frame_free(&frame);
+
+    return 0;
+}
+
+static int decoder_start(Decoder *d, int (*fn)(void *), void *arg)
+{
+    packet_queue_start(d->queue);
+    d->decoder_tid = SDL_CreateThread(fn, "decoder", arg);
+
+    if (!d->decoder_tid)
+    {
+        av_log(NULL, AV_LOG_ERROR, "SDL_CreateThread(): %s\n", SDL_GetError());
+        return AVERROR(ENOMEM);
+    }
+
+    return 0;
+}
+
+/* 8x8 Bayer matrix, 0 to 63 */
+static const uint8_t ordered_dither_8x8[8][8] = {
+    {0, 48, 12, 60, 3, 51, 15, 63},
+    {32, 16, 44, 28, 35, 19, 47, 31},
+    {8, 56, 4, 52, 11, 59, 7, 55},
+    {40, 24, 36, 20, 43, 27, 39, 23},
+    {2, 50, 14, 62, 1, 49, 13, 61},
+    {34, 18, 46, 30, 33, 17, 45, 29},
+    {10, 58, 6, 54, 9, 57, 5, 53},
+    {42, 26, 38, 22, 41, 25, 37, 21},
+};
+
+/* workers sharing one job at a time, the caller takes slices too */
+typedef struct SliceThreads
+{
+    SDL_Thread *threads[SLICE_THREADS_MAX];
+    int nb_threads;
+    SDL_mutex *mutex;
+    SDL_cond *work_cond;
+    SDL_cond *done_cond;
+    void (*fn)(void *arg, int job, int nb_jobs);
+    void *arg;
+    int nb_jobs, next_job, nb_done;
+    int quit;
+} SliceThreads;
+
+static int slice_threads_worker(void *arg)
+{
+    SliceThreads *st = arg;
+
+    SDL_LockMutex(st->mutex);
+
+    while (!st->quit)
+    {
+        if (st->next_job >= st->nb_jobs)
+        {
+            SDL_CondWait(st->work_cond, st->mutex);
+            continue;
+        }
+
+        int job = st->next_job++;
+
+        SDL_UnlockMutex(st->mutex);
+        st->fn(st->arg, job, st->nb_jobs);
+        SDL_LockMutex(st->mutex);
+
+        if (++st->nb_done == st->nb_jobs)
+        {
+            SDL_CondSignal(st->done_cond);
+        }
+    }
+
+    SDL_UnlockMutex(st->mutex);
+
+    return 0;
+}
+
+static void slice_threads_free(SliceThreads *st)
+{
+    if (st->mutex)
+    {
+        SDL_LockMutex(st->mutex);
+        st->quit = 1;
+        SDL_CondBroadcast(st->work_cond);
+        SDL_UnlockMutex(st->mutex);
+    }
+
+    for (int i = 0; i < st->nb_threads; i++)
+    {
+        SDL_WaitThread(st->threads[i], NULL);
+    }
+
+    SDL_DestroyCond(st->done_cond);
+    SDL_DestroyCond(st->work_cond);
+    SDL_DestroyMutex(st->mutex);
+
+    memset(st, 0, sizeof(*st));
+}
+
+/* nb_threads workers besides the caller, 0 for one per extra core; on failure the caller runs every slice alone */
+static int slice_threads_init(SliceThreads *st, int nb_threads, const char *name)
+{
+    memset(st, 0, sizeof(*st));
+
+    if (nb_threads <= 0)
+    {
+        nb_threads = SDL_GetCPUCount() - 1;
+    }
+
+    nb_threads = av_clip(nb_threads, 0, SLICE_THREADS_MAX);
+    if (!nb_threads)
+    {
+        return 0;
+    }
+
+    if (!(st->mutex = SDL_CreateMutex()) ||
+        !(st->work_cond = SDL_CreateCond()) ||
+        !(st->done_cond = SDL_CreateCond()))
+    {
+        av_log(NULL, AV_LOG_ERROR, "SDL_CreateMutex/Cond(): %s\n", SDL_GetError());
+        slice_threads_free(st);
+        return AVERROR(ENOMEM);
+    }
+
+    for (; st->nb_threads < nb_threads; st->nb_threads++)
+    {
+        if (!(st->threads[st->nb_threads] = SDL_CreateThread(slice_threads_worker, name, st)))
+        {
+            av_log(NULL, AV_LOG_WARNING, "SDL_CreateThread(): %s\n", SDL_GetError());
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/* run fn for jobs 0 to nb_jobs - 1 and wait for all of them */
+static void slice_threads_execute(SliceThreads *st, void (*fn)(void *arg, int job, int nb_jobs), void *arg, int nb_jobs)
+{
+    if (!st->nb_threads)
+    {
+        for (int job = 0; job < nb_jobs; job++)
+        {
+            fn(arg, job, nb_jobs);
+        }
+
+        return;
+    }
+
+    SDL_LockMutex(st->mutex);
+
+    st->fn = fn;
+    st->arg = arg;
+    st->nb_jobs = nb_jobs;
+    st->next_job = 0;
+    st->nb_done = 0;
+    SDL_CondBroadcast(st->work_cond);
+
+    while (st->next_job < st->nb_jobs)
+    {
+        int job = st->next_job++;
+
+        SDL_UnlockMutex(st->mutex);
+        fn(arg, job, nb_jobs);
+        SDL_LockMutex(st->mutex);
+
+        st->nb_done++;
+    }
+
+    while (st->nb_done < st->nb_jobs)
+    {
+        SDL_CondWait(st->done_cond, st->mutex);
+    }
+
+    st->nb_jobs = st->next_job = 0;
+
+    SDL_UnlockMutex(st->mutex);
+}
+
+/* what the LUT was built for, rebuilt when a frame differs */
+typedef struct ToneMapKey
+{
+    int trc;
+    int primaries;
+    int colorspace;
+    int range;
+    double peak; /* nits */
+} ToneMapKey;
+
+/*
+ * HDR to SDR mapping in the YUV domain: a TONEMAP_LUT_SIZE^3 grid indexed by the 16 bit Y, U and V codes
+ * holds the BT.709 8 bit result scaled by 64, interpolated tetrahedrally between grid points.
+ */
+typedef struct ToneMapper
+{
+    ToneMapKey key;
+    int16_t *lut[3]; /* [v][u][y] */
+    SliceThreads threads;
+    int threads_started;
+    const AVFrame *src;
+    AVFrame *dst;
+    int in_shift; /* left shift bringing a source word to a 16 bit code */
+    int semi_planar;
+} ToneMapper;
+
+static double pq_to_nits(double e)
+{
+    const double m1 = 2610.0 / 16384, m2 = 2523.0 / 4096 * 128;
+    const double c1 = 3424.0 / 4096, c2 = 2413.0 / 4096 * 32, c3 = 2392.0 / 4096 * 32;
+
+    double p = pow(FFMAX(e, 0), 1 / m2);
+
+    return 10000 * pow(FFMAX(p - c1, 0) / (c2 - c3 * p), 1 / m1);
+}
+
+static double nits_to_pq(double nits)
+{
+    const double m1 = 2610.0 / 16384, m2 = 2523.0 / 4096 * 128;
+    const double c1 = 3424.0 / 4096, c2 = 2413.0 / 4096 * 32, c3 = 2392.0 / 4096 * 32;
+
+    double y = pow(FFMAX(nits, 0) / 10000, m1);
+
+    return pow((c1 + c2 * y) / (1 + c3 * y), m2);
+}
+
+static double hlg_to_scene(double e)
+{
+    const double a = 0.17883277, b = 0.28466892, c = 0.55991073;
+
+    e = FFMAX(e, 0);
+
+    return e <= 0.5 ? e * e / 3 : (exp((e - c) / a) + b) / 12;
+}
+
+/* BT.2390 EETF on PQ codes, compresses the source peak down to the target peak above a knee */
+static double bt2390_eetf(double nits, double src_peak, double dst_peak)
+{
+    double src_pq = nits_to_pq(src_peak);
+    double max_lum = nits_to_pq(dst_peak) / src_pq;
+    double ks = 1.5 * max_lum - 0.5;
+    double e = nits_to_pq(nits) / src_pq;
+
+    if (e > ks)
+    {
+        double t = (e - ks) / (1 - ks);
+        double t2 = t * t, t3 = t2 * t;
+
+        e = (2 * t3 - 3 * t2 + 1) * ks + (t3 - 2 * t2 + t) * (1 - ks) + (-2 * t3 + 3 * t2) * max_lum;
+    }
+
+    return pq_to_nits(FFMIN(e, 1) * src_pq);
+}
+
+/* peak luminance of the content: frame side data first, then the stream's, then the HDR10 default */
+static double tone_map_peak(const AVFrame *frame, AVStream *st)
+{
+    if (frame->color_trc == AVCOL_TRC_ARIB_STD_B67)
+    {
+        return 1000;
+    }
+
+    AVFrameSideData *sd = av_frame_get_side_data(frame, AV_FRAME_DATA_CONTENT_LIGHT_LEVEL);
+    const AVContentLightMetadata *clm = sd ? (const AVContentLightMetadata *)sd->data
+                                           : (const AVContentLightMetadata *)av_stream_get_side_data(st, AV_PKT_DATA_CONTENT_LIGHT_LEVEL, NULL);
+    if (clm && clm->MaxCLL)
+    {
+        return clm->MaxCLL;
+    }
+
+    sd = av_frame_get_side_data(frame, AV_FRAME_DATA_MASTERING_DISPLAY_METADATA);
+    const AVMasteringDisplayMetadata *mdm = sd ? (const AVMasteringDisplayMetadata *)sd->data
+                                               : (const AVMasteringDisplayMetadata *)av_stream_get_side_data(st, AV_PKT_DATA_MASTERING_DISPLAY_METADATA, NULL);
+    if (mdm && mdm->has_luminance && mdm->max_luminance.num)
+    {
+        return av_q2d(mdm->max_luminance);
+    }
+
+    return 1000;
+}
+
+static int tone_mapper_build(ToneMapper *tm, const ToneMapKey *key)
+{
+    /* linear BT.2020 to BT.709 primaries */
+    static const double gamut[3][3] = {
+        {1.6605, -0.5876, -0.0728},
+        {-0.1246, 1.1329, -0.0083},
+        {-0.0182, -0.1006, 1.1187},
+    };
+    const int n = TONEMAP_LUT_SIZE;
+    int64_t start = av_gettime_relative();
+
+    for (int c = 0; c < 3; c++)
+    {
+        if (!tm->lut[c] && !(tm->lut[c] = av_malloc_array(n * n * n, sizeof(*tm->lut[c]))))
+        {
+            return AVERROR(ENOMEM);
+        }
+    }
+
+    int bt709 = key->colorspace == AVCOL_SPC_BT709;
+    double kr = bt709 ? 0.2126 : 0.2627, kb = bt709 ? 0.0722 : 0.0593, kg = 1 - kr - kb;
+    int full = key->range == AVCOL_RANGE_JPEG;
+
+    for (int iv = 0; iv < n; iv++)
+    {
+        for (int iu = 0; iu < n; iu++)
+        {
+            for (int iy = 0; iy < n; iy++)
+            {
+                /* grid point i sits on 10 bit code 32 * i */
+                double y = full ? iy * 32 / 1023.0 : (iy * 32 - 64) / 876.0;
+                double cb = full ? (iu * 32 - 512) / 1023.0 : (iu * 32 - 512) / 896.0;
+                double cr = full ? (iv * 32 - 512) / 1023.0 : (iv * 32 - 512) / 896.0;
+                double rgb[3] = {
+                    y + 2 * (1 - kr) * cr,
+                    y - 2 * kb * (1 - kb) / kg * cb - 2 * kr * (1 - kr) / kg * cr,
+                    y + 2 * (1 - kb) * cb,
+                };
+
+                /* to display light in nits */
+                if (key->trc == AVCOL_TRC_SMPTE2084)
+                {
+                    for (int c = 0; c < 3; c++)
+                    {
+                        rgb[c] = pq_to_nits(rgb[c]);
+                    }
+                }
+                else
+                {
+                    /* HLG OOTF for a 1000 nit display, system gamma 1.2 */
+                    for (int c = 0; c < 3; c++)
+                    {
+                        rgb[c] = hlg_to_scene(rgb[c]);
+                    }
+
+                    double ys = 0.2627 * rgb[0] + 0.6780 * rgb[1] + 0.0593 * rgb[2];
+                    for (int c = 0; c < 3; c++)
+                    {
+                        rgb[c] *= 1000 * pow(FFMAX(ys, 1e-6), 0.2);
+                    }
+                }
+
+                /* compress luminance, scaling the channels together keeps the hue */
+                double l = kr * rgb[0] + kg * rgb[1] + kb * rgb[2];
+                if (l > 1e-6 && key->peak > TONEMAP_SDR_WHITE)
+                {
+                    double scale = bt2390_eetf(l, key->peak, TONEMAP_SDR_WHITE) / l;
+                    for (int c = 0; c < 3; c++)
+                    {
+                        rgb[c] *= scale;
+                    }
+                }
+
+                for (int c = 0; c < 3; c++)
+                {
+                    rgb[c] /= TONEMAP_SDR_WHITE;
+                }
+
+                if (key->primaries == AVCOL_PRI_BT2020)
+                {
+                    double out[3];
+                    for (int c = 0; c < 3; c++)
+                    {
+                        out[c] = gamut[c][0] * rgb[0] + gamut[c][1] * rgb[1] + gamut[c][2] * rgb[2];
+                    }
+
+                    memcpy(rgb, out, sizeof(out));
+                }
+
+                /* out of gamut colors are desaturated toward their luminance rather than clipped per channel */
+                double l709 = 0.2126 * rgb[0] + 0.7152 * rgb[1] + 0.0722 * rgb[2];
+                double lo = FFMIN3(rgb[0], rgb[1], rgb[2]);
+                if (lo < 0 && l709 > 0)
+                {
+                    double t = l709 / (l709 - lo);
+                    for (int c = 0; c < 3; c++)
+                    {
+                        rgb[c] = l709 + t * (rgb[c] - l709);
+                    }
+                }
+
+                double hi = FFMAX3(rgb[0], rgb[1], rgb[2]);
+                for (int c = 0; c < 3; c++)
+                {
+                    rgb[c] = hi > 1 ? rgb[c] / hi : rgb[c];
+                    rgb[c] = pow(av_clipd(rgb[c], 0, 1), 1 / 2.4);
+                }
+
+                double yo = 0.2126 * rgb[0] + 0.7152 * rgb[1] + 0.0722 * rgb[2];
+                double out[3] = {
+                    16 + 219 * yo,
+                    128 + 224 * (rgb[2] - yo) / 1.8556,
+                    128 + 224 * (rgb[0] - yo) / 1.5748,
+                };
+
+                int i = (iv * n + iu) * n + iy;
+                for (int c = 0; c < 3; c++)
+                {
+                    tm->lut[c][i] = lrint(av_clipd(out[c], 0, 255) * 64);
+                }
+            }
+        }
+    }
+
+    tm->key = *key;
+
+    av_log(NULL, AV_LOG_VERBOSE, "tone map: %s, peak %.0f nits, LUT built in %.1f ms\n",
+           key->trc == AVCOL_TRC_SMPTE2084 ? "PQ" : "HLG", key->peak, (av_gettime_relative() - start) / 1000.0);
+
+    return 0;
+}
+
+/* grid cells of up to TONEMAP_CHUNK 16 bit Y, U, V triples split into four corners, weights summing to 32 */
+typedef struct ToneMapTetra
+{
+    int base[TONEMAP_CHUNK];
+    int o1[TONEMAP_CHUNK], o2[TONEMAP_CHUNK];
+    int w0[TONEMAP_CHUNK], w1[TONEMAP_CHUNK], w2[TONEMAP_CHUNK], w3[TONEMAP_CHUNK];
+} ToneMapTetra;
+
+/* the codes are the same grid walk for every pixel, so the tetrahedron is picked with min, max and selects, not branches */
+static void tone_map_tetra(ToneMapTetra *restrict t, const int *restrict y, const int *restrict u, const int *restrict v, int nb)
+{
+    const int n = TONEMAP_LUT_SIZE, dy = 1, du = n, dv = n * n;
+
+    for (int i = 0; i < nb; i++)
+    {
+        int fy = (y[i] >> 6) & 31, fu = (u[i] >> 6) & 31, fv = (v[i] >> 6) & 31;
+        int a = FFMAX3(fy, fu, fv), c = FFMIN3(fy, fu, fv), b = fy + fu + fv - a - c;
+
+        /* walk from the low corner to the high one along the axes in decreasing order of their fraction;
+           ties give a zero weight, so either order is the same tetrahedron */
+        int first = fy == a ? dy : fu == a ? du : dv;
+        int last = fv == c ? dv : fu == c ? du : dy;
+
+        t->base[i] = ((v[i] >> 11) * n + (u[i] >> 11)) * n + (y[i] >> 11);
+        t->o1[i] = first;
+        t->o2[i] = dy + du + dv - last;
+        t->w0[i] = 32 - a;
+        t->w1[i] = a - b;
+        t->w2[i] = b - c;
+        t->w3[i] = c;
+    }
+}
+
+/* 8 bit results from a LUT, dither[x & 7] adds 0 to 2047 before dropping the 11 fractional bits */
+static void tone_map_apply(uint8_t *restrict dst, const int16_t *restrict lut, const ToneMapTetra *restrict t, const int *dither, int x, int nb)
+{
+    const int n = TONEMAP_LUT_SIZE;
+
+    for (int i = 0; i < nb; i++)
+    {
+        const int16_t *p = lut + t->base[i];
+        int v = p[0] * t->w0[i] + p[t->o1[i]] * t->w1[i] + p[t->o2[i]] * t->w2[i] + p[1 + n + n * n] * t->w3[i];
+
+        dst[i] = av_clip_uint8((v + dither[(x + i) & 7]) >> 11);
+    }
+}
+
+/* one horizontal band of chroma rows and the luma rows they cover */
+static void tone_mapper_slice(void *arg, int job, int nb_jobs)
+{
+    ToneMapper *tm = arg;
+    const AVFrame *src = tm->src;
+    AVFrame *dst = tm->dst;
+    int w = src->width, h = src->height;
+    int cw = AV_CEIL_RSHIFT(w, 1), ch = AV_CEIL_RSHIFT(h, 1);
+    int s = tm->in_shift;
+    int code_y[TONEMAP_CHUNK], code_u[TONEMAP_CHUNK], code_v[TONEMAP_CHUNK];
+    int dither[8];
+    ToneMapTetra t;
+
+    for (int cy = ch * job / nb_jobs; cy < ch * (job + 1) / nb_jobs; cy++)
+    {
+        const uint16_t *su = (const uint16_t *)(src->data[1] + (ptrdiff_t)cy * src->linesize[1]);
+        const uint16_t *sv = tm->semi_planar ? su + 1 : (const uint16_t *)(src->data[2] + (ptrdiff_t)cy * src->linesize[2]);
+        int cstep = tm->semi_planar ? 2 : 1;
+        const uint16_t *sy[2];
+
+        for (int r = 0; r < 2; r++)
+        {
+            int y = FFMIN(2 * cy + r, h - 1);
+
+            sy[r] = (const uint16_t *)(src->data[0] + (ptrdiff_t)y * src->linesize[0]);
+            if (2 * cy + r >= h)
+            {
+                continue;
+            }
+
+            for (int k = 0; k < 8; k++)
+            {
+                dither[k] = reduce_depth_dither ? ordered_dither_8x8[y & 7][k] << 5 : 1024;
+            }
+
+            uint8_t *dy = dst->data[0] + (ptrdiff_t)y * dst->linesize[0];
+            for (int x0 = 0; x0 < w; x0 += TONEMAP_CHUNK)
+            {
+                int nb = FFMIN(w - x0, TONEMAP_CHUNK);
+
+                for (int i = 0; i < nb; i++)
+                {
+                    int x = x0 + i;
+
+                    code_y[i] = sy[r][x] << s;
+                    code_u[i] = su[(x >> 1) * cstep] << s;
+                    code_v[i] = sv[(x >> 1) * cstep] << s;
+                }
+
+                tone_map_tetra(&t, code_y, code_u, code_v, nb);
+                tone_map_apply(dy + x0, tm->lut[0], &t, dither, x0, nb);
+            }
+        }
+
+        /* chroma follows the average luma of its 2x2 block */
+        uint8_t *du = dst->data[1] + (ptrdiff_t)cy * dst->linesize[1];
+        uint8_t *dv = dst->data[2] + (ptrdiff_t)cy * dst->linesize[2];
+
+        for (int k = 0; k < 8; k++)
+        {
+            dither[k] = reduce_depth_dither ? ordered_dither_8x8[cy & 7][k] << 5 : 1024;
+        }
+
+        for (int x0 = 0; x0 < cw; x0 += TONEMAP_CHUNK)
+        {
+            int nb = FFMIN(cw - x0, TONEMAP_CHUNK);
+
+            for (int i = 0; i < nb; i++)
+            {
+                int x = x0 + i, x1 = FFMIN(2 * x + 1, w - 1);
+
+                code_y[i] = ((sy[0][2 * x] + sy[0][x1] + sy[1][2 * x] + sy[1][x1] + 2) >> 2) << s;
+                code_u[i] = su[x * cstep] << s;
+                code_v[i] = sv[x * cstep] << s;
+            }
+
+            tone_map_tetra(&t, code_y, code_u, code_v, nb);
+            tone_map_apply(du + x0, tm->lut[1], &t, dither, x0, nb);
+            tone_map_apply(dv + x0, tm->lut[2], &t, dither, x0, nb);
+        }
+    }
+}
+
+/* map src into the yuv420p dst, both of the same size */
+static int tone_mapper_run(ToneMapper *tm, AVFrame *dst, const AVFrame *src, AVStream *st)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(src->format);
+    ToneMapKey key = {
+        .trc = src->color_trc,
+        .primaries = src->color_primaries == AVCOL_PRI_BT709 ? AVCOL_PRI_BT709 : AVCOL_PRI_BT2020,
+        .colorspace = src->colorspace == AVCOL_SPC_BT709 ? AVCOL_SPC_BT709 : AVCOL_SPC_BT2020_NCL,
+        .range = src->color_range == AVCOL_RANGE_JPEG ? AVCOL_RANGE_JPEG : AVCOL_RANGE_MPEG,
+        .peak = av_clipd(tone_map_peak(src, st), TONEMAP_SDR_WHITE, 10000),
+    };
+    int ret;
+
+    if ((!tm->lut[0] || memcmp(&key, &tm->key, sizeof(key))) && (ret = tone_mapper_build(tm, &key)) < 0)
+    {
+        return ret;
+    }
+
+    if (!tm->threads_started)
+    {
+        slice_threads_init(&tm->threads, tonemap_threads, "tonemap");
+        tm->threads_started = 1;
+    }
+
+    tm->src = src;
+    tm->dst = dst;
+    tm->in_shift = 16 - desc->comp[0].depth - desc->comp[0].shift;
+    tm->semi_planar = desc->comp[1].plane == desc->comp[2].plane;
+
+    /* a few slices per thread even out workers that start late */
+    int nb_jobs = FFMIN(AV_CEIL_RSHIFT(src->height, 1), 4 * (tm->threads.nb_threads + 1));
+    slice_threads_execute(&tm->threads, tone_mapper_slice, tm, nb_jobs);
+
+    dst->color_trc = AVCOL_TRC_BT709;
+    dst->color_primaries = AVCOL_PRI_BT709;
+    dst->colorspace = AVCOL_SPC_BT709;
+    dst->color_range = AVCOL_RANGE_MPEG;
+    av_frame_remove_side_data(dst, AV_FRAME_DATA_MASTERING_DISPLAY_METADATA);
+    av_frame_remove_side_data(dst, AV_FRAME_DATA_CONTENT_LIGHT_LEVEL);
+
+    return 0;
+}
+
+static void tone_mapper_free(ToneMapper *tm)
+{
+    slice_threads_free(&tm->threads);
+
+    for (int c = 0; c < 3; c++)
+    {
+        av_freep(&tm->lut[c]);
+    }
+}
+
+/* decoder thread state of the reduction to yuv420p of pictures the renderer has no texture for */
+typedef struct PictureReducer
+{
+    AVBufferPool *pool; /* the planes that have to be computed, pool_size bytes */
+    int pool_size;
+    AVBufferRef *gray_chroma; /* constant chroma planes shared by every gray picture of one size */
+    uint16_t *dither; /* 8 rows of dither_width values added before the shift */
+    int dither_width, dither_shift;
+    AVFrame *out;
+    ToneMapper tm; /* PQ and HLG pictures are tone mapped instead of just reduced */
+    int64_t time, tm_time;
+    int nb_frames, nb_tm_frames;
+    int failed;
+    int tm_too_slow; /* tone mapping missed the frame interval, PQ and HLG are only reduced from then on */
+} PictureReducer;
+
+/* a decoder format the reducer knows how to turn into yuv420p */
+typedef struct ReduceLayout
+{
+    int shift; /* bits to drop to get 8 bit samples, 0 for 8 bit formats */
+    int log2_chroma_w, log2_chroma_h;
+    int gray;
+    int semi_planar; /* P010/P016, samples in the high bits of each 16 bit word */
+} ReduceLayout;
+
+/*
+ * Planar 4:2:0, 4:2:2, 4:4:4 and gray at 8 to 16 bits in native endianness, alpha dropped,
+ * plus the semi-planar P010/P016. yuv420p itself has a texture and is not handled.
+ */
+static int picture_reducer_layout(int format, ReduceLayout *l)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(format);
+
+    if (!desc || format == AV_PIX_FMT_YUV420P ||
+        (desc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_FLOAT | AV_PIX_FMT_FLAG_BITSTREAM)) ||
+        !!(desc->flags & AV_PIX_FMT_FLAG_BE) != AV_HAVE_BIGENDIAN)
+    {
+        return 0;
+    }
+
+    const AVComponentDescriptor *y = &desc->comp[0];
+    if (y->plane != 0 || y->depth < 8 || y->depth > 16 || y->step != (y->depth > 8 ? 2 : 1))
+    {
+        return 0;
+    }
+
+    memset(l, 0, sizeof(*l));
+    l->shift = y->shift + y->depth - 8;
+    l->log2_chroma_w = desc->log2_chroma_w;
+    l->log2_chroma_h = desc->log2_chroma_h;
+
+    if (desc->nb_components == 1)
+    {
+        l->gray = 1;
+        return 1;
+    }
+
+    int is_420 = l->log2_chroma_w == 1 && l->log2_chroma_h == 1;
+    int is_422 = l->log2_chroma_w == 1 && !l->log2_chroma_h;
+    int is_444 = !l->log2_chroma_w && !l->log2_chroma_h;
+    if (desc->nb_components < 3 || (!is_420 && !is_422 && !is_444))
+    {
+        return 0;
+    }
+
+    const AVComponentDescriptor *u = &desc->comp[1], *v = &desc->comp[2];
+    if (u->depth != y->depth || v->depth != y->depth)
+    {
+        return 0;
+    }
+
+    if (u->plane == 1 && v->plane == 2 && u->step == y->step && v->step == y->step)
+    {
+        return 1;
+    }
+
+    l->semi_planar = u->plane == 1 && v->plane == 1 && u->step == 4 && y->depth > 8 && is_420;
+
+    return l->semi_planar;
+}
+
+/* kept free of the dither lookup and of branches so the compiler turns it into wide adds, shifts and packs */
+static void reduce_depth_row(uint8_t *restrict dst, const uint16_t *restrict src, const uint16_t *restrict dither, int w, int shift)
+{
+    for (int x = 0; x < w; x++)
+    {
+        unsigned v = (unsigned)(src[x] + dither[x]) >> shift;
+        dst[x] = v > 255 ? 255 : v;
+    }
+}
+
+/* the same for an interleaved UV row of P010/P016 */
+static void reduce_depth_row_uv(uint8_t *restrict dst_u, uint8_t *restrict dst_v, const uint16_t *restrict src, const uint16_t *restrict dither, int w, int shift)
+{
+    for (int x = 0; x < w; x++)
+    {
+        unsigned u = (unsigned)(src[2 * x] + dither[x]) >> shift;
+        unsigned v = (unsigned)(src[2 * x + 1] + dither[x]) >> shift;
+        dst_u[x] = u > 255 ? 255 : u;
+        dst_v[x] = v > 255 ? 255 : v;
+    }
+}
+
+/* 4:2:2 chroma, the average of two rows */
+static void reduce_depth_rows(uint8_t *restrict dst, const uint16_t *restrict a, const uint16_t *restrict b, const uint16_t *restrict dither, int w, int shift)
+{
+    for (int x = 0; x < w; x++)
+    {
+        unsigned v = (unsigned)(a[x] + b[x] + 2 * dither[x]) >> (shift + 1);
+        dst[x] = v > 255 ? 255 : v;
+    }
+}
+
+/* 4:4:4 chroma, the average of 2x2 blocks; w output samples from src_w source samples */
+static void reduce_depth_blocks(uint8_t *restrict dst, const uint16_t *restrict a, const uint16_t *restrict b, const uint16_t *restrict dither, int w, int src_w, int shift)
+{
+    int x = 0;
+
+    for (; x < src_w >> 1; x++)
+    {
+        unsigned v = (unsigned)(a[2 * x] + a[2 * x + 1] + b[2 * x] + b[2 * x + 1] + 4 * dither[x]) >> (shift + 2);
+        dst[x] = v > 255 ? 255 : v;
+    }
+
+    for (; x < w; x++)
+    {
+        unsigned v = (unsigned)(a[2 * x] + b[2 * x] + 2 * dither[x]) >> (shift + 1);
+        dst[x] = v > 255 ? 255 : v;
+    }
+}
+
+static void decimate_rows(uint8_t *restrict dst, const uint8_t *restrict a, const uint8_t *restrict b, int w)
+{
+    for (int x = 0; x < w; x++)
+    {
+        dst[x] = (a[x] + b[x] + 1) >> 1;
+    }
+}
+
+static void decimate_blocks(uint8_t *restrict dst, const uint8_t *restrict a, const uint8_t *restrict b, int w, int src_w)
+{
+    int x = 0;
+
+    for (; x < src_w >> 1; x++)
+    {
+        dst[x] = (a[2 * x] + a[2 * x + 1] + b[2 * x] + b[2 * x + 1] + 2) >> 2;
+    }
+
+    for (; x < w; x++)
+    {
+        dst[x] = (a[2 * x] + b[2 * x] + 1) >> 1;
+    }
+}
+
+/* expand the 8x8 matrix to full rows once per width, so the row kernels read it linearly */
+static int picture_reducer_dither(PictureReducer *r, int width, int shift)
+{
+    if (r->dither && r->dither_width == width && r->dither_shift == shift)
+    {
+        return 0;
+    }
+
+    av_freep(&r->dither);
+    r->dither = av_malloc_array(8 * (size_t)width, sizeof(*r->dither));
+    if (!r->dither)
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    for (int y = 0; y < 8; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            int d = ordered_dither_8x8[y][x & 7];
+
+            /* spread 0..63 over one output step, or plain rounding without dithering */
+            r->dither[y * width + x] = !reduce_depth_dither ? 1 << (shift - 1) : shift >= 6 ? d << (shift - 6) : d >> (6 - shift);
+        }
+    }
+
+    r->dither_width = width;
+    r->dither_shift = shift;
+
+    return 0;
+}
+
+/* neutral chroma for gray pictures, filled once and referenced by every picture */
+static AVBufferRef *picture_reducer_gray(PictureReducer *r, int size)
+{
+    if (!r->gray_chroma || r->gray_chroma->size != (size_t)size)
+    {
+        av_buffer_unref(&r->gray_chroma);
+        if (!(r->gray_chroma = av_buffer_alloc(size)))
+        {
+            return NULL;
+        }
+
+        memset(r->gray_chroma->data, 128, size);
+    }
+
+    return r->gray_chroma;
+}
+
+/* one output chroma plane from source plane p */
+static void picture_reducer_chroma(PictureReducer *r, uint8_t *dst, int dst_linesize, const AVFrame *frame, int p, const ReduceLayout *l)
+{
+    int w = frame->width, h = frame->height;
+    int cw = AV_CEIL_RSHIFT(w, 1), ch = AV_CEIL_RSHIFT(h, 1);
+    int src_w = AV_CEIL_RSHIFT(w, l->log2_chroma_w), src_h = AV_CEIL_RSHIFT(h, l->log2_chroma_h);
+
+    for (int y = 0; y < ch; y++)
+    {
+        /* full height chroma averages two rows, or takes the first one in the fast mode */
+        int y0 = l->log2_chroma_h ? y : 2 * y;
+        int y1 = l->log2_chroma_h || chroma_decimate_fast ? y0 : FFMIN(y0 + 1, src_h - 1);
+        const uint8_t *a = frame->data[p] + (ptrdiff_t)y0 * frame->linesize[p];
+        const uint8_t *b = frame->data[p] + (ptrdiff_t)y1 * frame->linesize[p];
+        const uint16_t *dither = r->dither + (y & 7) * w;
+        uint8_t *d = dst + (ptrdiff_t)y * dst_linesize;
+
+        if (!l->shift)
+        {
+            if (l->log2_chroma_w)
+            {
+                decimate_rows(d, a, b, cw);
+            }
+            else
+            {
+                decimate_blocks(d, a, b, cw, src_w);
+            }
+        }
+        else if (!l->log2_chroma_w)
+        {
+            reduce_depth_blocks(d, (const uint16_t *)a, (const uint16_t *)b, dither, cw, src_w, l->shift);
+        }
+        else if (y0 != y1)
         {
-            video_display(is);
+            reduce_depth_rows(d, (const uint16_t *)a, (const uint16_t *)b, dither, cw, l->shift);
+        }
+        else
+        {
+            reduce_depth_row(d, (const uint16_t *)a, dither, cw, l->shift);
         }
-    }
-
-    is->force_refresh = 0;
-
-    if (show_status)
-    {
-        show_status_in_video_refresh(is);
     }
 }
 
-static int queue_picture(VideoState *is, AVFrame *src_frame, double pts, double duration, int64_t pos, int serial)
+/* add a reference to the buffer behind plane p of frame to out */
+static int picture_reducer_ref_plane(AVFrame *out, int *nb_bufs, AVFrame *frame, int p)
 {
-    Frame *vp = frame_queue_peek_writable(&is->pictq);
-    if (!vp)
+    AVBufferRef *buf = av_frame_get_plane_buffer(frame, p);
+    if (!buf || !(out->buf[*nb_bufs] = av_buffer_ref(buf)))
     {
-        return -1;
+        return AVERROR(ENOMEM);
     }
 
-    vp->sar = src_frame->sample_aspect_ratio;
-    vp->uploaded = 0;
-
-    vp->width = src_frame->width;
-    vp->height = src_frame->height;
-    vp->format = src_frame->format;
-
-    vp->pts = pts;
-    vp->duration = duration;
-    vp->pos = pos;
-    vp->serial = serial;
-
-    set_default_window_size(vp->width, vp->height, vp->sar);
-
-    av_frame_move_ref(vp->frame, src_frame);
-    frame_queue_push(&is->pictq);
+    (*nb_bufs)++;
 
     return 0;
 }
 
-static int get_video_frame(VideoState *is, AVFrame *frame)
+/*
+ * Replace frame with its yuv420p reduction, frame is left untouched on failure.
+ * 8 bit luma and chroma that already has the 4:2:0 rows are referenced, not copied.
+ */
+static int picture_reducer_run(PictureReducer *r, AVFrame *frame, const ReduceLayout *l, int tone_map, AVStream *st)
 {
-    int got_picture = decoder_decode_frame(&is->viddec, frame, NULL);
+    int w = frame->width, h = frame->height;
+    int ch = AV_CEIL_RSHIFT(h, 1);
+    int luma_linesize = FFALIGN(w, 32), chroma_linesize = FFALIGN(AV_CEIL_RSHIFT(w, 1), 32);
+    int copy_luma = l->shift > 0;
+    int ref_chroma = !l->gray && !l->shift && l->log2_chroma_w && (l->log2_chroma_h || chroma_decimate_fast);
+    int copy_chroma = !l->gray && !ref_chroma;
+    int size = (copy_luma ? luma_linesize * h : 0) + (copy_chroma ? 2 * chroma_linesize * ch : 0);
+    int nb_bufs = 0;
+    int ret;
 
-    if (got_picture < 0)
+    if (l->shift && (ret = picture_reducer_dither(r, w, l->shift)) < 0)
     {
-        return -1;
+        return ret;
     }
 
-    if (got_picture)
+    if (size && (!r->pool || r->pool_size != size))
     {
-        double dpts = NAN;
+        /* pictures still queued keep the old pool alive until they are released */
+        av_buffer_pool_uninit(&r->pool);
+        r->pool = av_buffer_pool_init(size, av_buffer_allocz);
+        if (!r->pool)
+        {
+            return AVERROR(ENOMEM);
+        }
 
-        if (frame->pts != AV_NOPTS_VALUE)
+        r->pool_size = size;
+    }
+
+    if (!r->out && !(r->out = av_frame_alloc()))
+    {
+        return AVERROR(ENOMEM);
+    }
+
+    AVFrame *out = r->out;
+    uint8_t *base = NULL;
+
+    if (size)
+    {
+        if (!(out->buf[nb_bufs] = av_buffer_pool_get(r->pool)))
         {
-            dpts = av_q2d(is->video_st->time_base) * frame->pts;
+            return AVERROR(ENOMEM);
         }
 
-        frame->sample_aspect_ratio = av_guess_sample_aspect_ratio(is->ic, is->video_st, frame);
+        base = out->buf[nb_bufs++]->data;
+    }
 
-        if (framedrop > 0 || (framedrop && get_master_sync_type(is) != AV_SYNC_VIDEO_MASTER))
+    if (copy_luma)
+    {
+        out->data[0] = base;
+        out->linesize[0] = luma_linesize;
+        base += luma_linesize * h;
+    }
+    else
+    {
+        if ((ret = picture_reducer_ref_plane(out, &nb_bufs, frame, 0)) < 0)
         {
-            if (frame->pts != AV_NOPTS_VALUE)
-            {
-                double diff = dpts - get_master_clock(is);
+            goto fail;
+        }
 
-                if (!isnan(diff) && fabs(diff) < AV_NOSYNC_THRESHOLD &&
-                    diff - is->frame_last_filter_delay < 0 && // 如果diff < 0，说明已经时间已过，不能显示了，drop；frame_last_filter_delay用上次filter耗时估计本次耗时时间；dpts < (get_master_clock(is) + is->frame_last_filter_delay)，等效于认为在filter计算完后才拿到解码后的帧，此时，如果时间已过，则不能显示了。
-                    is->viddec.pkt_serial == is->vidclk.serial &&
-                    is->videoq.nb_packets)
-                {
-                    av_log(NULL, AV_LOG_ERROR, "drop early: %d\n", is->videoq.nb_packets);
+        out->data[0] = frame->data[0];
+        out->linesize[0] = frame->linesize[0];
+    }
 
-                    is->frame_drops_early++;
+    if (l->gray)
+    {
+        AVBufferRef *gray = picture_reducer_gray(r, chroma_linesize * ch);
+        if (!gray || !(out->buf[nb_bufs++] = av_buffer_ref(gray)))
+        {
+            ret = AVERROR(ENOMEM);
+            goto fail;
+        }
 
-                    av_frame_unref(frame);
-                    got_picture = 0;
-                }
+        out->data[1] = out->data[2] = gray->data;
+        out->linesize[1] = out->linesize[2] = chroma_linesize;
+    }
+    else if (ref_chroma)
+    {
+        /* 4:2:2 in the fast mode skips every other row through the pitch */
+        for (int p = 1; p < 3; p++)
+        {
+            if ((ret = picture_reducer_ref_plane(out, &nb_bufs, frame, p)) < 0)
+            {
+                goto fail;
             }
+
+            out->data[p] = frame->data[p];
+            out->linesize[p] = frame->linesize[p] << (1 - l->log2_chroma_h);
         }
     }
+    else
+    {
+        out->data[1] = base;
+        out->data[2] = base + chroma_linesize * ch;
+        out->linesize[1] = out->linesize[2] = chroma_linesize;
+    }
 
-    return got_picture;
-}
-
-static int audio_thread(void *arg)
-{
-    VideoState *is = arg;
-
-    AVFrame *frame = av_frame_alloc();
+    out->format = AV_PIX_FMT_YUV420P;
+    out->width = w;
+    out->height = h;
 
-    if (!frame)
+    if ((ret = av_frame_copy_props(out, frame)) < 0)
     {
-        return AVERROR(ENOMEM);
+        goto fail;
     }
 
-    while (1)
+    if (tone_map)
     {
-        int got_frame = decoder_decode_frame(&is->auddec, frame, NULL);
-        if (got_frame < 0)
+        if ((ret = tone_mapper_run(&r->tm, out, frame, st)) < 0)
         {
-            goto the_end;
+            goto fail;
         }
-
-        if (got_frame)
+    }
+    else
+    {
+        if (copy_luma)
         {
-            AVRational tb = (AVRational){1, frame->sample_rate};
+            for (int y = 0; y < h; y++)
+            {
+                reduce_depth_row(out->data[0] + y * out->linesize[0],
+                                 (const uint16_t *)(frame->data[0] + (ptrdiff_t)y * frame->linesize[0]),
+                                 r->dither + (y & 7) * w, w, l->shift);
+            }
+        }
 
-            Frame *af = frame_queue_peek_writable(&is->sampq);
-            if (!af)
+        if (l->semi_planar)
+        {
+            for (int y = 0; y < ch; y++)
             {
-                goto the_end;
+                reduce_depth_row_uv(out->data[1] + y * out->linesize[1], out->data[2] + y * out->linesize[2],
+                                    (const uint16_t *)(frame->data[1] + (ptrdiff_t)y * frame->linesize[1]),
+                                    r->dither + (y & 7) * w, AV_CEIL_RSHIFT(w, 1), l->shift);
             }
+        }
+        else if (copy_chroma)
+        {
+            picture_reducer_chroma(r, out->data[1], out->linesize[1], frame, 1, l);
+            picture_reducer_chroma(r, out->data[2], out->linesize[2], frame, 2, l);
+        }
+    }
 
-            af->pts = (frame->pts == AV_NOPTS_VALUE) ? NAN : frame->pts * av_q2d(tb);
-            af->pos = frame->pkt_pos;
-            af->serial = is->auddec.pkt_serial;
-            af->duration = av_q2d((AVRational){frame->nb_samples, frame->sample_rate});
+    av_frame_unref(frame);
+    av_frame_move_ref(frame, out);
 
-            av_frame_move_ref(af->frame, frame);
-            frame_queue_push(&is->sampq);
-        }
+    return 0;
+
+fail:
+    av_frame_unref(out);
+
+    return ret;
+}
+
+/* tone mapped frames averaged before the cost is compared with the frame interval */
+#define TONEMAP_PROBE_FRAMES 32
+
+/*
+ * The renderer only has IYUV among the planar YUV textures. Reduce everything else that is planar here
+ * instead of converting it to BGRA with sws_scale on the display thread, which also uploads 2.7 times the bytes.
+ * frame_duration is the stream's frame interval in seconds, 0 when unknown.
+ */
+static void picture_reducer_frame(PictureReducer *r, AVFrame *frame, AVStream *st, double frame_duration)
+{
+    ReduceLayout l;
+    if (!picture_reducer_layout(frame->format, &l) || frame->linesize[0] <= 0 ||
+        (!l.gray && (frame->linesize[1] <= 0 || (!l.semi_planar && frame->linesize[2] <= 0))))
+    {
+        return;
     }
 
-the_end:
+    int tone_map = tonemap_hdr && !r->tm_too_slow && l.shift && !l.gray && l.log2_chroma_w && l.log2_chroma_h &&
+                   (frame->color_trc == AVCOL_TRC_SMPTE2084 || frame->color_trc == AVCOL_TRC_ARIB_STD_B67);
+    int64_t start = av_gettime_relative();
+    int ret = picture_reducer_run(r, frame, &l, tone_map, st);
+    if (ret < 0)
+    {
+        if (!r->failed)
+        {
+            av_log(NULL, AV_LOG_WARNING, "Cannot reduce %s to yuv420p, converting at upload: %s\n",
+                   av_get_pix_fmt_name(frame->format), av_err2str(ret));
+            r->failed = 1;
+        }
 
-    av_frame_free(&frame);
+        return;
+    }
 
-    return 0;
+    if (tone_map)
+    {
+        r->tm_time += av_gettime_relative() - start;
+        r->nb_tm_frames++;
+
+        /* the decoder needs part of the interval too, more than half of it on tone mapping falls behind */
+        if (r->nb_tm_frames == TONEMAP_PROBE_FRAMES && frame_duration > 0 &&
+            r->tm_time / r->nb_tm_frames > frame_duration * 1000000 / 2)
+        {
+            av_log(NULL, AV_LOG_WARNING,
+                   "Tone mapping takes %.2f ms per frame on %d threads for a %.2f ms frame interval, "
+                   "showing HDR without tone mapping from now on\n",
+                   r->tm_time / 1000.0 / r->nb_tm_frames, r->tm.threads.nb_threads + 1, frame_duration * 1000);
+            r->tm_too_slow = 1;
+        }
+    }
+    else
+    {
+        r->time += av_gettime_relative() - start;
+        r->nb_frames++;
+    }
 }
 
-static int decoder_start(Decoder *d, int (*fn)(void *), void *arg)
+static void picture_reducer_free(PictureReducer *r)
 {
-    packet_queue_start(d->queue);
-    d->decoder_tid = SDL_CreateThread(fn, "decoder", arg);
+    if (r->nb_frames)
+    {
+        av_log(NULL, AV_LOG_VERBOSE, "video: %d pictures reduced to yuv420p, %.2f ms average\n",
+               r->nb_frames, r->time / 1000.0 / r->nb_frames);
+    }
 
-    if (!d->decoder_tid)
+    if (r->nb_tm_frames)
     {
-        av_log(NULL, AV_LOG_ERROR, "SDL_CreateThread(): %s\n", SDL_GetError());
-        return AVERROR(ENOMEM);
+        av_log(NULL, AV_LOG_VERBOSE, "video: %d pictures tone mapped on %d threads, %.2f ms average\n",
+               r->nb_tm_frames, r->tm.threads.nb_threads + 1, r->tm_time / 1000.0 / r->nb_tm_frames);
     }
 
-    return 0;
+    tone_mapper_free(&r->tm);
+
+    av_buffer_pool_uninit(&r->pool);
+    av_buffer_unref(&r->gray_chroma);
+    av_freep(&r->dither);
+    av_frame_free(&r->out);
 }
 
 static int video_thread(void *arg)
@@ -2114,6 +8853,7 @@ static int video_thread(void *arg)
 
     AVRational tb = is->video_st->time_base;
     AVRational frame_rate = av_guess_frame_rate(is->ic, is->video_st, NULL);
+    PictureReducer reducer = {0};
 
     while (1)
     {
@@ -2131,8 +8871,33 @@ static int video_thread(void *arg)
         double duration = (frame_rate.num && frame_rate.den ? av_q2d((AVRational){frame_rate.den, frame_rate.num}) : 0);
         double pts = (frame->pts == AV_NOPTS_VALUE) ? NAN : frame->pts * av_q2d(tb);
 
+        if (decoder_drop_before_accurate_seek(&is->viddec, pts, duration))
+        {
+            av_frame_unref(frame);
+            continue;
+        }
+
+        picture_reducer_frame(&reducer, frame, is->video_st, duration);
+
+        /* keep the decoded album art, the read thread requeues it after seeks instead of the packet */
+        AVFrame *attached_pic = NULL;
+        if ((is->video_st->disposition & AV_DISPOSITION_ATTACHED_PIC) && !is->attached_pic.frame)
+        {
+            attached_pic = av_frame_clone(frame);
+        }
+
         ret = queue_picture(is, frame, pts, duration, frame->pkt_pos, is->viddec.pkt_serial);
 
+        if (attached_pic)
+        {
+            SDL_LockMutex(is->pictq.mutex);
+            is->attached_pic.frame = attached_pic;
+            is->attached_pic.pts = pts;
+            is->attached_pic.duration = duration;
+            is->attached_pic.pos = attached_pic->pkt_pos;
+            SDL_UnlockMutex(is->pictq.mutex);
+        }
+
         av_frame_unref(frame);
 
         if (ret < 0)
@@ -2144,6 +8909,76 @@ static int video_thread(void *arg)
 the_end:
 
     av_frame_free(&frame);
+    picture_reducer_free(&reducer);
+
+    return 0;
+}
+
+/* expand PAL8 indexes through the palette, kept plain so the vectorizer widens the indexes and packs the stores */
+static void subtitle_expand_palette(uint32_t *restrict dst, const uint8_t *restrict src, int w, const uint32_t *restrict pal)
+{
+    for (int x = 0; x < w; x++)
+    {
+        dst[x] = pal[src[x]];
+    }
+}
+
+/* clip the rects to the canvas and rasterize them into sp->sub_pixels, ready for SDL_UpdateTexture */
+static int subtitle_rasterize(Frame *sp)
+{
+    size_t size = 0;
+
+    for (unsigned i = 0; i < sp->sub.num_rects; i++)
+    {
+        AVSubtitleRect *sub_rect = sp->sub.rects[i];
+
+        /* the canvas size may only be known at display time, then the upload clips */
+        if (sp->width && sp->height)
+        {
+            sub_rect->x = av_clip(sub_rect->x, 0, sp->width);
+            sub_rect->y = av_clip(sub_rect->y, 0, sp->height);
+            sub_rect->w = av_clip(sub_rect->w, 0, sp->width - sub_rect->x);
+            sub_rect->h = av_clip(sub_rect->h, 0, sp->height - sub_rect->y);
+        }
+        else
+        {
+            sub_rect->x = FFMAX(sub_rect->x, 0);
+            sub_rect->y = FFMAX(sub_rect->y, 0);
+        }
+
+        size += (size_t)sub_rect->w * sub_rect->h * 4;
+    }
+
+    if (size > INT_MAX)
+    {
+        return AVERROR(EINVAL);
+    }
+
+    av_fast_malloc(&sp->sub_pixels, &sp->sub_pixels_size, FFMAX(size, 1));
+    if (!sp->sub_pixels)
+    {
+        sp->sub_pixels_size = 0;
+        return AVERROR(ENOMEM);
+    }
+
+    uint32_t *dst = (uint32_t *)sp->sub_pixels;
+
+    for (unsigned i = 0; i < sp->sub.num_rects; i++)
+    {
+        AVSubtitleRect *sub_rect = sp->sub.rects[i];
+        uint32_t pal[256] = {0};
+
+        /* PAL8 palettes are native endian ARGB, the texture format, entries past nb_colors stay transparent */
+        if (sub_rect->data[1])
+        {
+            memcpy(pal, sub_rect->data[1], av_clip(sub_rect->nb_colors, 0, 256) * 4);
+        }
+
+        for (int y = 0; y < sub_rect->h; y++, dst += sub_rect->w)
+        {
+            subtitle_expand_palette(dst, sub_rect->data[0] + y * sub_rect->linesize[0], sub_rect->w, pal);
+        }
+    }
 
     return 0;
 }
@@ -2169,7 +9004,7 @@ static int subtitle_thread(void *arg)
 
         double pts = 0;
 
-        if (got_subtitle && sp->sub.format == 0)
+        if (got_subtitle && (sp->sub.format == 0 || sp->sub.format == 1))
         {
             if (sp->sub.pts != AV_NOPTS_VALUE)
             {
@@ -2182,6 +9017,55 @@ static int subtitle_thread(void *arg)
             sp->height = is->subdec.avctx->height;
             sp->uploaded = 0;
 
+            int ret;
+
+            if (sp->sub.format == 1)
+            {
+                /* text is laid out on the video canvas, it has no size of its own */
+                if (is->video_st && is->video_st->codecpar->width > 0 && is->video_st->codecpar->height > 0)
+                {
+                    sp->width = is->video_st->codecpar->width;
+                    sp->height = is->video_st->codecpar->height;
+                }
+                else if (!sp->width || !sp->height)
+                {
+                    sp->width = 1280;
+                    sp->height = 720;
+                }
+
+                if (!is->text && !(is->text = av_mallocz(sizeof(TextRenderer))))
+                {
+                    ret = AVERROR(ENOMEM);
+                }
+                else
+                {
+                    int64_t start = av_gettime_relative();
+
+                    ret = subtitle_render_text(is->text, sp);
+
+                    TextRenderer *tr = is->text;
+                    int64_t elapsed = av_gettime_relative() - start;
+
+                    tr->render_time += elapsed;
+                    tr->nb_rendered++;
+
+                    av_log(NULL, AV_LOG_VERBOSE, "text subtitle: %d rects in %.2f ms, average %.2f ms, glyph cache %d entries %.1f%% hits\n",
+                           sp->sub.num_rects, elapsed / 1000.0, tr->render_time / 1000.0 / tr->nb_rendered,
+                           tr->nb_glyphs, 100.0 * tr->hits / FFMAX(tr->hits + tr->misses, 1));
+                }
+            }
+            else
+            {
+                ret = subtitle_rasterize(sp);
+            }
+
+            if (ret < 0)
+            {
+                av_log(NULL, AV_LOG_WARNING, "Cannot rasterize the subtitle, dropped\n");
+                avsubtitle_free(&sp->sub);
+                continue;
+            }
+
             /* now we can update the picture count */
             frame_queue_push(&is->subpq);
         }
@@ -2421,6 +9305,18 @@ static int audio_decode_frame(VideoState *is)
         resampled_data_size = data_size;
     }
 
+    /*
+     * what is about to be played, for the waves and spectrum display. This stays in the audio callback:
+     * only here do the samples exist resampled to the device format and in play order. The write is a
+     * bounded memcpy into a preallocated ring with no lock, allocation or system call; the FFT and all
+     * drawing run on the render thread.
+     */
+    if (is->vis.ring)
+    {
+        sample_ring_write(is->vis.ring, (const int16_t *)is->audio_buf, is->audio_tgt.ch_layout.nb_channels,
+                          resampled_data_size / is->audio_tgt.frame_size);
+    }
+
     /* update the audio clock with the pts */
     update_audio_pts(is, af);
 
@@ -2609,10 +9505,8 @@ static int audio_open(void *opaque, AVChannelLayout *wanted_channel_layout, int
     return spec.size;
 }
 
-static int open_decoder(VideoState *is, AVCodec *codec, AVCodecContext *avctx, int stream_index)
+static int open_decoder(AVFormatContext *ic, AVCodec *codec, AVCodecContext *avctx, int stream_index)
 {
-    AVFormatContext *ic = is->ic;
-
     int stream_lowres = lowres;
 
     avctx->pkt_timebase = ic->streams[stream_index]->time_base;
@@ -2693,10 +9587,8 @@ static int find_decoder(VideoState *is, AVCodecContext *avctx, int stream_index,
     return 0;
 }
 
-static int stream_component_open_audio(VideoState *is, AVCodecContext *avctx, int stream_index)
+static int stream_component_open_audio(VideoState *is, AVFormatContext *ic, AVCodecContext *avctx, int stream_index)
 {
-    AVFormatContext *ic = is->ic;
-
     int sample_rate = avctx->sample_rate;
     AVChannelLayout channel_layout = avctx->ch_layout;
 
@@ -2726,7 +9618,7 @@ static int stream_component_open_audio(VideoState *is, AVCodecContext *avctx, in
 
     decoder_init(&is->auddec, avctx, &is->audioq, is->continue_read_thread);
 
-    if ((is->ic->iformat->flags & (AVFMT_NOBINSEARCH | AVFMT_NOGENSEARCH | AVFMT_NO_BYTE_SEEK)) && !is->ic->iformat->read_seek)
+    if ((ic->iformat->flags & (AVFMT_NOBINSEARCH | AVFMT_NOGENSEARCH | AVFMT_NO_BYTE_SEEK)) && !ic->iformat->read_seek)
     {
         is->auddec.start_pts = is->audio_st->start_time;
         is->auddec.start_pts_tb = is->audio_st->time_base;
@@ -2742,13 +9634,18 @@ static int stream_component_open_audio(VideoState *is, AVCodecContext *avctx, in
     return ret;
 }
 
-static int stream_component_open_video(VideoState *is, AVCodecContext *avctx, int stream_index)
-{
-    AVFormatContext *ic = is->ic;
-
+static int stream_component_open_video(VideoState *is, AVFormatContext *ic, AVCodecContext *avctx, int stream_index)
+{
     is->video_stream = stream_index;
     is->video_st = ic->streams[stream_index];
 
+    /* turned at present time by SDL_RenderCopyEx, the pixels are never transposed */
+    is->rotation = autorotate ? stream_rotation(is->video_st, &is->rotation_hflip) : 0;
+    if (is->rotation || is->rotation_hflip)
+    {
+        av_log(NULL, AV_LOG_VERBOSE, "Rotating the video by %.0f degrees%s\n", is->rotation, is->rotation_hflip ? ", mirrored" : "");
+    }
+
     decoder_init(&is->viddec, avctx, &is->videoq, is->continue_read_thread);
 
     int ret = decoder_start(&is->viddec, video_thread, is);
@@ -2762,10 +9659,8 @@ static int stream_component_open_video(VideoState *is, AVCodecContext *avctx, in
     return ret;
 }
 
-static int stream_component_open_subtitle(VideoState *is, AVCodecContext *avctx, int stream_index)
+static int stream_component_open_subtitle(VideoState *is, AVFormatContext *ic, AVCodecContext *avctx, int stream_index)
 {
-    AVFormatContext *ic = is->ic;
-
     is->subtitle_stream = stream_index;
     is->subtitle_st = ic->streams[stream_index];
 
@@ -2780,11 +9675,9 @@ static int stream_component_open_subtitle(VideoState *is, AVCodecContext *avctx,
     return ret;
 }
 
-/* open a given stream. Return 0 if OK */
-static int stream_component_open(VideoState *is, int stream_index)
+/* open a given stream of ic, the main input or a sidecar. Return 0 if OK */
+static int stream_component_open_input(VideoState *is, AVFormatContext *ic, int stream_index)
 {
-    AVFormatContext *ic = is->ic;
-
     if (stream_index < 0 || stream_index >= ic->nb_streams)
     {
         return -1;
@@ -2808,7 +9701,7 @@ static int stream_component_open(VideoState *is, int stream_index)
         goto fail;
     }
 
-    if ((ret = open_decoder(is, codec, avctx, stream_index)) != 0)
+    if ((ret = open_decoder(ic, codec, avctx, stream_index)) != 0)
     {
         goto fail;
     }
@@ -2819,21 +9712,26 @@ static int stream_component_open(VideoState *is, int stream_index)
     switch (avctx->codec_type)
     {
     case AVMEDIA_TYPE_AUDIO:
-        ret = stream_component_open_audio(is, avctx, stream_index);
+        ret = stream_component_open_audio(is, ic, avctx, stream_index);
         break;
 
     case AVMEDIA_TYPE_VIDEO:
-        ret = stream_component_open_video(is, avctx, stream_index);
+        ret = stream_component_open_video(is, ic, avctx, stream_index);
         break;
 
     case AVMEDIA_TYPE_SUBTITLE:
-        ret = stream_component_open_subtitle(is, avctx, stream_index);
+        ret = stream_component_open_subtitle(is, ic, avctx, stream_index);
         break;
 
     default:
         break;
     }
 
+    if (ret < 0)
+    {
+        ic->streams[stream_index]->discard = AVDISCARD_ALL;
+    }
+
     goto out;
 
 fail:
@@ -2845,18 +9743,114 @@ out:
     return ret;
 }
 
-static int decode_interrupt_cb(void *ctx)
+static int stream_component_open(VideoState *is, int stream_index)
 {
-    VideoState *is = ctx;
-    return is->abort_request;
+    return stream_component_open_input(is, is->ic, stream_index);
 }
 
-static int stream_has_enough_packets(AVStream *st, int stream_id, PacketQueue *queue)
+/* open the decoders of the sidecar streams and start their demux threads */
+static void sidecars_start(VideoState *is)
 {
-    return stream_id < 0 ||
-           queue->abort_request ||
-           (st->disposition & AV_DISPOSITION_ATTACHED_PIC) ||
-           queue->nb_packets > MIN_FRAMES && (!queue->duration || av_q2d(st->time_base) * queue->duration > 1.0);
+    Sidecar *used[] = {is->audio_sidecar, is->subtitle_sidecar};
+
+    for (size_t i = 0; i < FF_ARRAY_ELEMS(used); i++)
+    {
+        Sidecar *sc = used[i];
+        if (!sc)
+        {
+            continue;
+        }
+
+        if (stream_component_open_input(is, sc->ic, sc->stream_index) < 0)
+        {
+            av_log(NULL, AV_LOG_ERROR, "sidecar %s: cannot open the decoder\n", sc->filename);
+            *(sc->type == AVMEDIA_TYPE_AUDIO ? &is->audio_sidecar : &is->subtitle_sidecar) = NULL;
+            continue;
+        }
+
+        sc->tid = SDL_CreateThread(sidecar_thread, "sidecar", sc);
+        if (!sc->tid)
+        {
+            av_log(NULL, AV_LOG_ERROR, "SDL_CreateThread(): %s\n", SDL_GetError());
+        }
+    }
+}
+
+static const char *io_op_name(int op)
+{
+    switch (op)
+    {
+    case IO_OP_OPEN:
+        return "open";
+    case IO_OP_PROBE:
+        return "probe";
+    case IO_OP_READ:
+        return "read";
+    case IO_OP_SEEK:
+        return "seek";
+    default:
+        return "none";
+    }
+}
+
+static void io_op_begin(VideoState *is, int op)
+{
+    int64_t timeout = 0;
+
+    switch (op)
+    {
+    case IO_OP_OPEN:
+        timeout = io_open_timeout;
+        break;
+    case IO_OP_PROBE:
+        timeout = io_probe_timeout;
+        break;
+    case IO_OP_READ:
+        timeout = io_read_timeout;
+
+        /* with backups, a hung read must not outlast the failover deadline */
+        if (nb_input_filenames > 1 && failover_timeout > 0)
+        {
+            timeout = timeout > 0 ? FFMIN(timeout, failover_timeout) : failover_timeout;
+        }
+        break;
+    case IO_OP_SEEK:
+        timeout = io_seek_timeout;
+        break;
+    }
+
+    is->io_timed_out = 0;
+    is->io_deadline = timeout > 0 ? av_gettime_relative() + timeout : INT64_MAX;
+    is->io_op = op;
+}
+
+static void io_op_end(VideoState *is)
+{
+    is->io_op = IO_OP_NONE;
+}
+
+static int decode_interrupt_cb(void *ctx)
+{
+    VideoState *is = ctx;
+
+    if (is->abort_request)
+    {
+        return 1;
+    }
+
+    if (is->io_op != IO_OP_NONE && av_gettime_relative() > is->io_deadline)
+    {
+        if (!is->io_timed_out)
+        {
+            is->io_timed_out = 1;
+            is->nb_io_stalls++;
+            av_log(NULL, AV_LOG_WARNING, "%s: %s stalled, interrupted after its deadline\n", is->filename, io_op_name(is->io_op));
+        }
+
+        return 1;
+    }
+
+    return 0;
 }
 
 static int is_realtime(AVFormatContext *s)
@@ -2899,7 +9893,23 @@ static int open_input_file(AVFormatContext **ctx, VideoState *is)
     ic->interrupt_callback.callback = decode_interrupt_cb;
     ic->interrupt_callback.opaque = is;
 
+#if HAVE_MMAP_IO
+    if (mmap_io && (ret = mmap_io_open(is, ic)) < 0)
+    {
+        goto fail;
+    }
+#endif
+
+#if HAVE_PREAD_IO
+    if (readahead_io && !ic->pb && (ret = readahead_io_open(is, ic)) < 0)
+    {
+        goto fail;
+    }
+#endif
+
+    io_op_begin(is, IO_OP_OPEN);
     int err = avformat_open_input(&ic, is->filename, is->iformat, NULL);
+    io_op_end(is);
 
     if (err < 0)
     {
@@ -2919,7 +9929,9 @@ static int open_input_file(AVFormatContext **ctx, VideoState *is)
 
     if (find_stream_info)
     {
+        io_op_begin(is, IO_OP_PROBE);
         err = avformat_find_stream_info(ic, NULL);
+        io_op_end(is);
 
         if (err < 0)
         {
@@ -2969,15 +9981,10 @@ static void seek_to_start_time(AVFormatContext *ic, VideoState *is)
     /* if seeking requested, we execute it */
     if (start_time != AV_NOPTS_VALUE)
     {
-        int64_t timestamp = start_time;
-
-        /* add the stream start time */
-        if (ic->start_time != AV_NOPTS_VALUE)
-        {
-            timestamp += ic->start_time;
-        }
+        int64_t timestamp = play_range_start(ic);
 
-        int ret = avformat_seek_file(ic, -1, INT64_MIN, timestamp, INT64_MAX, 0);
+        /* land at or before the start, decoders drop what precedes it */
+        int ret = avformat_seek_file(ic, -1, INT64_MIN, timestamp, timestamp, 0);
         if (ret < 0)
         {
             av_log(NULL, AV_LOG_WARNING,
@@ -3024,13 +10031,39 @@ static void update_window_size(AVFormatContext *ic, int video_index)
 
         if (codecpar->width)
         {
-            set_default_window_size(codecpar->width, codecpar->height, sar);
+            int hflip;
+            set_default_window_size(codecpar->width, codecpar->height, sar, autorotate ? stream_rotation(st, &hflip) : 0);
         }
     }
 }
 
+static void stream_bytes_alloc(VideoState *is, AVFormatContext *ic)
+{
+    av_freep(&is->stream_bytes_read);
+    av_freep(&is->stream_bytes_used);
+
+    is->nb_stream_bytes = ic->nb_streams;
+    is->stream_bytes_read = av_calloc(is->nb_stream_bytes, sizeof(*is->stream_bytes_read));
+    is->stream_bytes_used = av_calloc(is->nb_stream_bytes, sizeof(*is->stream_bytes_used));
+
+    if (!is->stream_bytes_read || !is->stream_bytes_used)
+    {
+        is->nb_stream_bytes = 0;
+    }
+}
+
 static int open_the_streams(VideoState *is, int st_index[AVMEDIA_TYPE_NB])
 {
+    AVFormatContext *ic = is->ic;
+
+    /* let the demuxer skip everything that is not selected, stream_component_open re-enables what it opens */
+    for (unsigned i = 0; i < ic->nb_streams; i++)
+    {
+        ic->streams[i]->discard = AVDISCARD_ALL;
+    }
+
+    stream_bytes_alloc(is, ic);
+
     if (st_index[AVMEDIA_TYPE_AUDIO] >= 0)
     {
         stream_component_open(is, st_index[AVMEDIA_TYPE_AUDIO]);
@@ -3056,10 +10089,297 @@ static int open_the_streams(VideoState *is, int st_index[AVMEDIA_TYPE_NB])
     return ret;
 }
 
+/* a decoder can go on with packets of the new stream only if nothing it was opened with changes */
+static int input_stream_compatible(AVStream *a, AVStream *b)
+{
+    AVCodecParameters *pa = a->codecpar;
+    AVCodecParameters *pb = b->codecpar;
+
+    if (pa->codec_type != pb->codec_type ||
+        pa->codec_id != pb->codec_id ||
+        av_cmp_q(a->time_base, b->time_base) ||
+        pa->extradata_size != pb->extradata_size ||
+        (pa->extradata_size && memcmp(pa->extradata, pb->extradata, pa->extradata_size)) ||
+        ((a->disposition | b->disposition) & AV_DISPOSITION_ATTACHED_PIC))
+    {
+        return 0;
+    }
+
+    switch (pa->codec_type)
+    {
+    case AVMEDIA_TYPE_VIDEO:
+        return pa->width == pb->width && pa->height == pb->height && pa->format == pb->format;
+
+    case AVMEDIA_TYPE_AUDIO:
+        return pa->sample_rate == pb->sample_rate && pa->format == pb->format && !av_channel_layout_compare(&pa->ch_layout, &pb->ch_layout);
+
+    default:
+        return 1;
+    }
+}
+
+/*
+ * replace the input being read, decoders of compatible streams are kept and only see a new serial. runs on the
+ * event thread like stream_cycle_channel, while the read thread waits in input_switch_request
+ */
+static void input_switch(VideoState *is, AVFormatContext *new_ic, int index)
+{
+    static const enum AVMediaType types[] = {AVMEDIA_TYPE_AUDIO, AVMEDIA_TYPE_VIDEO, AVMEDIA_TYPE_SUBTITLE};
+    int *stream_indexes[] = {&is->audio_stream, &is->video_stream, &is->subtitle_stream};
+    AVStream **streams[] = {&is->audio_st, &is->video_st, &is->subtitle_st};
+    Sidecar *sidecars[] = {is->audio_sidecar, NULL, is->subtitle_sidecar};
+    int keep[FF_ARRAY_ELEMS(types)];
+
+    AVFormatContext *old_ic = is->ic;
+    int st_index[AVMEDIA_TYPE_NB];
+
+    find_best_streams(new_ic, st_index);
+
+    if (st_index[AVMEDIA_TYPE_VIDEO] < 0 && st_index[AVMEDIA_TYPE_AUDIO] < 0)
+    {
+        av_log(NULL, AV_LOG_WARNING, "input %d (%s): no audio or video stream, not switching\n", index, input_filenames[index]);
+        avformat_close_input(&new_ic);
+        return;
+    }
+
+    char *filename = av_strdup(input_filenames[index]);
+    input_retired_collect(is, 0);
+
+    /* switches faster than the decoders drain would pile up inputs, the current one plays on instead */
+    if (!filename || is->nb_retired == MAX_RETIRED_INPUTS)
+    {
+        av_log(NULL, AV_LOG_WARNING, "input %d (%s): earlier inputs still in use, not switching\n", index, input_filenames[index]);
+        av_free(filename);
+        avformat_close_input(&new_ic);
+        return;
+    }
+
+    log_stream_bytes(is);
+
+    for (size_t i = 0; i < FF_ARRAY_ELEMS(types); i++)
+    {
+        int cur = *stream_indexes[i];
+        int next = st_index[types[i]];
+
+        /* a sidecar keeps feeding its type whatever the main input is */
+        if (sidecars[i])
+        {
+            keep[i] = 0;
+            continue;
+        }
+
+        keep[i] = cur >= 0 && next >= 0 && input_stream_compatible(old_ic->streams[cur], new_ic->streams[next]);
+        if (!keep[i] && cur >= 0)
+        {
+            stream_component_close(is, cur);
+        }
+    }
+
+    double pos = get_master_clock(is);
+
+    sidecars_lock(is);
+    stream_flush_queues(is);
+
+    /* refill the sidecars from where playback was */
+    if (!isnan(pos))
+    {
+        sidecars_seek(is, (int64_t)(pos * AV_TIME_BASE));
+    }
+
+    sidecars_unlock(is);
+
+    if (is->rec)
+    {
+        packet_queue_put(&is->rec->q, &flush_pkt);
+    }
+
+    for (unsigned i = 0; i < new_ic->nb_streams; i++)
+    {
+        new_ic->streams[i]->discard = AVDISCARD_ALL;
+    }
+
+    new_ic->interrupt_callback.callback = decode_interrupt_cb;
+    new_ic->interrupt_callback.opaque = is;
+
+    /* a seek on the event side may be looking the old map up */
+    SDL_LockMutex(is->btmap_mutex);
+    ByteTimeMap *old_map = is->btmap;
+    is->btmap = NULL;
+    SDL_UnlockMutex(is->btmap_mutex);
+
+    byte_time_map_close(&old_map);
+
+    is->ic = new_ic;
+    stream_bytes_alloc(is, new_ic);
+
+    for (size_t i = 0; i < FF_ARRAY_ELEMS(types); i++)
+    {
+        int next = st_index[types[i]];
+
+        if (keep[i])
+        {
+            *stream_indexes[i] = next;
+            *streams[i] = new_ic->streams[next];
+            new_ic->streams[next]->discard = AVDISCARD_DEFAULT;
+        }
+        else if (next >= 0 && !sidecars[i])
+        {
+            stream_component_open(is, next);
+        }
+    }
+
+    is->retired[is->nb_retired++] = (RetiredInput){old_ic, {is->audioq.serial, is->videoq.serial, is->subtitleq.serial}};
+
+    av_free(is->filename);
+    is->filename = filename;
+
+    is->input_index = index;
+    is->realtime = is_realtime(new_ic);
+    is->max_frame_duration = (new_ic->iformat->flags & AVFMT_TS_DISCONT) ? 10.0 : 3600.0;
+
+    is->input_stall_start = 0;
+    is->next_failback_time = av_gettime_relative() + failback_interval;
+    is->video_wait_keyframe = 1;
+    is->queue_attachments_req = 1;
+    is->eof = 0;
+    is->audio_past_play_range = 0;
+    is->video_past_play_range = 0;
+    is->play_range_done = 0;
+    is->nb_input_switches++;
+
+    /* the map belongs to the input, the new one starts its own */
+    if (seek_by_bytes && !is->realtime)
+    {
+        int map_stream = is->video_stream >= 0 && !(is->video_st->disposition & AV_DISPOSITION_ATTACHED_PIC) ? is->video_stream : main_audio_stream(is);
+
+        if (byte_time_map_open(is, new_ic, map_stream) < 0)
+        {
+            av_log(NULL, AV_LOG_WARNING, "Could not create the byte/time map\n");
+        }
+    }
+
+    set_clock(&is->extclk, NAN, 0);
+
+    av_log(NULL, AV_LOG_INFO, "switched to input %d: %s (%s%s%s kept)\n",
+           index, input_filenames[index],
+           keep[0] ? "audio " : "", keep[1] ? "video " : "", keep[2] ? "subtitle " : "");
+}
+
+/* FF_INPUT_SWITCH_EVENT, the read thread is waiting in input_switch_request */
+static void input_switch_handle(VideoState *is)
+{
+    SDL_LockMutex(is->switch_mutex);
+
+    if (is->switch_ic)
+    {
+        input_switch(is, is->switch_ic, is->switch_index);
+        is->switch_ic = NULL;
+        SDL_CondSignal(is->switch_cond);
+    }
+
+    SDL_UnlockMutex(is->switch_mutex);
+}
+
+/*
+ * on the read thread, which stops reading until the event thread has switched: stream_component_close/open and
+ * the swap of is->ic then never race the renderer or a read. on abort the input is taken back and closed
+ */
+static void input_switch_request(VideoState *is, AVFormatContext *ic, int index)
+{
+    SDL_Event event = {.type = FF_INPUT_SWITCH_EVENT};
+
+    SDL_LockMutex(is->switch_mutex);
+
+    is->switch_ic = ic;
+    is->switch_index = index;
+
+    if (SDL_PushEvent(&event) < 0)
+    {
+        av_log(NULL, AV_LOG_ERROR, "SDL_PushEvent(): %s\n", SDL_GetError());
+    }
+    else
+    {
+        while (is->switch_ic && !is->abort_request)
+        {
+            SDL_CondWaitTimeout(is->switch_cond, is->switch_mutex, 10);
+        }
+    }
+
+    avformat_close_input(&is->switch_ic);
+
+    SDL_UnlockMutex(is->switch_mutex);
+}
+
+/* open the next input in parallel once the current one stalls, and go back to the primary when it recovers */
+static int read_thread_loop_handle_failover(VideoState *is)
+{
+    if (nb_input_filenames < 2)
+    {
+        return 0;
+    }
+
+    int64_t now = av_gettime_relative();
+
+    if (is->opener)
+    {
+        if (SDL_SemTryWait(is->opener->done) != 0)
+        {
+            return 0;
+        }
+
+        InputOpener *op = is->opener;
+        is->opener = NULL;
+
+        SDL_WaitThread(op->tid, NULL);
+        op->tid = NULL;
+
+        if (op->ic && (op->index == 0 || is->input_stall_start))
+        {
+            input_switch_request(is, op->ic, op->index);
+            op->ic = NULL;
+        }
+        else if (op->index == 0)
+        {
+            is->next_failback_time = now + failback_interval;
+        }
+
+        input_opener_free(&op);
+
+        return 1;
+    }
+
+    if (is->input_stall_start && failover_timeout > 0 && now - is->input_stall_start > failover_timeout)
+    {
+        int next = (is->input_index + 1) % nb_input_filenames;
+
+        av_log(NULL, AV_LOG_WARNING, "input %d (%s): no data for %.1fs, opening input %d (%s)\n",
+               is->input_index, input_filenames[is->input_index],
+               (now - is->input_stall_start) / 1000000.0,
+               next, input_filenames[next]);
+
+        /* the next attempt waits for another full deadline */
+        is->input_stall_start = now;
+        input_opener_start(is, next);
+    }
+    else if (is->input_index != 0 && now >= is->next_failback_time)
+    {
+        av_log(NULL, AV_LOG_VERBOSE, "checking whether input 0 (%s) is back\n", input_filenames[0]);
+        input_opener_start(is, 0);
+    }
+
+    return 0;
+}
+
 static int read_thread_loop_handle_pause(AVFormatContext *ic, VideoState *is)
 {
     int ret = 0;
 
+    /* with timeshift the live input keeps being read while paused */
+    if (is->tshift)
+    {
+        return 0;
+    }
+
     if (is->paused != is->last_paused)
     {
         is->last_paused = is->paused;
@@ -3085,6 +10405,19 @@ static int read_thread_loop_handle_pause(AVFormatContext *ic, VideoState *is)
     return ret;
 }
 
+static void stream_set_accurate_seek(VideoState *is, int64_t timestamp)
+{
+    if (is->audio_stream >= 0)
+    {
+        decoder_set_accurate_seek(&is->auddec, timestamp / (double)AV_TIME_BASE);
+    }
+
+    if (is->video_stream >= 0)
+    {
+        decoder_set_accurate_seek(&is->viddec, timestamp / (double)AV_TIME_BASE);
+    }
+}
+
 static int read_thread_loop_handle_seek(AVFormatContext *ic, VideoState *is)
 {
     if (is->seek_req)
@@ -3093,32 +10426,64 @@ static int read_thread_loop_handle_seek(AVFormatContext *ic, VideoState *is)
         int64_t seek_min = is->seek_rel > 0 ? seek_target - is->seek_rel + 2 : INT64_MIN;
         int64_t seek_max = is->seek_rel < 0 ? seek_target - is->seek_rel - 2 : INT64_MAX;
 
-        // FIXME the +-2 is due to rounding being not done in the correct direction in generation of the seek_pos/seek_rel variables
-        int ret = avformat_seek_file(is->ic, -1, seek_min, seek_target, seek_max, is->seek_flags);
+        /* going back to the start of the play range (loop) is frame accurate */
+        int accurate = start_time != AV_NOPTS_VALUE && !(is->seek_flags & AVSEEK_FLAG_BYTE) && seek_target == play_range_start(ic);
+        if (accurate)
+        {
+            seek_max = seek_target;
+        }
+
+        // FIXME the +-2 is due to rounding being not done in the correct direction in generation of the seek_pos/seek_rel variables
+        int ret;
+
+        /* no sidecar packet of the old position may land after the flush */
+        sidecars_lock(is);
+
+#if HAVE_MMAP_IO
+        if (is->tshift)
+        {
+            /* flushes the queues under the ring lock */
+            ret = timeshift_seek(is, seek_target);
+        }
+        else
+#endif
+        {
+            io_op_begin(is, IO_OP_SEEK);
+            ret = avformat_seek_file(is->ic, -1, seek_min, seek_target, seek_max, is->seek_flags);
+            io_op_end(is);
+        }
+
         if (ret < 0)
         {
             av_log(NULL, AV_LOG_ERROR, "%s: error while seeking\n", is->ic->url);
         }
         else
         {
-            if (is->audio_stream >= 0)
+            if (!is->tshift)
+            {
+                stream_flush_queues(is);
+            }
+
+            /* a byte seek moves the sidecars only when it knows the time it aims for */
+            int64_t sidecar_target = (is->seek_flags & AVSEEK_FLAG_BYTE) ? is->seek_target_ts : seek_target;
+            if (sidecar_target != AV_NOPTS_VALUE)
             {
-                packet_queue_flush(&is->audioq);
-                packet_queue_put(&is->audioq, &flush_pkt);
+                sidecars_seek(is, sidecar_target);
             }
 
-            if (is->subtitle_stream >= 0)
+            if (is->rec)
             {
-                packet_queue_flush(&is->subtitleq);
-                packet_queue_put(&is->subtitleq, &flush_pkt);
+                packet_queue_put(&is->rec->q, &flush_pkt);
             }
 
-            if (is->video_stream >= 0)
+            if (accurate)
             {
-                packet_queue_flush(&is->videoq);
-                packet_queue_put(&is->videoq, &flush_pkt);
+                stream_set_accurate_seek(is, seek_target);
             }
 
+            is->byte_seek_target = (is->seek_flags & AVSEEK_FLAG_BYTE) ? is->seek_target_ts : AV_NOPTS_VALUE;
+            is->byte_seek_retry = is->byte_seek_retry_req;
+
             if (is->seek_flags & AVSEEK_FLAG_BYTE)
             {
                 set_clock(&is->extclk, NAN, 0);
@@ -3129,9 +10494,15 @@ static int read_thread_loop_handle_seek(AVFormatContext *ic, VideoState *is)
             }
         }
 
+        sidecars_unlock(is);
+
         is->seek_req = 0;
+        is->byte_seek_retry_req = 0;
         is->queue_attachments_req = 1;
         is->eof = 0;
+        is->audio_past_play_range = 0;
+        is->video_past_play_range = 0;
+        is->play_range_done = 0;
 
         if (is->paused)
         {
@@ -3142,11 +10513,74 @@ static int read_thread_loop_handle_seek(AVFormatContext *ic, VideoState *is)
     return 0;
 }
 
-static int read_thread_loop_handle_queue_attachments_req(AVFormatContext *ic, VideoState *is)
+static int attached_pic_cached(VideoState *is)
+{
+    SDL_LockMutex(is->pictq.mutex);
+    int cached = is->attached_pic.frame != NULL;
+    SDL_UnlockMutex(is->pictq.mutex);
+
+    return cached;
+}
+
+/*
+ * put the cached album art straight into pictq, the video decoder stays idle: the art is cached only after its one
+ * frame was pushed and the read loop never queues the attached stream's packets, so this is the only producer left.
+ * a full pictq returns EAGAIN instead of blocking the read thread, the request stays set and is retried next loop
+ */
+static int queue_attached_pic(VideoState *is)
+{
+    Frame *vp = frame_queue_try_peek_writable(&is->pictq);
+    if (!vp)
+    {
+        return AVERROR(EAGAIN);
+    }
+
+    /* stream_component_close frees it under the same lock, it may be gone since attached_pic_cached */
+    SDL_LockMutex(is->pictq.mutex);
+    int ret = is->attached_pic.frame ? av_frame_ref(vp->frame, is->attached_pic.frame) : AVERROR(EAGAIN);
+    vp->pts = is->attached_pic.pts;
+    vp->duration = is->attached_pic.duration;
+    vp->pos = is->attached_pic.pos;
+    SDL_UnlockMutex(is->pictq.mutex);
+
+    if (ret < 0)
+    {
+        return ret == AVERROR(EAGAIN) ? 0 : ret;
+    }
+
+    vp->sar = vp->frame->sample_aspect_ratio;
+    vp->uploaded = 0;
+    vp->attached = 1;
+
+    vp->width = vp->frame->width;
+    vp->height = vp->frame->height;
+    vp->format = vp->frame->format;
+
+    vp->serial = is->videoq.serial;
+
+    frame_queue_push(&is->pictq);
+
+    return 0;
+}
+
+static int read_thread_loop_handle_queue_attachments_req(VideoState *is)
 {
     if (is->queue_attachments_req)
     {
-        if (is->video_st && is->video_st->disposition & AV_DISPOSITION_ATTACHED_PIC)
+        if (is->video_st && is->video_st->disposition & AV_DISPOSITION_ATTACHED_PIC && attached_pic_cached(is))
+        {
+            int ret = queue_attached_pic(is);
+            if (ret == AVERROR(EAGAIN))
+            {
+                return 0;
+            }
+
+            if (ret < 0)
+            {
+                return ret;
+            }
+        }
+        else if (is->video_st && is->video_st->disposition & AV_DISPOSITION_ATTACHED_PIC)
         {
             AVPacket copy = {0};
 
@@ -3168,12 +10602,8 @@ static int read_thread_loop_handle_queue_attachments_req(AVFormatContext *ic, Vi
 
 static int read_thread_loop_handle_queue_full(VideoState *is, SDL_mutex *wait_mutex)
 {
-    /* if the queue are full, no need to read more */
-    if (infinite_buffer < 1 &&
-        (is->audioq.size + is->videoq.size + is->subtitleq.size > MAX_QUEUE_SIZE ||
-         (stream_has_enough_packets(is->audio_st, is->audio_stream, &is->audioq) &&
-          stream_has_enough_packets(is->video_st, is->video_stream, &is->videoq) &&
-          stream_has_enough_packets(is->subtitle_st, is->subtitle_stream, &is->subtitleq))))
+    /* if the queue are full, no need to read more, with timeshift the ring takes everything */
+    if (!is->tshift && stream_queues_full(is))
     {
         /* wait 10 ms */
         SDL_LockMutex(wait_mutex);
@@ -3191,11 +10621,11 @@ static int read_thread_loop_handle_loop(VideoState *is)
 
     if (!is->paused &&
         (!is->audio_st || (is->auddec.finished == is->audioq.serial && frame_queue_nb_remaining(&is->sampq) == 0)) &&
-        (!is->video_st || (is->viddec.finished == is->videoq.serial && frame_queue_nb_remaining(&is->pictq) == 0)))
+        (!is->video_st || ((is->viddec.finished == is->videoq.serial || attached_pic_cached(is)) && frame_queue_nb_remaining(&is->pictq) == 0)))
     {
         if (loop != 1 && (!loop || --loop))
         {
-            stream_seek(is, start_time != AV_NOPTS_VALUE ? start_time : 0, 0, 0);
+            stream_seek(is, play_range_start(is->ic), 0, 0);
         }
         else if (autoexit)
         {
@@ -3206,6 +10636,230 @@ static int read_thread_loop_handle_loop(VideoState *is)
     return ret;
 }
 
+/* feed the byte/time map and check where the last byte seek landed */
+static void read_thread_loop_track_byte_seek(AVFormatContext *ic, VideoState *is, AVPacket *pkt)
+{
+    ByteTimeMap *map = is->btmap;
+
+    if (!map || pkt->stream_index != map->stream_index || pkt->pos < 0)
+    {
+        return;
+    }
+
+    int64_t ts = pkt->dts != AV_NOPTS_VALUE ? pkt->dts : pkt->pts;
+    if (ts == AV_NOPTS_VALUE)
+    {
+        return;
+    }
+
+    ts = av_rescale_q(ts, ic->streams[pkt->stream_index]->time_base, AV_TIME_BASE_Q);
+    byte_time_map_add(map, pkt->pos, ts);
+
+    if (is->byte_seek_target == AV_NOPTS_VALUE)
+    {
+        return;
+    }
+
+    int64_t target = is->byte_seek_target;
+    double error = (ts - target) / (double)AV_TIME_BASE;
+
+    is->byte_seek_target = AV_NOPTS_VALUE;
+
+    av_log(NULL, AV_LOG_VERBOSE, "byte seek to %.2f landed at %.2f, error %+.2fs%s\n",
+           target / (double)AV_TIME_BASE, ts / (double)AV_TIME_BASE, error, is->byte_seek_retry ? " (retry)" : "");
+
+    /* the landing point is in the map now, one corrective seek usually gets close */
+    if (fabs(error) > BYTE_SEEK_RETRY_THRESHOLD && !is->byte_seek_retry && !is->seek_req)
+    {
+        int64_t pos = byte_time_map_pos(map, target);
+
+        if (pos >= 0 && FFABS(pos - pkt->pos) >= map->spacing)
+        {
+            map->nb_retries++;
+            is->byte_seek_retry_req = 1;
+            stream_seek_with_target(is, pos, 0, 1, target);
+            return;
+        }
+    }
+
+    map->nb_seeks++;
+    map->seek_error_sum += fabs(error);
+    map->seek_error_max = FFMAX(map->seek_error_max, fabs(error));
+}
+
+/* a read interrupted by its deadline is retried after a growing pause, up to io_max_retries in a row when set */
+static int read_thread_loop_handle_stall(AVFormatContext *ic, VideoState *is, SDL_mutex *wait_mutex)
+{
+    if (!is->io_timed_out || is->abort_request)
+    {
+        return 0;
+    }
+
+    is->io_timed_out = 0;
+
+    /* with backups the failover takes over, keep retrying meanwhile */
+    if (++is->io_retry > io_max_retries && io_max_retries > 0 && nb_input_filenames < 2)
+    {
+        av_log(NULL, AV_LOG_ERROR, "%s: input stalled %d times in a row, giving up\n", is->filename, is->io_retry);
+        return AVERROR(ETIMEDOUT);
+    }
+
+    int backoff = FFMIN(IO_RETRY_BACKOFF_MIN << FFMIN(is->io_retry - 1, 16), IO_RETRY_BACKOFF_MAX);
+
+    if (io_max_retries > 0)
+    {
+        av_log(NULL, AV_LOG_WARNING, "%s: retrying read in %d ms (%d/%d)\n", is->filename, backoff, is->io_retry, io_max_retries);
+    }
+    else
+    {
+        av_log(NULL, AV_LOG_WARNING, "%s: retrying read in %d ms (stall %d)\n", is->filename, backoff, is->io_retry);
+    }
+
+    is->nb_io_retries++;
+
+    if (ic->pb)
+    {
+        ic->pb->error = 0;
+        ic->pb->eof_reached = 0;
+    }
+
+    /* a seek or quit request ends the pause early */
+    SDL_LockMutex(wait_mutex);
+    SDL_CondWaitTimeout(is->continue_read_thread, wait_mutex, backoff);
+    SDL_UnlockMutex(wait_mutex);
+
+    return 1;
+}
+
+static void read_thread_loop_record_packet(AVFormatContext *ic, VideoState *is, AVPacket *pkt)
+{
+    enum AVMediaType type = pkt->stream_index == main_audio_stream(is)      ? AVMEDIA_TYPE_AUDIO
+                            : pkt->stream_index == is->video_stream        ? AVMEDIA_TYPE_VIDEO
+                            : pkt->stream_index == main_subtitle_stream(is) ? AVMEDIA_TYPE_SUBTITLE
+                                                                           : AVMEDIA_TYPE_UNKNOWN;
+
+    if (type != AVMEDIA_TYPE_UNKNOWN)
+    {
+        recorder_tee(is->rec, pkt, ic->streams[pkt->stream_index], type);
+    }
+}
+
+#if HAVE_MMAP_IO
+/* with timeshift packets of the selected streams go to the ring, the feeder queues them */
+static void read_thread_loop_timeshift_packet(AVFormatContext *ic, VideoState *is, AVPacket *pkt, int use)
+{
+    TimeshiftRing *ts = is->tshift;
+
+    if (pkt->stream_index == main_audio_stream(is) ||
+        (pkt->stream_index == is->video_stream && !(is->video_st->disposition & AV_DISPOSITION_ATTACHED_PIC)) ||
+        pkt->stream_index == main_subtitle_stream(is))
+    {
+        if (use)
+        {
+            is->stream_bytes_used[pkt->stream_index] += pkt->size;
+        }
+
+        timeshift_write(ts, pkt, ic->streams[pkt->stream_index]->time_base);
+    }
+
+    av_packet_unref(pkt);
+
+    int64_t now = av_gettime_relative();
+    if (now - ts->last_report >= TIMESHIFT_REPORT_INTERVAL)
+    {
+        double clock = get_master_clock(is);
+        double behind = ts->last_ts != AV_NOPTS_VALUE && !isnan(clock) ? ts->last_ts / (double)AV_TIME_BASE - clock : 0;
+
+        SDL_LockMutex(ts->mutex);
+        int64_t used = ts->head - ts->tail;
+        SDL_UnlockMutex(ts->mutex);
+
+        av_log(NULL, AV_LOG_VERBOSE,
+               "timeshift: writing %.2f MB/s, ring %.0f%% used, %.1fs behind live, %d keyframes indexed, %" PRId64 " MB in page cache\n",
+               (ts->bytes_written - ts->report_bytes) / ((now - ts->last_report) / 1000000.0) / (1 << 20),
+               100.0 * used / ts->size,
+               behind,
+               ts->nb_index,
+               timeshift_cached_bytes(ts) >> 20);
+
+        ts->last_report = now;
+        ts->report_bytes = ts->bytes_written;
+    }
+}
+#endif
+
+/* drain the decoders, once per end of input */
+static void read_thread_loop_queue_eof(VideoState *is)
+{
+    if (is->eof)
+    {
+        return;
+    }
+
+#if HAVE_MMAP_IO
+    /* with timeshift the ring still has to be played out, the feeder drains the decoders at its end */
+    if (is->tshift)
+    {
+        SDL_LockMutex(is->tshift->mutex);
+        is->tshift->source_eof = 1;
+        SDL_CondSignal(is->tshift->cond);
+        SDL_UnlockMutex(is->tshift->mutex);
+    }
+    else
+#endif
+    {
+        stream_queue_eof(is);
+    }
+
+    is->eof = 1;
+}
+
+static int read_thread_loop_handle_play_range_end(VideoState *is, SDL_mutex *wait_mutex)
+{
+    if (!is->play_range_done)
+    {
+        return 0;
+    }
+
+    /* nothing left to read in the range, behave as at the end of the file */
+    read_thread_loop_queue_eof(is);
+
+    SDL_LockMutex(wait_mutex);
+    SDL_CondWaitTimeout(is->continue_read_thread, wait_mutex, 10);
+    SDL_UnlockMutex(wait_mutex);
+
+    return 1;
+}
+
+/* once every selected audio/video stream has a packet decoding after the end of the range, stop reading */
+static void read_thread_loop_check_play_range(AVFormatContext *ic, VideoState *is, AVPacket *pkt)
+{
+    int64_t ts = pkt->dts != AV_NOPTS_VALUE ? pkt->dts : pkt->pts;
+
+    /* dts is monotonic, so nothing after this packet can be in range again */
+    if (ts == AV_NOPTS_VALUE || play_range_offset(ic, pkt, ts) <= (double)duration / 1000000)
+    {
+        return;
+    }
+
+    if (pkt->stream_index == main_audio_stream(is))
+    {
+        is->audio_past_play_range = 1;
+    }
+    else if (pkt->stream_index == is->video_stream)
+    {
+        is->video_past_play_range = 1;
+    }
+
+    /* a sidecar stops at the end of the range on its own */
+    if ((main_audio_stream(is) < 0 || is->audio_past_play_range) &&
+        (is->video_stream < 0 || is->video_past_play_range || (is->video_st->disposition & AV_DISPOSITION_ATTACHED_PIC)))
+    {
+        av_log(NULL, AV_LOG_VERBOSE, "End of play range reached, stop reading\n");
+        is->play_range_done = 1;
+    }
+}
+
 /**
  * 一个宏方便在for循环内调用子函数
  * 子函数返回值：
@@ -3226,7 +10880,6 @@ static int read_thread_loop(AVFormatContext *ic, VideoState *is)
 {
     int ret = 0;
     AVPacket pkt1, *pkt = &pkt1;
-    int64_t stream_start_time;
     int pkt_in_play_range = 0;
     int64_t pkt_ts;
 
@@ -3250,34 +10903,49 @@ static int read_thread_loop(AVFormatContext *ic, VideoState *is)
             break;
         }
 
+        /* the input may have been switched by the failover */
+        ic = is->ic;
+
+        READ_THREAD_LOOP_CALL(read_thread_loop_handle_failover(is));
         READ_THREAD_LOOP_CALL(read_thread_loop_handle_pause(ic, is));
         READ_THREAD_LOOP_CALL(read_thread_loop_handle_seek(ic, is));
-        READ_THREAD_LOOP_CALL(read_thread_loop_handle_queue_attachments_req(ic, is));
+        READ_THREAD_LOOP_CALL(read_thread_loop_handle_queue_attachments_req(is));
         READ_THREAD_LOOP_CALL(read_thread_loop_handle_queue_full(is, wait_mutex));
         READ_THREAD_LOOP_CALL(read_thread_loop_handle_loop(is));
+        READ_THREAD_LOOP_CALL(read_thread_loop_handle_play_range_end(is, wait_mutex));
 
         // READ_THREAD_LOOP_CALL(read_thread_loop_handle_read());
+        io_op_begin(is, IO_OP_READ);
         ret = av_read_frame(ic, pkt);
+        io_op_end(is);
+
         if (ret < 0)
         {
-            if ((ret == AVERROR_EOF || avio_feof(ic->pb)) && !is->eof)
+            /* the end of a file ends or loops playback, only a live input that stops delivering has stalled */
+            int at_eof = ret == AVERROR_EOF || avio_feof(ic->pb) || is->eof;
+            if (at_eof && !is->realtime)
             {
-                if (is->video_stream >= 0)
-                {
-                    packet_queue_put_nullpacket(&is->videoq, is->video_stream);
-                }
-
-                if (is->audio_stream >= 0)
-                {
-                    packet_queue_put_nullpacket(&is->audioq, is->audio_stream);
-                }
+                is->input_stall_start = 0;
+            }
+            else if (!is->input_stall_start)
+            {
+                is->input_stall_start = av_gettime_relative();
+            }
 
-                if (is->subtitle_stream >= 0)
-                {
-                    packet_queue_put_nullpacket(&is->subtitleq, is->subtitle_stream);
-                }
+            int stall = read_thread_loop_handle_stall(ic, is, wait_mutex);
+            if (stall < 0)
+            {
+                ret = stall;
+                goto fail;
+            }
+            else if (stall)
+            {
+                continue;
+            }
 
-                is->eof = 1;
+            if (ret == AVERROR_EOF || avio_feof(ic->pb))
+            {
+                read_thread_loop_queue_eof(is);
             }
 
             if (ic->pb && ic->pb->error)
@@ -3294,27 +10962,81 @@ static int read_thread_loop(AVFormatContext *ic, VideoState *is)
         else
         {
             is->eof = 0;
+            is->io_retry = 0;
+            is->input_stall_start = 0;
+        }
+
+        /* after an input switch the video decoder restarts at a keyframe, at most one GOP is lost */
+        if (is->video_wait_keyframe && pkt->stream_index == is->video_stream)
+        {
+            if (!(pkt->flags & AV_PKT_FLAG_KEY))
+            {
+                av_packet_unref(pkt);
+                continue;
+            }
+
+            is->video_wait_keyframe = 0;
+        }
+
+        if (seek_by_bytes)
+        {
+            read_thread_loop_track_byte_seek(ic, is, pkt);
         }
 
         /* check if packet is in play range specified by user, then queue, otherwise discard */
-        stream_start_time = ic->streams[pkt->stream_index]->start_time;
         pkt_ts = pkt->pts == AV_NOPTS_VALUE ? pkt->dts : pkt->pts;
         pkt_in_play_range = duration == AV_NOPTS_VALUE ||
-                            (pkt_ts - (stream_start_time != AV_NOPTS_VALUE ? stream_start_time : 0)) *
-                                        av_q2d(ic->streams[pkt->stream_index]->time_base) -
-                                    (double)(start_time != AV_NOPTS_VALUE ? start_time : 0) / 1000000 <=
-                                ((double)duration / 1000000);
+                            play_range_offset(ic, pkt, pkt_ts) <= ((double)duration / 1000000);
+
+        if (duration != AV_NOPTS_VALUE)
+        {
+            read_thread_loop_check_play_range(ic, is, pkt);
+        }
+
+        int accounted = pkt->stream_index < is->nb_stream_bytes;
+        if (accounted)
+        {
+            is->stream_bytes_read[pkt->stream_index] += pkt->size;
+        }
 
-        if (pkt->stream_index == is->audio_stream && pkt_in_play_range)
+        if (is->rec && pkt_in_play_range)
         {
+            read_thread_loop_record_packet(ic, is, pkt);
+        }
+
+#if HAVE_MMAP_IO
+        if (is->tshift)
+        {
+            read_thread_loop_timeshift_packet(ic, is, pkt, pkt_in_play_range && accounted);
+            continue;
+        }
+#endif
+
+        if (pkt->stream_index == main_audio_stream(is) && pkt_in_play_range)
+        {
+            if (accounted)
+            {
+                is->stream_bytes_used[pkt->stream_index] += pkt->size;
+            }
+
             packet_queue_put(&is->audioq, pkt);
         }
         else if (pkt->stream_index == is->video_stream && pkt_in_play_range && !(is->video_st->disposition & AV_DISPOSITION_ATTACHED_PIC))
         {
+            if (accounted)
+            {
+                is->stream_bytes_used[pkt->stream_index] += pkt->size;
+            }
+
             packet_queue_put(&is->videoq, pkt);
         }
-        else if (pkt->stream_index == is->subtitle_stream && pkt_in_play_range)
+        else if (pkt->stream_index == main_subtitle_stream(is) && pkt_in_play_range)
         {
+            if (accounted)
+            {
+                is->stream_bytes_used[pkt->stream_index] += pkt->size;
+            }
+
             packet_queue_put(&is->subtitleq, pkt);
         }
         else
@@ -3356,6 +11078,32 @@ static int read_thread(void *arg)
 
     find_best_streams(ic, st_index);
 
+    /* a sidecar takes over the audio or subtitle of the main input */
+    for (int i = 0; i < nb_sidecar_filenames; i++)
+    {
+        if (sidecar_open(is, ic, sidecar_filenames[i]) < 0)
+        {
+            av_log(NULL, AV_LOG_WARNING, "Ignoring sidecar %s\n", sidecar_filenames[i]);
+        }
+    }
+
+    if (start_time != AV_NOPTS_VALUE)
+    {
+        sidecars_seek(is, play_range_start(ic));
+    }
+
+    sidecars_start(is);
+
+    if (is->audio_sidecar)
+    {
+        st_index[AVMEDIA_TYPE_AUDIO] = -1;
+    }
+
+    if (is->subtitle_sidecar)
+    {
+        st_index[AVMEDIA_TYPE_SUBTITLE] = -1;
+    }
+
     update_window_size(ic, st_index[AVMEDIA_TYPE_VIDEO]);
 
     if (open_the_streams(is, st_index) != 0)
@@ -3363,6 +11111,44 @@ static int read_thread(void *arg)
         goto fail;
     }
 
+    if (start_time != AV_NOPTS_VALUE)
+    {
+        stream_set_accurate_seek(is, play_range_start(ic));
+    }
+
+    if (record_filename && recorder_open(is) < 0)
+    {
+        av_log(NULL, AV_LOG_WARNING, "Recording disabled\n");
+    }
+
+#if HAVE_MMAP_IO
+    if (timeshift && is->realtime)
+    {
+        /* bounded decoder queues, the ring absorbs the live input; seeks in the ring are by time */
+        if (infinite_buffer < 0)
+        {
+            infinite_buffer = 0;
+        }
+
+        seek_by_bytes = 0;
+
+        if (timeshift_open(is) < 0)
+        {
+            av_log(NULL, AV_LOG_WARNING, "Timeshift disabled\n");
+        }
+    }
+#endif
+
+    if (seek_by_bytes && !is->realtime)
+    {
+        int map_stream = is->video_stream >= 0 && !(is->video_st->disposition & AV_DISPOSITION_ATTACHED_PIC) ? is->video_stream : main_audio_stream(is);
+
+        if (byte_time_map_open(is, ic, map_stream) < 0)
+        {
+            av_log(NULL, AV_LOG_WARNING, "Could not create the byte/time map\n");
+        }
+    }
+
     int ret = read_thread_loop(ic, is);
 
 fail:
@@ -3381,6 +11167,8 @@ fail:
         SDL_PushEvent(&event);
     }
 
+    SDL_SemPost(is->read_thread_done);
+
     return 0;
 }
 
@@ -3400,6 +11188,9 @@ static VideoState *stream_open(const char *filename, AVInputFormat *iformat)
 
     is->iformat = iformat;
     is->ytop = 0;
+    is->zoom = 1.0;
+    is->zoom_cx = is->zoom_cy = 0.5;
+    is->show_mode = show_mode;
     is->xleft = 0;
 
     /* start video display */
@@ -3408,26 +11199,44 @@ static VideoState *stream_open(const char *filename, AVInputFormat *iformat)
         goto fail;
     }
 
-    if (frame_queue_init(&is->subpq, &is->subtitleq, SUBPICTURE_QUEUE_SIZE, 0) < 0)
+    if (frame_queue_init(&is->subpq, &is->subtitleq, SUBPICTURE_QUEUE_SIZE, 0) < 0)
+    {
+        goto fail;
+    }
+
+    if (frame_queue_init(&is->sampq, &is->audioq, SAMPLE_QUEUE_SIZE, 1) < 0)
+    {
+        goto fail;
+    }
+
+    if (packet_queue_init(&is->videoq) < 0 ||
+        packet_queue_init(&is->audioq) < 0 ||
+        packet_queue_init(&is->subtitleq) < 0)
+    {
+        goto fail;
+    }
+
+    if (!(is->continue_read_thread = SDL_CreateCond()))
     {
+        av_log(NULL, AV_LOG_FATAL, "SDL_CreateCond(): %s\n", SDL_GetError());
         goto fail;
     }
 
-    if (frame_queue_init(&is->sampq, &is->audioq, SAMPLE_QUEUE_SIZE, 1) < 0)
+    if (!(is->btmap_mutex = SDL_CreateMutex()) || !(is->switch_mutex = SDL_CreateMutex()))
     {
+        av_log(NULL, AV_LOG_FATAL, "SDL_CreateMutex(): %s\n", SDL_GetError());
         goto fail;
     }
 
-    if (packet_queue_init(&is->videoq) < 0 ||
-        packet_queue_init(&is->audioq) < 0 ||
-        packet_queue_init(&is->subtitleq) < 0)
+    if (!(is->switch_cond = SDL_CreateCond()))
     {
+        av_log(NULL, AV_LOG_FATAL, "SDL_CreateCond(): %s\n", SDL_GetError());
         goto fail;
     }
 
-    if (!(is->continue_read_thread = SDL_CreateCond()))
+    if (!(is->read_thread_done = SDL_CreateSemaphore(0)))
     {
-        av_log(NULL, AV_LOG_FATAL, "SDL_CreateCond(): %s\n", SDL_GetError());
+        av_log(NULL, AV_LOG_FATAL, "SDL_CreateSemaphore(): %s\n", SDL_GetError());
         goto fail;
     }
 
@@ -3435,6 +11244,9 @@ static VideoState *stream_open(const char *filename, AVInputFormat *iformat)
     init_clock(&is->audclk, &is->audioq.serial);
     init_clock(&is->extclk, &is->extclk.serial);
 
+    is->seek_target_ts = AV_NOPTS_VALUE;
+    is->byte_seek_target = AV_NOPTS_VALUE;
+
     is->audio_clock_serial = -1;
     if (startup_volume < 0)
     {
@@ -3469,6 +11281,13 @@ static void stream_cycle_channel(VideoState *is, int codec_type)
 {
     AVFormatContext *ic = is->ic;
 
+    /* the sidecar holds the only stream of its type */
+    if ((codec_type == AVMEDIA_TYPE_AUDIO && is->audio_sidecar) || (codec_type == AVMEDIA_TYPE_SUBTITLE && is->subtitle_sidecar))
+    {
+        av_log(NULL, AV_LOG_INFO, "%s comes from a sidecar file, not switching\n", av_get_media_type_string(codec_type));
+        return;
+    }
+
     int start_index, old_index;
 
     int nb_streams = is->ic->nb_streams;
@@ -3579,42 +11398,223 @@ the_end:
     stream_component_open(is, stream_index);
 }
 
-static void toggle_full_screen(VideoState *is)
+static void toggle_full_screen(void)
 {
     is_full_screen = !is_full_screen;
-    SDL_SetWindowFullscreen(window, is_full_screen ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0);
+    window_request(WINDOW_OP_FULLSCREEN, is_full_screen, 0);
 }
 
-static void refresh_loop_wait_event(VideoState *is, SDL_Event *event)
+/* keep the view inside the picture */
+static void video_zoom_clamp(VideoState *is)
 {
-    double remaining_time = 0.0;
+    double half = 0.5 / is->zoom;
+
+    is->zoom_cx = av_clipd(is->zoom_cx, half, 1.0 - half);
+    is->zoom_cy = av_clipd(is->zoom_cy, half, 1.0 - half);
+    is->force_refresh = 1;
+}
+
+/* turn a vector in fractions of the display box into fractions of the picture, undoing rotation and mirror */
+static void display_to_picture(VideoState *is, double *fx, double *fy)
+{
+    double x = *fx, y = *fy;
+
+    switch ((int)is->rotation)
+    {
+    case 90:
+        *fx = y;
+        *fy = -x;
+        break;
+
+    case 180:
+        *fx = -x;
+        *fy = -y;
+        break;
+
+    case 270:
+        *fx = -y;
+        *fy = x;
+        break;
+
+    default:
+        break;
+    }
+
+    if (is->rotation_hflip)
+    {
+        *fx = -*fx;
+    }
+}
+
+/* zoom by factor keeping the picture point under window position x, y in place */
+static void video_zoom(VideoState *is, double factor, int x, int y)
+{
+    SDL_Rect *r = &is->display_rect;
+    double old_zoom = is->zoom;
+
+    is->zoom = av_clipd(is->zoom * factor, 1.0, ZOOM_MAX);
+
+    if (r->w > 0 && r->h > 0)
+    {
+        double fx = av_clipd((x - r->x) / (double)r->w, 0, 1) - 0.5;
+        double fy = av_clipd((y - r->y) / (double)r->h, 0, 1) - 0.5;
+
+        display_to_picture(is, &fx, &fy);
+
+        is->zoom_cx += fx / old_zoom - fx / is->zoom;
+        is->zoom_cy += fy / old_zoom - fy / is->zoom;
+    }
+
+    video_zoom_clamp(is);
+}
+
+/* move the view by dx, dy window pixels */
+static void video_pan(VideoState *is, int dx, int dy)
+{
+    if (is->zoom <= 1.0 || is->display_rect.w <= 0 || is->display_rect.h <= 0)
+    {
+        return;
+    }
+
+    double fx = dx / (double)is->display_rect.w;
+    double fy = dy / (double)is->display_rect.h;
+
+    display_to_picture(is, &fx, &fy);
+
+    is->zoom_cx -= fx / is->zoom;
+    is->zoom_cy -= fy / is->zoom;
+
+    video_zoom_clamp(is);
+}
+
+/* single producer, single consumer: the main thread pushes, the render thread pops */
+static int event_ring_push(EventRing *ring, const SDL_Event *event)
+{
+    int head = SDL_AtomicGet(&ring->head);
+
+    if (head - SDL_AtomicGet(&ring->tail) >= EVENT_RING_SIZE)
+    {
+        return 0;
+    }
+
+    ring->events[head % EVENT_RING_SIZE] = *event;
+
+    /* the event must be visible before the slot is published */
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&ring->head, head + 1);
+    SDL_SemPost(ring->wake);
+
+    return 1;
+}
+
+static int event_ring_pop(EventRing *ring, SDL_Event *event)
+{
+    int tail = SDL_AtomicGet(&ring->tail);
+
+    if (tail == SDL_AtomicGet(&ring->head))
+    {
+        return 0;
+    }
+
+    SDL_MemoryBarrierAcquire();
+    *event = ring->events[tail % EVENT_RING_SIZE];
+    SDL_AtomicSet(&ring->tail, tail + 1);
+
+    return 1;
+}
+
+/* quit from the thread handling events; the render thread unwinds and hands the rest to the main thread */
+static void request_exit(VideoState *is)
+{
+    if (SDL_ThreadID() == main_thread_id)
+    {
+        do_exit(is);
+    }
+
+    render_quit = 1;
+}
+
+/* the next event: pumped from SDL on the main thread, popped from the ring on the render thread */
+static int refresh_loop_next_event(SDL_Event *event)
+{
+    if (SDL_ThreadID() != main_thread_id)
+    {
+        return event_ring_pop(&event_ring, event);
+    }
 
     SDL_PumpEvents();
 
-    while (!SDL_PeepEvents(event, 1, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT))
+    return SDL_PeepEvents(event, 1, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT) > 0;
+}
+
+/* sleep until the next refresh, on the render thread an incoming event cuts the sleep short */
+static void refresh_loop_sleep(double remaining_time)
+{
+    Uint32 ms = (Uint32)(remaining_time * 1000);
+
+    if (SDL_ThreadID() != main_thread_id && ms)
+    {
+        SDL_SemWaitTimeout(event_ring.wake, ms);
+        return;
+    }
+
+    av_usleep((int64_t)(remaining_time * 1000000.0));
+}
+
+static void refresh_loop_wait_event(VideoState *is, SDL_Event *event)
+{
+    double remaining_time = 0.0;
+
+    while (!refresh_loop_next_event(event))
     {
         if (!cursor_hidden && av_gettime_relative() - cursor_last_shown > CURSOR_HIDE_DELAY)
         {
-            SDL_ShowCursor(0);
+            window_request(WINDOW_OP_CURSOR, 0, 0);
             cursor_hidden = 1;
         }
 
         if (remaining_time > 0.0)
         {
-            av_usleep((int64_t)(remaining_time * 1000000.0));
+            int64_t start = av_gettime_relative();
+
+            video_preupload(is, remaining_time);
+
+            remaining_time -= (av_gettime_relative() - start) / 1000000.0;
+            if (remaining_time > 0.0)
+            {
+                refresh_loop_sleep(remaining_time);
+            }
         }
 
         remaining_time = REFRESH_RATE;
 
-        if (!is->paused || is->force_refresh)
+        /* a paused picture keeps its overlay current */
+        if (!is->paused || is->force_refresh || stats_overlay)
         {
             video_refresh(is, &remaining_time);
         }
-
-        SDL_PumpEvents();
     }
 }
 
+/* byte/time map lookups away from the read thread, which may swap the map meanwhile */
+static int64_t stream_byte_pos(VideoState *is, int64_t ts)
+{
+    SDL_LockMutex(is->btmap_mutex);
+    int64_t pos = byte_time_map_pos(is->btmap, ts);
+    SDL_UnlockMutex(is->btmap_mutex);
+
+    return pos;
+}
+
+static int64_t stream_byte_ts(VideoState *is, int64_t pos)
+{
+    SDL_LockMutex(is->btmap_mutex);
+    int64_t ts = byte_time_map_ts(is->btmap, pos);
+    SDL_UnlockMutex(is->btmap_mutex);
+
+    return ts;
+}
+
 static void seek_chapter(VideoState *is, int incr)
 {
     int64_t pos = get_master_clock(is) * AV_TIME_BASE;
@@ -3650,292 +11650,436 @@ static void seek_chapter(VideoState *is, int incr)
 }
 
 /* handle an event sent by the GUI */
-static void event_loop(VideoState *cur_stream)
+static void handle_event(VideoState *cur_stream, SDL_Event *event)
 {
-    SDL_Event event;
-    double incr, pos;
+    double incr, pos, x;
 
-    while (1)
+    /* SDL stamps events when they are pumped, so this is queue and handling time, in milliseconds */
+    if (event->type == SDL_KEYDOWN || event->type == SDL_MOUSEBUTTONDOWN || event->type == SDL_MOUSEWHEEL)
     {
-        double x;
-        refresh_loop_wait_event(cur_stream, &event); // 这里显示画面
+        int64_t latency = (int64_t)(SDL_GetTicks() - event->common.timestamp) * 1000;
+
+        cur_stream->input_latency_total += latency;
+        cur_stream->input_latency_max = FFMAX(cur_stream->input_latency_max, latency);
+        cur_stream->nb_input_events++;
+    }
+
+    switch (event->type)
+    {
+    case SDL_KEYDOWN:
 
-        switch (event.type)
+        if (exit_on_keydown)
         {
-        case SDL_KEYDOWN:
+            request_exit(cur_stream);
+            break;
+        }
 
-            if (exit_on_keydown)
-            {
-                do_exit(cur_stream);
-                break;
-            }
+        switch (event->key.keysym.sym)
+        {
+        case SDLK_ESCAPE:
+        case SDLK_q:
+            request_exit(cur_stream);
+            break;
 
-            switch (event.key.keysym.sym)
-            {
-            case SDLK_ESCAPE:
-            case SDLK_q:
-                do_exit(cur_stream);
-                break;
+        case SDLK_f:
+            toggle_full_screen();
+            cur_stream->force_refresh = 1;
+            break;
 
-            case SDLK_f:
-                toggle_full_screen(cur_stream);
-                cur_stream->force_refresh = 1;
-                break;
+        case SDLK_p:
+        case SDLK_SPACE:
+            toggle_pause(cur_stream);
+            break;
 
-            case SDLK_p:
-            case SDLK_SPACE:
-                toggle_pause(cur_stream);
-                break;
+        case SDLK_m:
+            toggle_mute(cur_stream);
+            break;
 
-            case SDLK_m:
-                toggle_mute(cur_stream);
-                break;
+        case SDLK_KP_MULTIPLY:
+        case SDLK_0:
+            update_volume(cur_stream, 1, SDL_VOLUME_STEP);
+            break;
 
-            case SDLK_KP_MULTIPLY:
-            case SDLK_0:
-                update_volume(cur_stream, 1, SDL_VOLUME_STEP);
-                break;
+        case SDLK_KP_DIVIDE:
+        case SDLK_9:
+            update_volume(cur_stream, -1, SDL_VOLUME_STEP);
+            break;
 
-            case SDLK_KP_DIVIDE:
-            case SDLK_9:
-                update_volume(cur_stream, -1, SDL_VOLUME_STEP);
-                break;
+        case SDLK_EQUALS:
+        case SDLK_PLUS:
+        case SDLK_KP_PLUS:
+        case SDLK_MINUS:
+        case SDLK_KP_MINUS:
+        {
+            int sym = event->key.keysym.sym;
+            int mx = cur_stream->display_rect.x + cur_stream->display_rect.w / 2;
+            int my = cur_stream->display_rect.y + cur_stream->display_rect.h / 2;
 
-            case SDLK_s: // S: Step to next frame
-                step_to_next_frame(cur_stream);
-                break;
+            video_zoom(cur_stream, sym == SDLK_MINUS || sym == SDLK_KP_MINUS ? 1 / ZOOM_STEP : ZOOM_STEP, mx, my);
+            break;
+        }
 
-            case SDLK_a:
-                stream_cycle_channel(cur_stream, AVMEDIA_TYPE_AUDIO);
-                break;
+        case SDLK_z:
+            cur_stream->zoom = 1.0;
+            video_zoom_clamp(cur_stream);
+            break;
 
-            case SDLK_v:
-                stream_cycle_channel(cur_stream, AVMEDIA_TYPE_VIDEO);
-                break;
+        case SDLK_w:
+            cur_stream->show_mode = (cur_stream->show_mode + 1) % SHOW_MODE_NB;
+            if (cur_stream->show_mode == SHOW_MODE_NONE)
+            {
+                audio_vis_free(&cur_stream->vis);
+            }
 
-            case SDLK_c:
-                stream_cycle_channel(cur_stream, AVMEDIA_TYPE_VIDEO);
-                stream_cycle_channel(cur_stream, AVMEDIA_TYPE_AUDIO);
-                stream_cycle_channel(cur_stream, AVMEDIA_TYPE_SUBTITLE);
-                break;
+            cur_stream->force_refresh = 1;
+            break;
 
-            case SDLK_t:
-                stream_cycle_channel(cur_stream, AVMEDIA_TYPE_SUBTITLE);
-                break;
+        case SDLK_i:
+            stats_overlay = !stats_overlay;
+            cur_stream->overlay.last_update = 0;
+            cur_stream->force_refresh = 1;
+            break;
 
-            case SDLK_PAGEUP:
+        case SDLK_KP_4:
+        case SDLK_KP_6:
+        case SDLK_KP_8:
+        case SDLK_KP_2:
+        {
+            int sym = event->key.keysym.sym;
+            int step_x = cur_stream->display_rect.w / 10, step_y = cur_stream->display_rect.h / 10;
 
-                if (cur_stream->ic->nb_chapters <= 1)
-                {
-                    incr = 600.0;
-                    goto do_seek;
-                }
+            video_pan(cur_stream, sym == SDLK_KP_4 ? step_x : sym == SDLK_KP_6 ? -step_x : 0,
+                      sym == SDLK_KP_8 ? step_y : sym == SDLK_KP_2 ? -step_y : 0);
+            break;
+        }
 
-                seek_chapter(cur_stream, 1);
-                break;
+        case SDLK_s: // S: Step to next frame
+            step_to_next_frame(cur_stream);
+            break;
+
+        case SDLK_l: // L: back to the live edge of the timeshift ring
+#if HAVE_MMAP_IO
+            if (cur_stream->tshift)
+            {
+                /* a seek like any other, so the sidecars follow and the recorder gets its flush */
+                SDL_LockMutex(cur_stream->tshift->mutex);
+                int64_t live_ts = cur_stream->tshift->last_ts;
+                SDL_UnlockMutex(cur_stream->tshift->mutex);
 
-            case SDLK_PAGEDOWN:
-                if (cur_stream->ic->nb_chapters <= 1)
+                if (live_ts != AV_NOPTS_VALUE)
                 {
-                    incr = -600.0;
-                    goto do_seek;
+                    stream_seek(cur_stream, live_ts, 0, 0);
                 }
+            }
+#endif
+            break;
 
-                seek_chapter(cur_stream, -1);
-                break;
+        case SDLK_a:
+            stream_cycle_channel(cur_stream, AVMEDIA_TYPE_AUDIO);
+            break;
 
-            case SDLK_LEFT:
-                incr = -10.0;
-                goto do_seek;
+        case SDLK_v:
+            stream_cycle_channel(cur_stream, AVMEDIA_TYPE_VIDEO);
+            break;
+
+        case SDLK_c:
+            stream_cycle_channel(cur_stream, AVMEDIA_TYPE_VIDEO);
+            stream_cycle_channel(cur_stream, AVMEDIA_TYPE_AUDIO);
+            stream_cycle_channel(cur_stream, AVMEDIA_TYPE_SUBTITLE);
+            break;
+
+        case SDLK_t:
+            stream_cycle_channel(cur_stream, AVMEDIA_TYPE_SUBTITLE);
+            break;
+
+        case SDLK_PAGEUP:
 
-            case SDLK_RIGHT:
-                incr = 10.0;
+            if (cur_stream->ic->nb_chapters <= 1)
+            {
+                incr = 600.0;
                 goto do_seek;
+            }
+
+            seek_chapter(cur_stream, 1);
+            break;
 
-            case SDLK_UP:
-                incr = 60.0;
+        case SDLK_PAGEDOWN:
+            if (cur_stream->ic->nb_chapters <= 1)
+            {
+                incr = -600.0;
                 goto do_seek;
+            }
+
+            seek_chapter(cur_stream, -1);
+            break;
+
+        case SDLK_LEFT:
+            incr = -10.0;
+            goto do_seek;
+
+        case SDLK_RIGHT:
+            incr = 10.0;
+            goto do_seek;
+
+        case SDLK_UP:
+            incr = 60.0;
+            goto do_seek;
+
+        case SDLK_DOWN:
+            incr = -60.0;
 
-            case SDLK_DOWN:
-                incr = -60.0;
+        do_seek:
+            if (seek_by_bytes)
+            {
+                pos = -1;
 
-            do_seek:
-                if (seek_by_bytes)
+                if (pos < 0 && cur_stream->video_stream >= 0)
                 {
-                    pos = -1;
+                    pos = frame_queue_last_pos(&cur_stream->pictq);
+                }
 
-                    if (pos < 0 && cur_stream->video_stream >= 0)
-                    {
-                        pos = frame_queue_last_pos(&cur_stream->pictq);
-                    }
+                if (pos < 0 && cur_stream->audio_stream >= 0)
+                {
+                    pos = frame_queue_last_pos(&cur_stream->sampq);
+                }
 
-                    if (pos < 0 && cur_stream->audio_stream >= 0)
-                    {
-                        pos = frame_queue_last_pos(&cur_stream->sampq);
-                    }
+                if (pos < 0)
+                {
+                    pos = avio_tell(cur_stream->ic->pb);
+                }
 
-                    if (pos < 0)
-                    {
-                        pos = avio_tell(cur_stream->ic->pb);
-                    }
+                /* aim at a time, the learned byte/time map turns it into a position */
+                double clock = get_master_clock(cur_stream);
+                int64_t cur_ts = !isnan(clock) ? (int64_t)(clock * AV_TIME_BASE) : stream_byte_ts(cur_stream, pos);
+                int64_t target_ts = cur_ts != AV_NOPTS_VALUE ? cur_ts + (int64_t)(incr * AV_TIME_BASE) : AV_NOPTS_VALUE;
+                int64_t target_pos = stream_byte_pos(cur_stream, target_ts);
 
-                    if (cur_stream->ic->bit_rate)
-                    {
-                        incr *= cur_stream->ic->bit_rate / 8.0;
-                    }
-                    else
-                    {
-                        incr *= 180000.0;
-                    }
+                if (target_pos >= 0)
+                {
+                    stream_seek_with_target(cur_stream, target_pos, target_pos - (int64_t)pos, 1, target_ts);
+                    break;
+                }
 
-                    pos += incr;
-                    stream_seek(cur_stream, pos, incr, 1);
+                if (cur_stream->ic->bit_rate)
+                {
+                    incr *= cur_stream->ic->bit_rate / 8.0;
                 }
                 else
                 {
-                    pos = get_master_clock(cur_stream);
-                    if (isnan(pos))
-                    {
-                        pos = (double)cur_stream->seek_pos / AV_TIME_BASE;
-                    }
+                    incr *= 180000.0;
+                }
 
-                    pos += incr;
-                    if (cur_stream->ic->start_time != AV_NOPTS_VALUE && pos < cur_stream->ic->start_time / (double)AV_TIME_BASE)
-                    {
-                        pos = cur_stream->ic->start_time / (double)AV_TIME_BASE;
-                    }
+                pos += incr;
+                stream_seek_with_target(cur_stream, pos, incr, 1, target_ts);
+            }
+            else
+            {
+                pos = get_master_clock(cur_stream);
+                if (isnan(pos))
+                {
+                    pos = (double)cur_stream->seek_pos / AV_TIME_BASE;
+                }
 
-                    stream_seek(cur_stream, (int64_t)(pos * AV_TIME_BASE), (int64_t)(incr * AV_TIME_BASE), 0);
+                pos += incr;
+                if (cur_stream->ic->start_time != AV_NOPTS_VALUE && pos < cur_stream->ic->start_time / (double)AV_TIME_BASE)
+                {
+                    pos = cur_stream->ic->start_time / (double)AV_TIME_BASE;
                 }
+
+                stream_seek(cur_stream, (int64_t)(pos * AV_TIME_BASE), (int64_t)(incr * AV_TIME_BASE), 0);
+            }
+            break;
+
+        default:
+            break;
+        }
+        break;
+
+    case SDL_MOUSEBUTTONDOWN:
+
+        if (exit_on_mousedown)
+        {
+            request_exit(cur_stream);
+            break;
+        }
+
+        if (event->button.button == SDL_BUTTON_LEFT)
+        {
+            static int64_t last_mouse_left_click = 0;
+
+            if (av_gettime_relative() - last_mouse_left_click <= 500000)
+            {
+                toggle_full_screen();
+                cur_stream->force_refresh = 1;
+                last_mouse_left_click = 0;
+            }
+            else
+            {
+                last_mouse_left_click = av_gettime_relative();
+            }
+        }
+
+    case SDL_MOUSEMOTION:
+
+        if (cursor_hidden)
+        {
+            window_request(WINDOW_OP_CURSOR, 1, 0);
+            cursor_hidden = 0;
+        }
+
+        cursor_last_shown = av_gettime_relative();
+
+        /* dragging with the left button pans a zoomed picture */
+        if (event->type == SDL_MOUSEMOTION && (event->motion.state & SDL_BUTTON_LMASK))
+        {
+            video_pan(cur_stream, event->motion.xrel, event->motion.yrel);
+            break;
+        }
+
+        if (event->type == SDL_MOUSEBUTTONDOWN)
+        {
+            if (event->button.button != SDL_BUTTON_RIGHT)
+            {
                 break;
+            }
 
-            default:
+            x = event->button.x;
+        }
+        else
+        {
+            if (!(event->motion.state & SDL_BUTTON_RMASK))
+            {
                 break;
             }
-            break;
 
-        case SDL_MOUSEBUTTONDOWN:
+            x = event->motion.x;
+        }
 
-            if (exit_on_mousedown)
-            {
-                do_exit(cur_stream);
-                break;
-            }
+        if (seek_by_bytes || cur_stream->ic->duration <= 0)
+        {
+            uint64_t size = avio_size(cur_stream->ic->pb);
+            int64_t target_ts = AV_NOPTS_VALUE;
+            int64_t target_pos = -1;
 
-            if (event.button.button == SDL_BUTTON_LEFT)
+            if (cur_stream->ic->duration > 0)
             {
-                static int64_t last_mouse_left_click = 0;
-
-                if (av_gettime_relative() - last_mouse_left_click <= 500000)
-                {
-                    toggle_full_screen(cur_stream);
-                    cur_stream->force_refresh = 1;
-                    last_mouse_left_click = 0;
-                }
-                else
+                target_ts = x / cur_stream->width * cur_stream->ic->duration;
+                if (cur_stream->ic->start_time != AV_NOPTS_VALUE)
                 {
-                    last_mouse_left_click = av_gettime_relative();
+                    target_ts += cur_stream->ic->start_time;
                 }
-            }
 
-        case SDL_MOUSEMOTION:
-
-            if (cursor_hidden)
-            {
-                SDL_ShowCursor(1);
-                cursor_hidden = 0;
+                target_pos = stream_byte_pos(cur_stream, target_ts);
             }
 
-            cursor_last_shown = av_gettime_relative();
-
-            if (event.type == SDL_MOUSEBUTTONDOWN)
+            if (target_pos >= 0)
             {
-                if (event.button.button != SDL_BUTTON_RIGHT)
-                {
-                    break;
-                }
-
-                x = event.button.x;
+                stream_seek_with_target(cur_stream, target_pos, 0, 1, target_ts);
             }
             else
             {
-                if (!(event.motion.state & SDL_BUTTON_RMASK))
-                {
-                    break;
-                }
-
-                x = event.motion.x;
+                stream_seek(cur_stream, size * x / cur_stream->width, 0, 1);
             }
+        }
+        else
+        {
+            int tns = cur_stream->ic->duration / 1000000LL;
+            int thh = tns / 3600;
+            int tmm = (tns % 3600) / 60;
+            int tss = (tns % 60);
+
+            double frac = x / cur_stream->width;
 
-            if (seek_by_bytes || cur_stream->ic->duration <= 0)
+            int ns = frac * tns;
+            int hh = ns / 3600;
+            int mm = (ns % 3600) / 60;
+            int ss = (ns % 60);
+
+            av_log(NULL, AV_LOG_INFO,
+                   "Seek to %2.0f%% (%2d:%02d:%02d) of total duration (%2d:%02d:%02d)\n",
+                   frac * 100, hh, mm, ss, thh, tmm, tss);
+
+            int64_t ts = frac * cur_stream->ic->duration;
+            if (cur_stream->ic->start_time != AV_NOPTS_VALUE)
             {
-                uint64_t size = avio_size(cur_stream->ic->pb);
-                stream_seek(cur_stream, size * x / cur_stream->width, 0, 1);
+                ts += cur_stream->ic->start_time;
             }
-            else
-            {
-                int tns = cur_stream->ic->duration / 1000000LL;
-                int thh = tns / 3600;
-                int tmm = (tns % 3600) / 60;
-                int tss = (tns % 60);
 
-                double frac = x / cur_stream->width;
+            stream_seek(cur_stream, ts, 0, 0);
+        }
+        break;
 
-                int ns = frac * tns;
-                int hh = ns / 3600;
-                int mm = (ns % 3600) / 60;
-                int ss = (ns % 60);
+    case SDL_MOUSEWHEEL:
+    {
+        int mx, my;
 
-                av_log(NULL, AV_LOG_INFO,
-                       "Seek to %2.0f%% (%2d:%02d:%02d) of total duration (%2d:%02d:%02d)\n",
-                       frac * 100, hh, mm, ss, thh, tmm, tss);
+        SDL_GetMouseState(&mx, &my);
 
-                int64_t ts = frac * cur_stream->ic->duration;
-                if (cur_stream->ic->start_time != AV_NOPTS_VALUE)
-                {
-                    ts += cur_stream->ic->start_time;
-                }
+        if (event->wheel.y)
+        {
+            video_zoom(cur_stream, event->wheel.y > 0 ? ZOOM_STEP : 1 / ZOOM_STEP, mx, my);
+        }
+        break;
+    }
 
-                stream_seek(cur_stream, ts, 0, 0);
-            }
-            break;
+    case SDL_WINDOWEVENT:
+
+        /* the render thread gets it from the event pump */
+        if (SDL_ThreadID() == main_thread_id)
+        {
+            window_format = SDL_GetWindowPixelFormat(window);
+        }
 
-        case SDL_WINDOWEVENT:
+        switch (event->window.event)
+        {
+        case SDL_WINDOWEVENT_RESIZED:
+
+            screen_width = cur_stream->width = event->window.data1;
+            screen_height = cur_stream->height = event->window.data2;
 
-            switch (event.window.event)
+            if (cur_stream->vis.texture)
             {
-            case SDL_WINDOWEVENT_RESIZED:
+                SDL_DestroyTexture(cur_stream->vis.texture);
+                cur_stream->vis.texture = NULL;
+            }
 
-                screen_width = cur_stream->width = event.window.data1;
-                screen_height = cur_stream->height = event.window.data2;
+        case SDL_WINDOWEVENT_EXPOSED:
+            cur_stream->force_refresh = 1;
+        }
+        break;
 
-                if (cur_stream->vis_texture)
-                {
-                    SDL_DestroyTexture(cur_stream->vis_texture);
-                    cur_stream->vis_texture = NULL;
-                }
+    case FF_INPUT_SWITCH_EVENT:
 
-            case SDL_WINDOWEVENT_EXPOSED:
-                cur_stream->force_refresh = 1;
-            }
-            break;
+        input_switch_handle(cur_stream);
+        break;
 
-        case SDL_QUIT:
-        case FF_QUIT_EVENT:
+    case SDL_QUIT:
+    case FF_QUIT_EVENT:
 
-            do_exit(cur_stream);
-            break;
+        request_exit(cur_stream);
+        break;
 
-        default:
-            break;
-        }
+    default:
+        break;
+    }
+}
+
+/* on the render thread this ends when a quit is requested, on the main thread request_exit never returns */
+static void event_loop(VideoState *cur_stream)
+{
+    SDL_Event event;
+
+    while (!render_quit)
+    {
+        refresh_loop_wait_event(cur_stream, &event); // 这里显示画面
+        handle_event(cur_stream, &event);
     }
 }
 
 static void show_usage(void)
 {
     av_log(NULL, AV_LOG_INFO, "Simple media player\n");
-    av_log(NULL, AV_LOG_INFO, "usage: %s [options] input_file\n", program_name);
+    av_log(NULL, AV_LOG_INFO, "usage: %s [options] [-sidecar file ...] input_file [backup_input ...]\n", program_name);
     av_log(NULL, AV_LOG_INFO, "\n");
 }
 
@@ -3955,11 +12099,235 @@ static void show_help_default()
            "t                   cycle subtitle channel in the current program\n"
            "c                   cycle program\n"
            "s                   activate frame-step mode\n"
+           "l                   catch up with the live input (timeshift)\n"
            "left/right          seek backward/forward 10 seconds\n"
            "down/up             seek backward/forward 1 minute\n"
            "page down/page up   seek backward/forward 10 minutes\n"
            "right mouse click   seek to percentage in file corresponding to fraction of width\n"
-           "left double-click   toggle full screen\n");
+           "left double-click   toggle full screen\n"
+           "+, -, mouse wheel   zoom in and out\n"
+           "z                   reset zoom\n"
+           "i                   toggle the stats overlay\n"
+           "w                   cycle audio display: waves, spectrum, off\n"
+           "left drag           pan the zoomed picture\n"
+           "keypad 2/4/6/8      pan the zoomed picture\n");
+}
+
+/* the renderer picked by an earlier probe on this machine, -1 when there is none for the current video driver */
+static int renderer_probe_load(const char *path)
+{
+    FILE *f = path ? fopen(path, "r") : NULL;
+    if (!f)
+    {
+        return -1;
+    }
+
+    const char *video_driver = SDL_GetCurrentVideoDriver();
+    char driver[64], name[64];
+    int version = 0, index = -1;
+
+    if (fscanf(f, "ffplayer-renderer %d %63s %63s", &version, driver, name) == 3 && version == 1 &&
+        video_driver && !strcmp(driver, video_driver))
+    {
+        for (int i = 0; i < SDL_GetNumRenderDrivers(); i++)
+        {
+            SDL_RendererInfo info;
+            if (!SDL_GetRenderDriverInfo(i, &info) && !strcmp(info.name, name))
+            {
+                index = i;
+                break;
+            }
+        }
+    }
+
+    fclose(f);
+
+    return index;
+}
+
+static void renderer_probe_save(const char *path, const char *name)
+{
+    const char *video_driver = SDL_GetCurrentVideoDriver();
+    FILE *f = path ? fopen(path, "w") : NULL;
+    if (!f)
+    {
+        av_log(NULL, AV_LOG_WARNING, "renderer probe: cannot write %s\n", path ? path : "the cache");
+        return;
+    }
+
+    fprintf(f, "ffplayer-renderer 1 %s %s\n", video_driver ? video_driver : "unknown", name);
+    fclose(f);
+}
+
+static int renderer_info_has_format(const SDL_RendererInfo *info, Uint32 format)
+{
+    for (Uint32 i = 0; i < info->num_texture_formats; i++)
+    {
+        if (info->texture_formats[i] == format)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* microseconds per upload, draw and present of an IYUV picture, the texture the reducers feed; -1 when unusable */
+static int64_t renderer_probe_one(int index, SDL_RendererInfo *info)
+{
+    SDL_Renderer *r = SDL_CreateRenderer(window, index, 0);
+    if (!r)
+    {
+        return -1;
+    }
+
+    int64_t elapsed = -1;
+    SDL_Texture *tex = NULL;
+    uint8_t *planes = NULL;
+    int w = RENDERER_PROBE_WIDTH, h = RENDERER_PROBE_HEIGHT;
+
+    if (SDL_GetRendererInfo(r, info) || !info->num_texture_formats ||
+        !(tex = SDL_CreateTexture(r, SDL_PIXELFORMAT_IYUV, SDL_TEXTUREACCESS_STREAMING, w, h)) ||
+        !(planes = av_malloc(w * h * 3 / 2)))
+    {
+        goto end;
+    }
+
+    for (int i = 0; i < w * h * 3 / 2; i++)
+    {
+        planes[i] = i * 7;
+    }
+
+    /* the first round warms up shaders and driver allocations */
+    int64_t start = 0;
+    int n = 0;
+    for (; n <= RENDERER_PROBE_FRAMES; n++)
+    {
+        if (n == 1)
+        {
+            start = av_gettime_relative();
+        }
+
+        planes[n] = n;
+
+        if (SDL_UpdateYUVTexture(tex, NULL, planes, w, planes + w * h, w / 2, planes + w * h * 5 / 4, w / 2) < 0 ||
+            SDL_RenderClear(r) < 0 ||
+            SDL_RenderCopy(r, tex, NULL, NULL) < 0)
+        {
+            goto end;
+        }
+
+        SDL_RenderPresent(r);
+    }
+
+    elapsed = (av_gettime_relative() - start) / RENDERER_PROBE_FRAMES;
+
+    /* a renderer converting IYUV behind our back pays for it at every resolution, not just the probe's */
+    if (!renderer_info_has_format(info, SDL_PIXELFORMAT_IYUV))
+    {
+        elapsed += elapsed / 4;
+    }
+
+end:
+    av_free(planes);
+
+    if (tex)
+    {
+        SDL_DestroyTexture(tex);
+    }
+
+    SDL_DestroyRenderer(r);
+
+    return elapsed;
+}
+
+/* index of the fastest render driver, cached per machine and video driver; -1 to let SDL choose */
+static int renderer_probe(void)
+{
+    char *path = cache_file_path("renderer");
+    int best = renderer_probe_load(path);
+
+    if (best >= 0)
+    {
+        av_log(NULL, AV_LOG_VERBOSE, "renderer probe: using the cached choice from %s\n", path);
+        av_free(path);
+        return best;
+    }
+
+    int64_t best_time = INT64_MAX;
+    SDL_RendererInfo info, best_info;
+
+    for (int i = 0; i < SDL_GetNumRenderDrivers(); i++)
+    {
+        int64_t t = renderer_probe_one(i, &info);
+        if (t < 0)
+        {
+            av_log(NULL, AV_LOG_VERBOSE, "renderer probe: driver %d unusable\n", i);
+            continue;
+        }
+
+        av_log(NULL, AV_LOG_VERBOSE, "renderer probe: %s %.2f ms per picture%s\n",
+               info.name, t / 1000.0, renderer_info_has_format(&info, SDL_PIXELFORMAT_IYUV) ? "" : ", no native IYUV");
+
+        if (t < best_time)
+        {
+            best_time = t;
+            best_info = info;
+            best = i;
+        }
+    }
+
+    if (best >= 0)
+    {
+        av_log(NULL, AV_LOG_INFO, "renderer probe: picked %s\n", best_info.name);
+        renderer_probe_save(path, best_info.name);
+    }
+
+    av_free(path);
+
+    return best;
+}
+
+/* on the thread that will draw with it, GL contexts are bound to one thread */
+static int create_renderer(void)
+{
+    /* an explicit SDL_RENDER_DRIVER wins over the probe */
+    int index = renderer_auto_select && !SDL_GetHint(SDL_HINT_RENDER_DRIVER) ? renderer_probe() : -1;
+    if (index >= 0)
+    {
+        renderer = SDL_CreateRenderer(window, index, SDL_RENDERER_PRESENTVSYNC);
+    }
+
+    if (!renderer)
+    {
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    }
+
+    if (!renderer)
+    {
+        av_log(NULL, AV_LOG_WARNING, "Failed to initialize a hardware accelerated renderer: %s\n", SDL_GetError());
+        renderer = SDL_CreateRenderer(window, -1, 0);
+    }
+    if (renderer)
+    {
+        if (!SDL_GetRendererInfo(renderer, &renderer_info))
+        {
+            av_log(NULL, AV_LOG_VERBOSE, "Initialized %s renderer.\n", renderer_info.name);
+
+            if (soft_output_enabled())
+            {
+                av_log(NULL, AV_LOG_INFO, "No accelerated renderer, pictures are scaled to the window by the player\n");
+            }
+        }
+    }
+
+    if (!renderer || !renderer_info.num_texture_formats)
+    {
+        av_log(NULL, AV_LOG_FATAL, "Failed to create renderer: %s", SDL_GetError());
+        return -1;
+    }
+
+    return 0;
 }
 
 static void prepare_sdl()
@@ -3995,28 +12363,86 @@ static void prepare_sdl()
 
     SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
 
-    if (window)
+    if (!window)
     {
-        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-        if (!renderer)
+        av_log(NULL, AV_LOG_FATAL, "Failed to create window: %s", SDL_GetError());
+        do_exit(NULL);
+    }
+
+    window_format = SDL_GetWindowPixelFormat(window);
+
+    /* the render thread creates its own */
+    if (!render_thread && create_renderer() < 0)
+    {
+        do_exit(NULL);
+    }
+}
+
+/* owns the renderer from creation to teardown, the main thread only pumps events meanwhile */
+static int render_thread_main(void *arg)
+{
+    VideoState *is = arg;
+
+    if (create_renderer() >= 0)
+    {
+        event_loop(is);
+    }
+
+    /* textures go with the renderer on this thread */
+    stream_close(is);
+
+    if (renderer)
+    {
+        SDL_DestroyRenderer(renderer);
+        renderer = NULL;
+    }
+
+    SDL_Event event = {.type = FF_RENDER_DONE_EVENT};
+    SDL_PushEvent(&event);
+
+    return 0;
+}
+
+/* SDL only pumps events on the main thread, hand them over until the render thread is done */
+static void event_pump_loop(void)
+{
+    SDL_Event event;
+
+    while (SDL_WaitEvent(&event) && event.type != FF_RENDER_DONE_EVENT)
+    {
+        if (event.type == FF_WINDOW_EVENT)
         {
-            av_log(NULL, AV_LOG_WARNING, "Failed to initialize a hardware accelerated renderer: %s\n", SDL_GetError());
-            renderer = SDL_CreateRenderer(window, -1, 0);
+            window_apply(event.user.code, (intptr_t)event.user.data1, (intptr_t)event.user.data2);
+            continue;
         }
-        if (renderer)
+
+        if (event.type == SDL_WINDOWEVENT)
         {
-            if (!SDL_GetRendererInfo(renderer, &renderer_info))
-            {
-                av_log(NULL, AV_LOG_VERBOSE, "Initialized %s renderer.\n", renderer_info.name);
-            }
+            window_format = SDL_GetWindowPixelFormat(window);
+        }
+
+        /* a full ring drops motion, anything else waits for room */
+        while (!event_ring_push(&event_ring, &event) && event.type != SDL_MOUSEMOTION)
+        {
+            SDL_Delay(1);
         }
     }
 
-    if (!window || !renderer || !renderer_info.num_texture_formats)
+    if (event.type != FF_RENDER_DONE_EVENT)
     {
-        av_log(NULL, AV_LOG_FATAL, "Failed to create window or renderer: %s", SDL_GetError());
-        do_exit(NULL);
+        /* no more events from SDL, quit through the render thread so it closes the stream */
+        av_log(NULL, AV_LOG_ERROR, "Waiting for events failed: %s\n", SDL_GetError());
+
+        SDL_Event quit = {.type = FF_QUIT_EVENT};
+        while (!event_ring_push(&event_ring, &quit))
+        {
+            SDL_Delay(1);
+        }
     }
+
+    SDL_WaitThread(render_tid, NULL);
+
+    do_exit(NULL);
 }
 
 int main(int argc, char **argv)
@@ -4035,7 +12461,32 @@ int main(int argc, char **argv)
     signal(SIGINT, sigterm_handler);  /* Interrupt (ANSI).    */
     signal(SIGTERM, sigterm_handler); /* Termination (ANSI).  */
 
-    input_filename = argv[1];
+    /* further inputs are backups, switched to when the one playing stalls */
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-sidecar") && i + 1 < argc)
+        {
+            if (nb_sidecar_filenames < MAX_SIDECARS)
+            {
+                sidecar_filenames[nb_sidecar_filenames++] = argv[i + 1];
+            }
+
+            i++;
+        }
+        else if (nb_input_filenames < MAX_INPUTS)
+        {
+            input_filenames[nb_input_filenames++] = argv[i];
+        }
+    }
+
+    if (!nb_input_filenames)
+    {
+        show_help_default();
+        return -1;
+    }
+
+    input_filename = input_filenames[0];
+    main_thread_id = SDL_ThreadID();
 
     prepare_sdl();
 
@@ -4046,6 +12497,21 @@ int main(int argc, char **argv)
         do_exit(NULL);
     }
 
+    if (render_thread)
+    {
+        if ((event_ring.wake = SDL_CreateSemaphore(0)) &&
+            (render_tid = SDL_CreateThread(render_thread_main, "render", is)))
+        {
+            event_pump_loop();
+        }
+
+        av_log(NULL, AV_LOG_WARNING, "Cannot start the render thread, rendering on the main thread: %s\n", SDL_GetError());
+        if (create_renderer() < 0)
+        {
+            do_exit(is);
+        }
+    }
+
     event_loop(is);
 
     /* never returns */
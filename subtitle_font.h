@@ -0,0 +1,547 @@
+/* generated by tools/gen_subtitle_font.py, do not edit */
+
+#ifndef SUBTITLE_FONT_H
+#define SUBTITLE_FONT_H
+
+#include <stdint.h>
+
+#define SUB_FONT_HEIGHT 38
+#define SUB_FONT_ASCENT 30
+
+/*
+ * DejaVu Sans 32px, 1 bit, U+0020-U+007E then U+00A0-U+00FF: advance, x offset, top, width, height, first row.
+ * Rasterized from DejaVuSans.ttf, which is under the following notice:
+ *
+ * Copyright (c) 2003 by Bitstream, Inc. All Rights Reserved. Bitstream Vera is a trademark of Bitstream, Inc.
+ * DejaVu changes are in public domain.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of the fonts accompanying this
+ * license ("Fonts") and associated documentation files (the "Font Software"), to reproduce and distribute the
+ * Font Software, including without limitation the rights to use, copy, merge, publish, distribute, and/or sell
+ * copies of the Font Software, and to permit persons to whom the Font Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright and trademark notices and this permission notice shall be included in all copies of one
+ * or more of the Font Software typefaces.
+ *
+ * The Font Software may be modified, altered, or added to, and in particular the designs of glyphs or characters
+ * in the Fonts may be modified and additional glyphs or characters may be added to the Fonts, only if the fonts
+ * are renamed to names not containing either the words "Bitstream" or the word "Vera".
+ *
+ * This License becomes null and void to the extent applicable to Fonts or Font Software that has been modified
+ * and is distributed under the "Bitstream Vera" names.
+ *
+ * The Font Software may be sold as part of a larger software package but no copy of one or more of the Font
+ * Software typefaces may be sold by itself.
+ *
+ * THE FONT SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO ANY WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+ * COPYRIGHT, PATENT, TRADEMARK, OR OTHER RIGHT. IN NO EVENT SHALL BITSTREAM OR THE GNOME FOUNDATION BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, INCLUDING ANY GENERAL, SPECIAL, INDIRECT, INCIDENTAL, OR
+ * CONSEQUENTIAL DAMAGES, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF THE USE OR
+ * INABILITY TO USE THE FONT SOFTWARE OR FROM OTHER DEALINGS IN THE FONT SOFTWARE.
+ *
+ * Except as contained in this notice, the names of Gnome, the Gnome Foundation, and Bitstream Inc., shall not
+ * be used in advertising or otherwise to promote the sale, use or other dealings in this Font Software without
+ * prior written authorization from the Gnome Foundation or Bitstream Inc., respectively. For further
+ * information, contact: fonts at gnome dot org.
+ */
+static const struct
+{
+    uint8_t advance;
+    int8_t xoff;
+    uint8_t top;
+    uint8_t w;
+    uint8_t h;
+    uint16_t row;
+} sub_font_glyphs[] = {
+    {10, 0, 0, 0, 0, 0}, {13, 5, 7, 3, 23, 0}, {15, 3, 7, 9, 9, 23}, {27, 2, 7, 22, 23, 32}, {20, 3, 5, 15, 30, 55},
+    {30, 2, 7, 27, 23, 85}, {25, 2, 7, 22, 23, 108}, {9, 3, 7, 3, 9, 131}, {12, 3, 6, 7, 29, 140},
+    {12, 3, 6, 7, 29, 169}, {16, 1, 7, 14, 14, 198}, {27, 3, 9, 20, 21, 212}, {10, 3, 26, 4, 8, 233},
+    {12, 2, 20, 8, 3, 241}, {10, 3, 26, 4, 4, 244}, {11, 0, 7, 11, 26, 248}, {20, 2, 7, 16, 23, 274},
+    {20, 4, 7, 13, 23, 297}, {20, 2, 7, 15, 23, 320}, {20, 2, 7, 16, 23, 343}, {20, 2, 7, 17, 23, 366},
+    {20, 2, 7, 16, 23, 389}, {20, 2, 7, 16, 23, 412}, {20, 3, 7, 15, 23, 435}, {20, 2, 7, 16, 23, 458},
+    {20, 2, 7, 16, 23, 481}, {11, 4, 13, 3, 17, 504}, {11, 3, 13, 4, 21, 521}, {27, 3, 11, 20, 17, 542},
+    {27, 3, 15, 20, 10, 559}, {27, 3, 11, 20, 17, 569}, {17, 2, 7, 13, 23, 586}, {32, 2, 7, 28, 28, 609},
+    {22, 0, 7, 21, 23, 637}, {22, 3, 7, 17, 23, 660}, {22, 2, 7, 19, 23, 683}, {25, 3, 7, 20, 23, 706},
+    {20, 3, 7, 15, 23, 729}, {18, 3, 7, 14, 23, 752}, {25, 2, 7, 20, 23, 775}, {24, 3, 7, 18, 23, 798},
+    {9, 3, 7, 3, 23, 821}, {9, -2, 7, 8, 29, 844}, {21, 3, 7, 18, 23, 873}, {18, 3, 7, 15, 23, 896},
+    {28, 3, 7, 21, 23, 919}, {24, 3, 7, 18, 23, 942}, {25, 2, 7, 21, 23, 965}, {19, 3, 7, 15, 23, 988},
+    {25, 2, 7, 21, 27, 1011}, {22, 3, 7, 18, 23, 1038}, {20, 2, 7, 17, 23, 1061}, {20, 0, 7, 20, 23, 1084},
+    {23, 3, 7, 18, 23, 1107}, {22, 0, 7, 21, 23, 1130}, {32, 1, 7, 29, 23, 1153}, {22, 1, 7, 20, 23, 1176},
+    {20, 0, 7, 19, 23, 1199}, {22, 1, 7, 19, 23, 1222}, {12, 3, 6, 6, 29, 1245}, {11, 0, 7, 11, 26, 1274},
+    {12, 3, 6, 7, 29, 1300}, {27, 4, 7, 19, 9, 1329}, {16, 0, 35, 16, 3, 1338}, {16, 3, 4, 7, 6, 1341},
+    {20, 2, 12, 15, 18, 1347}, {20, 3, 6, 16, 24, 1365}, {18, 2, 12, 14, 18, 1389}, {20, 2, 6, 15, 24, 1407},
+    {20, 2, 12, 16, 18, 1431}, {11, 1, 6, 11, 24, 1449}, {20, 2, 12, 15, 25, 1473}, {20, 3, 6, 15, 24, 1498},
+    {9, 3, 6, 3, 24, 1522}, {9, -1, 6, 7, 31, 1546}, {19, 3, 6, 15, 24, 1577}, {9, 3, 6, 3, 24, 1601},
+    {31, 3, 12, 25, 18, 1625}, {20, 3, 12, 15, 18, 1643}, {20, 2, 12, 16, 18, 1661}, {20, 3, 12, 16, 25, 1679},
+    {20, 2, 12, 15, 25, 1704}, {13, 3, 12, 10, 18, 1729}, {17, 2, 12, 13, 18, 1747}, {13, 1, 7, 11, 23, 1765},
+    {20, 3, 12, 14, 18, 1788}, {19, 1, 12, 17, 18, 1806}, {26, 1, 12, 24, 18, 1824}, {19, 1, 12, 17, 18, 1842},
+    {19, 1, 12, 17, 25, 1860}, {17, 1, 12, 14, 18, 1885}, {20, 4, 6, 12, 30, 1903}, {11, 4, 6, 3, 32, 1933},
+    {20, 4, 6, 12, 30, 1965}, {27, 3, 17, 20, 5, 1995}, {10, 0, 0, 0, 0, 2000}, {13, 5, 12, 3, 23, 2000},
+    {20, 3, 8, 14, 27, 2023}, {20, 2, 7, 16, 23, 2050}, {20, 2, 11, 17, 17, 2073}, {20, 2, 7, 17, 23, 2090},
+    {11, 4, 7, 3, 28, 2113}, {16, 2, 7, 13, 26, 2141}, {16, 3, 6, 10, 3, 2167}, {32, 4, 7, 24, 23, 2170},
+    {15, 2, 7, 11, 17, 2193}, {20, 3, 13, 14, 14, 2210}, {27, 3, 17, 20, 9, 2224}, {12, 2, 20, 8, 3, 2233},
+    {32, 4, 7, 24, 23, 2236}, {16, 3, 6, 10, 3, 2259}, {16, 3, 7, 10, 10, 2262}, {27, 3, 10, 20, 20, 2272},
+    {13, 1, 7, 10, 13, 2292}, {13, 2, 7, 9, 13, 2305}, {16, 6, 4, 7, 6, 2318}, {20, 3, 12, 17, 25, 2324},
+    {20, 2, 7, 15, 26, 2349}, {10, 3, 17, 4, 4, 2375}, {16, 5, 30, 6, 6, 2379}, {13, 2, 7, 9, 13, 2385},
+    {15, 2, 7, 12, 17, 2398}, {20, 3, 13, 14, 14, 2415}, {31, 2, 7, 28, 23, 2429}, {31, 2, 7, 27, 23, 2452},
+    {31, 2, 7, 28, 23, 2475}, {17, 2, 12, 13, 25, 2498}, {22, 0, 0, 21, 30, 2523}, {22, 0, 0, 21, 30, 2553},
+    {22, 0, 0, 21, 30, 2583}, {22, 0, 0, 21, 30, 2613}, {22, 0, 1, 21, 29, 2643}, {22, 0, 0, 21, 30, 2672},
+    {31, 0, 7, 29, 23, 2702}, {22, 2, 7, 19, 29, 2725}, {20, 3, 0, 15, 30, 2754}, {20, 3, 0, 15, 30, 2784},
+    {20, 3, 0, 15, 30, 2814}, {20, 3, 1, 15, 29, 2844}, {9, 1, 0, 6, 30, 2873}, {9, 3, 0, 5, 30, 2903},
+    {9, 0, 0, 9, 30, 2933}, {9, 0, 1, 9, 29, 2963}, {25, 0, 7, 23, 23, 2992}, {24, 3, 0, 18, 30, 3015},
+    {25, 2, 0, 21, 30, 3045}, {25, 2, 0, 21, 30, 3075}, {25, 2, 0, 21, 30, 3105}, {25, 2, 0, 21, 30, 3135},
+    {25, 2, 1, 21, 29, 3165}, {27, 5, 11, 17, 18, 3194}, {25, 2, 7, 21, 23, 3212}, {23, 3, 0, 18, 30, 3235},
+    {23, 3, 0, 18, 30, 3265}, {23, 3, 0, 18, 30, 3295}, {23, 3, 1, 18, 29, 3325}, {20, 0, 0, 19, 30, 3354},
+    {19, 3, 7, 15, 23, 3384}, {20, 3, 6, 16, 24, 3407}, {20, 2, 4, 15, 26, 3431}, {20, 2, 4, 15, 26, 3457},
+    {20, 2, 4, 15, 26, 3483}, {20, 2, 5, 15, 25, 3509}, {20, 2, 6, 15, 24, 3534}, {20, 2, 1, 15, 29, 3558},
+    {31, 2, 12, 28, 18, 3587}, {18, 2, 12, 14, 24, 3605}, {20, 2, 4, 16, 26, 3629}, {20, 2, 4, 16, 26, 3655},
+    {20, 2, 4, 16, 26, 3681}, {20, 2, 6, 16, 24, 3707}, {9, 0, 4, 6, 26, 3731}, {9, 3, 4, 6, 26, 3757},
+    {9, 0, 4, 9, 26, 3783}, {9, 0, 6, 9, 24, 3809}, {20, 2, 6, 16, 24, 3833}, {20, 3, 5, 15, 25, 3857},
+    {20, 2, 4, 16, 26, 3882}, {20, 2, 4, 16, 26, 3908}, {20, 2, 4, 16, 26, 3934}, {20, 2, 5, 16, 25, 3960},
+    {20, 2, 6, 16, 24, 3985}, {27, 3, 11, 20, 17, 4009}, {20, 1, 11, 17, 20, 4026}, {20, 3, 4, 14, 26, 4046},
+    {20, 3, 4, 14, 26, 4072}, {20, 3, 4, 14, 26, 4098}, {20, 3, 6, 14, 24, 4124}, {19, 1, 4, 17, 33, 4148},
+    {20, 3, 6, 16, 31, 4181}, {19, 1, 6, 17, 31, 4212},
+};
+
+/* glyph rows, leftmost pixel in bit 31 */
+static const uint32_t sub_font_rows[] = {
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x0, 0x0, 0x0, 0x0, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe3800000, 0xe3800000, 0xe3800000, 0xe3800000, 0xe3800000, 0xe3800000, 0xe3800000,
+    0xe3800000, 0xe3800000, 0x70e000, 0x70e000, 0x60c000, 0x60c000, 0xe1c000, 0xe1c000, 0x3ffffc00, 0x3ffffc00,
+    0x3ffffc00, 0x1c38000, 0x1830000, 0x1830000, 0x3870000, 0x3870000, 0xfffff800, 0xfffff800, 0xfffff800, 0x70e0000,
+    0x60e0000, 0x60c0000, 0xe0c0000, 0xe1c0000, 0xc180000, 0x3000000, 0x3000000, 0x3000000, 0x3000000, 0xfe00000,
+    0x3ff80000, 0x7ff80000, 0xf3180000, 0xe3000000, 0xe3000000, 0xe3000000, 0xe3000000, 0xf3000000, 0x7f800000,
+    0x3ff00000, 0x7f80000, 0x37c0000, 0x31c0000, 0x30e0000, 0x30e0000, 0x31e0000, 0x833c0000, 0xfffc0000, 0xfff80000,
+    0x3fc00000, 0x3000000, 0x3000000, 0x3000000, 0x3000000, 0x3000000, 0x1e001800, 0x3f803800, 0x71c03000, 0xe1c07000,
+    0xe0c0e000, 0xc0c0c000, 0xc0e1c000, 0xc0c38000, 0xe0c30000, 0xe1c70000, 0x71c61f00, 0x7f8c3f80, 0x1e1c71c0,
+    0x18e1c0, 0x38e0c0, 0x70c0e0, 0x60c0e0, 0xe0c0e0, 0xc0e0c0, 0x180e1c0, 0x38071c0, 0x3003f80, 0x6001f00, 0x3f00000,
+    0xffc0000, 0x1ffc0000, 0x1e0c0000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1e000000, 0xf000000, 0x1f800000,
+    0x3bc03800, 0x71e03800, 0x70f03000, 0xe0787000, 0xe03c7000, 0xe01ee000, 0xe00fc000, 0xf007c000, 0x7807c000,
+    0x7c0fe000, 0x3ffef000, 0x1ffc7800, 0x7f03c00, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe000000, 0xc000000, 0x1c000000, 0x38000000, 0x38000000,
+    0x30000000, 0x70000000, 0x70000000, 0x60000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x60000000, 0x70000000, 0x70000000,
+    0x30000000, 0x38000000, 0x38000000, 0x1c000000, 0xc000000, 0xe000000, 0xc0000000, 0xe0000000, 0x60000000,
+    0x70000000, 0x30000000, 0x38000000, 0x38000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1e000000,
+    0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0x1e000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000,
+    0x38000000, 0x38000000, 0x30000000, 0x70000000, 0x60000000, 0xe0000000, 0xc0000000, 0x3000000, 0x3000000,
+    0x43080000, 0xe31c0000, 0x7b780000, 0x1fe00000, 0x7800000, 0x7800000, 0x1fe00000, 0x7b780000, 0xe31c0000,
+    0x43080000, 0x3000000, 0x3000000, 0x700000, 0x700000, 0x700000, 0x700000, 0x700000, 0x700000, 0x700000, 0x700000,
+    0x700000, 0xfffff000, 0xfffff000, 0xfffff000, 0x700000, 0x700000, 0x700000, 0x700000, 0x700000, 0x700000, 0x700000,
+    0x700000, 0x700000, 0x70000000, 0x70000000, 0x70000000, 0x70000000, 0xe0000000, 0xe0000000, 0xc0000000, 0xc0000000,
+    0xff000000, 0xff000000, 0xff000000, 0xf0000000, 0xf0000000, 0xf0000000, 0xf0000000, 0xe00000, 0xc00000, 0x1c00000,
+    0x1c00000, 0x1800000, 0x3800000, 0x3800000, 0x3000000, 0x7000000, 0x7000000, 0x6000000, 0x6000000, 0xe000000,
+    0xe000000, 0xc000000, 0x1c000000, 0x1c000000, 0x18000000, 0x38000000, 0x38000000, 0x30000000, 0x70000000,
+    0x70000000, 0x60000000, 0xe0000000, 0xe0000000, 0x7e00000, 0xff80000, 0x1ffc0000, 0x3c3c0000, 0x781e0000,
+    0x700e0000, 0x700f0000, 0xf0070000, 0xe0070000, 0xe0070000, 0xe0070000, 0xe0070000, 0xe0070000, 0xe0070000,
+    0xe0070000, 0xf0070000, 0x700f0000, 0x700e0000, 0x781e0000, 0x3c3c0000, 0x1ffc0000, 0xff80000, 0x7e00000,
+    0x3f000000, 0xff000000, 0xff000000, 0xc7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000,
+    0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000,
+    0xfff80000, 0xfff80000, 0xfff80000, 0x1fc00000, 0xfff80000, 0xfffc0000, 0x603c0000, 0x1e0000, 0xe0000, 0xe0000,
+    0xe0000, 0x1e0000, 0x1c0000, 0x3c0000, 0x780000, 0xf00000, 0x1e00000, 0x3c00000, 0x7800000, 0xf000000, 0x1e000000,
+    0x3c000000, 0x78000000, 0xfffe0000, 0xfffe0000, 0xfffe0000, 0x1fe00000, 0x7ff80000, 0x7ffc0000, 0x603e0000, 0xe0000,
+    0xe0000, 0xe0000, 0xe0000, 0x3c0000, 0xff80000, 0xff00000, 0xffc0000, 0x3e0000, 0xe0000, 0xf0000, 0x70000, 0x70000,
+    0xf0000, 0xe0000, 0xc03e0000, 0xfffc0000, 0xfff80000, 0x1fe00000, 0x780000, 0xf80000, 0xf80000, 0x1f80000,
+    0x3b80000, 0x3380000, 0x7380000, 0xe380000, 0xc380000, 0x1c380000, 0x38380000, 0x30380000, 0x70380000, 0xe0380000,
+    0xc0380000, 0xffff8000, 0xffff8000, 0xffff8000, 0x380000, 0x380000, 0x380000, 0x380000, 0x380000, 0x7ffc0000,
+    0x7ffc0000, 0x7ffc0000, 0x70000000, 0x70000000, 0x70000000, 0x70000000, 0x70000000, 0x7fc00000, 0x7ff80000,
+    0x7ffc0000, 0x207c0000, 0x1e0000, 0xe0000, 0xe0000, 0xf0000, 0xe0000, 0xe0000, 0x1e0000, 0x403c0000, 0xfffc0000,
+    0xfff80000, 0x1fc00000, 0x1f80000, 0x7fe0000, 0xffe0000, 0x1f060000, 0x3c000000, 0x78000000, 0x78000000, 0x70000000,
+    0x70000000, 0xf3f00000, 0xf7fc0000, 0xfffe0000, 0xfc1f0000, 0xf80f0000, 0xf0070000, 0x70070000, 0x70070000,
+    0x70070000, 0x380f0000, 0x3c1e0000, 0x1ffe0000, 0xffc0000, 0x3f00000, 0xfffe0000, 0xfffe0000, 0xfffc0000, 0x1c0000,
+    0x380000, 0x380000, 0x780000, 0x700000, 0x700000, 0xe00000, 0xe00000, 0x1e00000, 0x1c00000, 0x1c00000, 0x3800000,
+    0x3800000, 0x7800000, 0x7000000, 0x7000000, 0xf000000, 0xe000000, 0x1e000000, 0x1c000000, 0x7f00000, 0x1ffc0000,
+    0x3ffe0000, 0x7c1e0000, 0x700f0000, 0x700f0000, 0x700f0000, 0x700e0000, 0x3c1e0000, 0x1ff80000, 0xff00000,
+    0x1ffc0000, 0x7c1e0000, 0x700f0000, 0xf0070000, 0xe0070000, 0xe0070000, 0xf0070000, 0x700f0000, 0x7c1e0000,
+    0x3ffe0000, 0x1ffc0000, 0x7f00000, 0x7e00000, 0x1ff80000, 0x3ffc0000, 0x783c0000, 0xf00e0000, 0xe00e0000,
+    0xe00f0000, 0xe00f0000, 0xe00f0000, 0xf00f0000, 0x783f0000, 0x7fff0000, 0x1ff70000, 0xfc70000, 0xf0000, 0xf0000,
+    0xe0000, 0x1e0000, 0x3c0000, 0x207c0000, 0x3ff80000, 0x3ff00000, 0x1fc00000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x70000000,
+    0x70000000, 0x70000000, 0x70000000, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x70000000, 0x70000000, 0x70000000,
+    0x70000000, 0xe0000000, 0xe0000000, 0xc0000000, 0xc0000000, 0x1000, 0xf000, 0x7f000, 0x1fe000, 0xff0000, 0x7f80000,
+    0x3fc00000, 0xfe000000, 0xf8000000, 0xfe000000, 0x3fc00000, 0x7f80000, 0xff0000, 0x1fe000, 0x7f000, 0xf000, 0x1000,
+    0xfffff000, 0xfffff000, 0xfffff000, 0x0, 0x0, 0x0, 0x0, 0xfffff000, 0xfffff000, 0xfffff000, 0xc0000000, 0xf8000000,
+    0xfe000000, 0x3fc00000, 0x7f80000, 0xff0000, 0x1fc000, 0x3f000, 0xf000, 0x3f000, 0x1fc000, 0xff0000, 0x7f80000,
+    0x3fc00000, 0xfe000000, 0xf8000000, 0xc0000000, 0x1f800000, 0x7fe00000, 0xfff00000, 0xe0f00000, 0x80780000,
+    0x380000, 0x780000, 0x700000, 0xf00000, 0x1e00000, 0x3c00000, 0x7800000, 0x7000000, 0xe000000, 0xe000000, 0xe000000,
+    0xe000000, 0x0, 0x0, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0x1fc000, 0xfff800, 0x3fffe00, 0x7e03f00,
+    0xf000f80, 0x1e0003c0, 0x380001c0, 0x381f38e0, 0x703fb860, 0x607ff860, 0x60f0f870, 0xe0e07870, 0xc0c03870,
+    0xc1c03870, 0xc1c03860, 0xc0c03860, 0xe0e078e0, 0x60f0fbc0, 0x607fff80, 0x703fbf00, 0x381f3c00, 0x38000000,
+    0x1e000400, 0xf000e00, 0x7e07e00, 0x3fff800, 0xfff000, 0x3f8000, 0x780000, 0x780000, 0xfc0000, 0xfc0000, 0x1cc0000,
+    0x1ce0000, 0x1ce0000, 0x3870000, 0x3870000, 0x7070000, 0x7038000, 0x7038000, 0xe01c000, 0xe01c000, 0xfffc000,
+    0x1fffe000, 0x1fffe000, 0x3c00e000, 0x38007000, 0x38007000, 0x70007800, 0x70003800, 0xf0003800, 0xfff00000,
+    0xfffc0000, 0xfffe0000, 0xe01e0000, 0xe00f0000, 0xe00f0000, 0xe00f0000, 0xe00e0000, 0xe01e0000, 0xfffc0000,
+    0xfff80000, 0xfffc0000, 0xe01e0000, 0xe0070000, 0xe0070000, 0xe0078000, 0xe0078000, 0xe0078000, 0xe0070000,
+    0xe01f0000, 0xfffe0000, 0xfffc0000, 0xfff00000, 0x1fe0000, 0x7ffc000, 0xfffe000, 0x1f01e000, 0x3c002000, 0x78000000,
+    0x70000000, 0xf0000000, 0xf0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xf0000000,
+    0xf0000000, 0x70000000, 0x78000000, 0x3c002000, 0x1f01e000, 0xfffe000, 0x7ffc000, 0x1fe0000, 0xffe00000, 0xfffe0000,
+    0xffff0000, 0xe01f8000, 0xe007c000, 0xe001e000, 0xe001e000, 0xe000e000, 0xe000e000, 0xe000f000, 0xe000f000,
+    0xe000f000, 0xe000f000, 0xe000f000, 0xe000e000, 0xe000e000, 0xe001e000, 0xe001e000, 0xe007c000, 0xe01f8000,
+    0xffff0000, 0xfffe0000, 0xffe00000, 0xfffe0000, 0xfffe0000, 0xfffe0000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xfffc0000, 0xfffc0000, 0xfffc0000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xfffe0000, 0xfffe0000, 0xfffe0000, 0xfffc0000,
+    0xfffc0000, 0xfffc0000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xfff80000,
+    0xfff80000, 0xfff80000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xff0000, 0x7ffe000, 0xffff000, 0x1f00f000, 0x3c000000, 0x78000000,
+    0x70000000, 0xf0000000, 0xe0000000, 0xe0000000, 0xe00ff000, 0xe00ff000, 0xe00ff000, 0xe0007000, 0xe0007000,
+    0xf0007000, 0x70007000, 0x78007000, 0x3c007000, 0x3f00f000, 0xfffe000, 0x7ffc000, 0xfe0000, 0xe001c000, 0xe001c000,
+    0xe001c000, 0xe001c000, 0xe001c000, 0xe001c000, 0xe001c000, 0xe001c000, 0xe001c000, 0xffffc000, 0xffffc000,
+    0xffffc000, 0xe001c000, 0xe001c000, 0xe001c000, 0xe001c000, 0xe001c000, 0xe001c000, 0xe001c000, 0xe001c000,
+    0xe001c000, 0xe001c000, 0xe001c000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x7000000,
+    0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000,
+    0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000,
+    0x7000000, 0x7000000, 0x7000000, 0xf000000, 0xf000000, 0xfe000000, 0xfc000000, 0xf8000000, 0xe0078000, 0xe00f0000,
+    0xe01e0000, 0xe03c0000, 0xe0780000, 0xe0f00000, 0xe1e00000, 0xe3c00000, 0xe7800000, 0xff000000, 0xfe000000,
+    0xfe000000, 0xef000000, 0xe7800000, 0xe3c00000, 0xe1e00000, 0xe0f00000, 0xe0780000, 0xe03c0000, 0xe01e0000,
+    0xe00f0000, 0xe0078000, 0xe003c000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xfffe0000, 0xfffe0000, 0xfffe0000, 0xf8007800,
+    0xf800f800, 0xfc00f800, 0xfc01f800, 0xee01f800, 0xee01b800, 0xe603b800, 0xe703b800, 0xe7033800, 0xe3073800,
+    0xe3873800, 0xe38e3800, 0xe18e3800, 0xe1cc3800, 0xe0dc3800, 0xe0fc3800, 0xe0f83800, 0xe0783800, 0xe0783800,
+    0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xf801c000, 0xf801c000, 0xfc01c000, 0xfc01c000, 0xfe01c000,
+    0xee01c000, 0xe701c000, 0xe701c000, 0xe381c000, 0xe381c000, 0xe1c1c000, 0xe1e1c000, 0xe0e1c000, 0xe0f1c000,
+    0xe071c000, 0xe039c000, 0xe039c000, 0xe01dc000, 0xe01fc000, 0xe00fc000, 0xe00fc000, 0xe007c000, 0xe007c000,
+    0x1fc0000, 0x7ff0000, 0x1fffc000, 0x3f07e000, 0x3c01e000, 0x7800f000, 0x70007800, 0xf0007800, 0xf0003800,
+    0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xf0003800, 0xf0007800, 0x70007800, 0x7800f000,
+    0x3c01e000, 0x3f07e000, 0x1fffc000, 0x7ff0000, 0x1fc0000, 0xffe00000, 0xfff80000, 0xfffc0000, 0xe03c0000,
+    0xe01e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe01e0000, 0xe03c0000, 0xfffc0000, 0xfff80000,
+    0xffe00000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0x1fc0000, 0x7ff0000, 0x1fffc000, 0x3f07e000, 0x3c01f000, 0x7800f000, 0x70007800, 0xf0007800,
+    0xf0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xf0003800, 0xf0007800, 0x70007000,
+    0x7800f000, 0x3c01e000, 0x3f07e000, 0x1fff8000, 0x7ff0000, 0x1fe0000, 0xf0000, 0x78000, 0x3c000, 0x1e000,
+    0xffe00000, 0xfff80000, 0xfffc0000, 0xe03e0000, 0xe01e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe01e0000,
+    0xe03c0000, 0xfff80000, 0xfff00000, 0xfff00000, 0xe0780000, 0xe03c0000, 0xe01e0000, 0xe00e0000, 0xe00f0000,
+    0xe0070000, 0xe0078000, 0xe0038000, 0xe003c000, 0xe001c000, 0x7f80000, 0x1ffe0000, 0x3ffe0000, 0x7c060000,
+    0xf0000000, 0xe0000000, 0xe0000000, 0xf0000000, 0xf0000000, 0x7e000000, 0x3fe00000, 0x1ffc0000, 0x3fe0000, 0x1f0000,
+    0xf0000, 0x70000, 0x78000, 0x70000, 0xf0000, 0xe01f0000, 0xfffe0000, 0xfffc0000, 0x1ff00000, 0xfffff000, 0xfffff000,
+    0xfffff000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000,
+    0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe003c000,
+    0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000,
+    0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe0038000, 0xf0038000, 0x70078000,
+    0x7c0f0000, 0x3ffe0000, 0x1ffc0000, 0x7f00000, 0xf0003800, 0x70003800, 0x78007800, 0x38007000, 0x38007000,
+    0x3c00e000, 0x1c00e000, 0x1c01e000, 0xe01c000, 0xe01c000, 0xf03c000, 0x7038000, 0x7038000, 0x7870000, 0x3870000,
+    0x38f0000, 0x1ce0000, 0x1ce0000, 0x1fc0000, 0xfc0000, 0xfc0000, 0x780000, 0x780000, 0xe0078038, 0xf0078038,
+    0x700f8038, 0x700f8038, 0x700dc070, 0x780dc070, 0x381cc070, 0x381cc070, 0x3818e0e0, 0x3c18e0e0, 0x1c3860e0,
+    0x1c3861e0, 0x1c3071c0, 0x1e3071c0, 0xe7031c0, 0xe703bc0, 0xe603b80, 0x7603b80, 0x7e01f80, 0x7e01f80, 0x7c01f00,
+    0x3c01f00, 0x3c00f00, 0x7800e000, 0x3801c000, 0x1c03c000, 0x1e038000, 0xe070000, 0x70f0000, 0x79e0000, 0x39c0000,
+    0x1f80000, 0x1f80000, 0xf00000, 0xf00000, 0x1f80000, 0x1fc0000, 0x39c0000, 0x79e0000, 0xf0f0000, 0xe070000,
+    0x1e078000, 0x3c03c000, 0x3801c000, 0x7000e000, 0xf000f000, 0xf000e000, 0x7001e000, 0x3801c000, 0x3c038000,
+    0x1c078000, 0xe0f0000, 0xf0e0000, 0x71c0000, 0x3bc0000, 0x3f80000, 0x1f00000, 0xf00000, 0xe00000, 0xe00000,
+    0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0x7fffe000, 0x7fffe000,
+    0x7fffe000, 0x1c000, 0x38000, 0x70000, 0xf0000, 0x1e0000, 0x1c0000, 0x380000, 0x700000, 0xe00000, 0x1e00000,
+    0x3c00000, 0x3800000, 0x7000000, 0xe000000, 0x1c000000, 0x3c000000, 0x78000000, 0x7fffe000, 0xffffe000, 0xffffe000,
+    0xfc000000, 0xfc000000, 0xfc000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xfc000000,
+    0xfc000000, 0xfc000000, 0xe0000000, 0xe0000000, 0x60000000, 0x70000000, 0x70000000, 0x30000000, 0x38000000,
+    0x38000000, 0x18000000, 0x1c000000, 0x1c000000, 0xc000000, 0xe000000, 0xe000000, 0x6000000, 0x6000000, 0x7000000,
+    0x7000000, 0x3000000, 0x3800000, 0x3800000, 0x1800000, 0x1c00000, 0x1c00000, 0xc00000, 0xe00000, 0xfe000000,
+    0xfe000000, 0xfe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000,
+    0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000,
+    0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xfe000000, 0xfe000000, 0xfe000000, 0x1e00000, 0x3f00000,
+    0x3f80000, 0x73c0000, 0xe1e0000, 0x1c070000, 0x38038000, 0x7001c000, 0xe000e000, 0xffff0000, 0xffff0000, 0xffff0000,
+    0xe0000000, 0x70000000, 0x38000000, 0x18000000, 0x1c000000, 0xe000000, 0x1fc00000, 0x7ff00000, 0x7ff80000,
+    0x603c0000, 0x1c0000, 0xc0000, 0xe0000, 0xffe0000, 0x3ffe0000, 0x7ffe0000, 0xf00e0000, 0xe00e0000, 0xe01e0000,
+    0xe01e0000, 0xf07e0000, 0x7ffe0000, 0x7fce0000, 0x1f8e0000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe3e00000, 0xeff80000, 0xfffc0000, 0xfc3c0000, 0xf01e0000, 0xf00e0000, 0xe00e0000,
+    0xe00e0000, 0xe0070000, 0xe0070000, 0xe00e0000, 0xe00e0000, 0xf00e0000, 0xf01e0000, 0xfc3c0000, 0xfffc0000,
+    0xeff80000, 0xe3e00000, 0x7f00000, 0x1ffc0000, 0x3ffc0000, 0x7c0c0000, 0x70000000, 0xf0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xf0000000, 0x70000000, 0x7c0c0000, 0x3ffc0000,
+    0x1ffc0000, 0x7f00000, 0x60000, 0x60000, 0x60000, 0x60000, 0x60000, 0x60000, 0xfc60000, 0x1fe60000, 0x3ffe0000,
+    0x783e0000, 0x701e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000,
+    0xe00e0000, 0x701e0000, 0x783e0000, 0x3ffe0000, 0x1fe60000, 0xfc60000, 0x7e00000, 0x1ff80000, 0x3ffc0000,
+    0x7c1e0000, 0x700e0000, 0xe0070000, 0xe0070000, 0xffff0000, 0xffff0000, 0xffff0000, 0xe0000000, 0xe0000000,
+    0xf0000000, 0x70020000, 0x7c0e0000, 0x3ffe0000, 0x1ffc0000, 0x7f00000, 0x7e00000, 0xfe00000, 0x1fe00000, 0x1c000000,
+    0x18000000, 0x38000000, 0xffc00000, 0xffc00000, 0xffc00000, 0x38000000, 0x38000000, 0x38000000, 0x38000000,
+    0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000,
+    0x38000000, 0x38000000, 0xfc60000, 0x1fe60000, 0x3ffe0000, 0x783e0000, 0x701e0000, 0xe00e0000, 0xe00e0000,
+    0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0x701e0000, 0x783e0000, 0x3ffe0000,
+    0x1fee0000, 0xfce0000, 0xe0000, 0xe0000, 0x1e0000, 0x203c0000, 0x3ff80000, 0x3ff00000, 0x1fe00000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe3e00000, 0xeff80000, 0xfff80000, 0xf83c0000,
+    0xf01c0000, 0xe01c0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000,
+    0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x0,
+    0x0, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe000000, 0xe000000, 0xe000000, 0xe000000, 0x0, 0x0, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000,
+    0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000,
+    0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0x1c000000, 0xfc000000, 0xf8000000, 0xf0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe01c0000, 0xe0380000, 0xe0700000,
+    0xe0e00000, 0xe3c00000, 0xe7800000, 0xef000000, 0xfe000000, 0xfc000000, 0xfe000000, 0xef000000, 0xe7800000,
+    0xe3c00000, 0xe1e00000, 0xe0f00000, 0xe0780000, 0xe03c0000, 0xe01e0000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe3e07c00, 0xeff1ff00, 0xfffbff00, 0xf83f8780, 0xf01e0380, 0xe01e0380,
+    0xe01c0180, 0xe01c0180, 0xe01c0180, 0xe01c0180, 0xe01c0180, 0xe01c0180, 0xe01c0180, 0xe01c0180, 0xe01c0180,
+    0xe01c0180, 0xe01c0180, 0xe01c0180, 0xe3e00000, 0xeff80000, 0xfff80000, 0xf83c0000, 0xf01c0000, 0xe01c0000,
+    0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000,
+    0xe00e0000, 0xe00e0000, 0xe00e0000, 0x7e00000, 0x1ff80000, 0x3ffc0000, 0x7c3c0000, 0x701e0000, 0xf00e0000,
+    0xe00f0000, 0xe0070000, 0xe0070000, 0xe0070000, 0xe0070000, 0xe00f0000, 0xf00e0000, 0x701e0000, 0x7c3c0000,
+    0x3ffc0000, 0x1ff80000, 0x7e00000, 0xe3e00000, 0xeff80000, 0xfffc0000, 0xfc3c0000, 0xf01e0000, 0xf00e0000,
+    0xe00e0000, 0xe00e0000, 0xe0070000, 0xe0070000, 0xe00e0000, 0xe00e0000, 0xf00e0000, 0xf01e0000, 0xfc3c0000,
+    0xfffc0000, 0xeff80000, 0xe3e00000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xfc60000, 0x1fe60000, 0x3ffe0000, 0x783e0000, 0x701e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000,
+    0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0x701e0000, 0x783e0000, 0x3ffe0000, 0x1fe60000,
+    0xfc60000, 0x60000, 0x60000, 0x60000, 0x60000, 0x60000, 0x60000, 0x60000, 0xe3c00000, 0xefc00000, 0xffc00000,
+    0xf8000000, 0xf0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x1fc00000, 0x7ff00000, 0xfff00000,
+    0xf0300000, 0xe0000000, 0xe0000000, 0xe0000000, 0x7e000000, 0x3fc00000, 0x7f00000, 0x780000, 0x380000, 0x380000,
+    0x80380000, 0xe0780000, 0xfff00000, 0x7fe00000, 0x1f800000, 0x38000000, 0x38000000, 0x38000000, 0x38000000,
+    0x38000000, 0xffe00000, 0xffe00000, 0xffe00000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000,
+    0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x3c000000, 0x1fe00000, 0x1fe00000,
+    0x7e00000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000,
+    0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe03c0000, 0xf07c0000, 0x7ffc0000, 0x3fdc0000,
+    0x1f1c0000, 0xe0038000, 0xf0070000, 0x70070000, 0x70070000, 0x380e0000, 0x380e0000, 0x380e0000, 0x1c1c0000,
+    0x1c1c0000, 0x1c3c0000, 0xe380000, 0xe380000, 0x7700000, 0x7700000, 0x7f00000, 0x3e00000, 0x3e00000, 0x3e00000,
+    0xe03c0700, 0x703c0600, 0x703c0e00, 0x707e0e00, 0x707e0e00, 0x38760c00, 0x38661c00, 0x38e71c00, 0x18e71c00,
+    0x1cc31800, 0x1cc33800, 0x1dc3b800, 0xdc3b800, 0xf81f000, 0xf81f000, 0xf81f000, 0x781f000, 0x700e000, 0x70070000,
+    0x380e0000, 0x3c1e0000, 0x1c1c0000, 0xe380000, 0xf780000, 0x7f00000, 0x3e00000, 0x1c00000, 0x3e00000, 0x7e00000,
+    0x7700000, 0xe380000, 0x1e3c0000, 0x3c1c0000, 0x380e0000, 0x700f0000, 0xf0078000, 0xe0038000, 0x70070000,
+    0x70070000, 0x70070000, 0x380e0000, 0x380e0000, 0x1c1c0000, 0x1c1c0000, 0x1c1c0000, 0xe380000, 0xe380000, 0x6700000,
+    0x7700000, 0x7f00000, 0x3e00000, 0x3e00000, 0x1c00000, 0x1c00000, 0x1c00000, 0x3800000, 0x3800000, 0x7000000,
+    0x3f000000, 0x3e000000, 0x3c000000, 0x7ffc0000, 0x7ffc0000, 0x7ffc0000, 0x1c0000, 0x380000, 0x700000, 0xe00000,
+    0x1c00000, 0x3800000, 0x3000000, 0x7000000, 0xe000000, 0x1c000000, 0x38000000, 0x70000000, 0xfffc0000, 0xfffc0000,
+    0xfffc0000, 0xf00000, 0x3f00000, 0x7f00000, 0x7800000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000,
+    0x7000000, 0x7000000, 0xf000000, 0xe000000, 0xfe000000, 0xf8000000, 0xfc000000, 0x1e000000, 0xf000000, 0x7000000,
+    0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7000000, 0x7800000, 0x7f00000, 0x3f00000,
+    0xf00000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xf8000000, 0xfc000000, 0xfe000000,
+    0xe000000, 0xe000000, 0x6000000, 0x6000000, 0x6000000, 0x6000000, 0x6000000, 0x7000000, 0x7000000, 0x7800000,
+    0x3f00000, 0x1f00000, 0x3f00000, 0x7800000, 0x7000000, 0x7000000, 0x7000000, 0x6000000, 0x6000000, 0x6000000,
+    0x6000000, 0x6000000, 0xe000000, 0xe000000, 0xfe000000, 0xfc000000, 0xf8000000, 0xf801000, 0x3ff07000, 0x7ffff000,
+    0xf07fe000, 0xc00f8000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x0, 0x0, 0x0, 0x0, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x800000, 0x800000, 0x800000, 0x800000, 0x7f00000, 0x1ffc0000,
+    0x3ffc0000, 0x7c880000, 0x70800000, 0xf0800000, 0xe0800000, 0xe0800000, 0xe0800000, 0xe0800000, 0xe0800000,
+    0xe0800000, 0xf0800000, 0x70800000, 0x7c880000, 0x3ffc0000, 0x1ffc0000, 0x7f00000, 0x800000, 0x800000, 0x800000,
+    0x800000, 0x800000, 0x1fc0000, 0x3fe0000, 0x7fe0000, 0xf020000, 0xe000000, 0xe000000, 0xe000000, 0xe000000,
+    0xe000000, 0xe000000, 0x7ff80000, 0x7ff80000, 0x7ff80000, 0xe000000, 0xe000000, 0xe000000, 0xe000000, 0xe000000,
+    0xe000000, 0xe000000, 0xffff0000, 0xffff0000, 0xffff0000, 0x40010000, 0xe0038000, 0xf3c70000, 0x7ffe0000,
+    0x3ffc0000, 0x1c3c0000, 0x380c0000, 0x300e0000, 0x300e0000, 0x300e0000, 0x380c0000, 0x1c3c0000, 0x3ffc0000,
+    0x7ffe0000, 0xf3c70000, 0xe0038000, 0x40010000, 0xe0038000, 0xe0070000, 0x70070000, 0x700e0000, 0x380e0000,
+    0x381c0000, 0x1c180000, 0x1c380000, 0xe700000, 0xfe7f0000, 0xffff0000, 0x3e00000, 0x3c00000, 0x1c00000, 0xffff0000,
+    0xffff0000, 0x1c00000, 0x1c00000, 0x1c00000, 0x1c00000, 0x1c00000, 0x1c00000, 0x1c00000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0x0, 0x0, 0x0, 0x0, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x1f800000, 0x3fe00000, 0x78e00000, 0x70200000,
+    0xe0000000, 0x70000000, 0x78000000, 0x3c000000, 0x3f000000, 0xe7800000, 0xc1e00000, 0xc0f00000, 0xc0700000,
+    0xe0380000, 0xf0300000, 0x7c700000, 0x1fe00000, 0x7c00000, 0x3e00000, 0xe00000, 0xe00000, 0x600000, 0xe00000,
+    0x61e00000, 0x7fc00000, 0x3f000000, 0xf3c00000, 0xf3c00000, 0xf3c00000, 0x7e0000, 0x3ffc000, 0x781e000, 0xe007000,
+    0x18001800, 0x307e0c00, 0x31ff8c00, 0x63c18600, 0x63800600, 0x47000200, 0x47000200, 0xc7000300, 0x47000200,
+    0x47000200, 0x63800600, 0x63c18600, 0x31ff8c00, 0x307e0c00, 0x18001800, 0xe007000, 0x781e000, 0x3ffc000, 0x7e0000,
+    0x3f000000, 0x7f800000, 0x41c00000, 0xe00000, 0xe00000, 0x3fe00000, 0x7fe00000, 0xe0600000, 0xc0e00000, 0xc0e00000,
+    0xe1e00000, 0x7fe00000, 0x3e600000, 0x0, 0x0, 0xffe00000, 0xffe00000, 0x2000000, 0x60c0000, 0xe1c0000, 0x1c380000,
+    0x38f00000, 0xf1e00000, 0xe3800000, 0xe3800000, 0xf1e00000, 0x38f00000, 0x1c380000, 0xe1c0000, 0x60c0000, 0x2000000,
+    0xfffff000, 0xfffff000, 0xfffff000, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0xff000000, 0xff000000,
+    0xff000000, 0x7e0000, 0x3ffc000, 0x781e000, 0xe007000, 0x18001800, 0x31fe0c00, 0x31ff0c00, 0x61c38600, 0x61c18600,
+    0x41c18200, 0x41c38200, 0xc1ff0300, 0x41fe0200, 0x41ce0200, 0x61c70600, 0x61c38600, 0x31c18c00, 0x31c1cc00,
+    0x18001800, 0xe007000, 0x781e000, 0x3ffc000, 0x7e0000, 0xffc00000, 0xffc00000, 0xffc00000, 0x1e000000, 0x7f000000,
+    0x61800000, 0xc1c00000, 0xc0c00000, 0xc0c00000, 0xc0c00000, 0x61800000, 0x7f800000, 0x1e000000, 0x700000, 0x700000,
+    0x700000, 0x700000, 0x700000, 0x700000, 0xfffff000, 0xfffff000, 0xfffff000, 0x700000, 0x700000, 0x700000, 0x700000,
+    0x700000, 0x700000, 0x0, 0x0, 0xfffff000, 0xfffff000, 0xfffff000, 0x3e000000, 0x7f800000, 0x43c00000, 0x1c00000,
+    0x1800000, 0x1800000, 0x3000000, 0x6000000, 0xc000000, 0x38000000, 0x70000000, 0xffc00000, 0xffc00000, 0x7e000000,
+    0xff000000, 0x83800000, 0x3800000, 0x3000000, 0x3e000000, 0x3f000000, 0x3800000, 0x1800000, 0x1800000, 0x83800000,
+    0xff000000, 0x7e000000, 0xe000000, 0x1c000000, 0x38000000, 0x30000000, 0x60000000, 0xe0000000, 0xe01c0000,
+    0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000,
+    0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xf07e0000, 0xffff8000, 0xefef8000, 0xe7870000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x7fe0000, 0x1ffe0000, 0x3fc60000,
+    0x7fc60000, 0x7fc60000, 0x7fc60000, 0xffc60000, 0x7fc60000, 0x7fc60000, 0x7fc60000, 0x3fc60000, 0x1fc60000,
+    0x7c60000, 0x1c60000, 0x1c60000, 0x1c60000, 0x1c60000, 0x1c60000, 0x1c60000, 0x1c60000, 0x1c60000, 0x1c60000,
+    0x1c60000, 0x1c60000, 0x1c60000, 0x1c60000, 0xf0000000, 0xf0000000, 0xf0000000, 0xf0000000, 0x18000000, 0x18000000,
+    0xc000000, 0x1c000000, 0xfc000000, 0xf8000000, 0x3c000000, 0xfc000000, 0xcc000000, 0xc000000, 0xc000000, 0xc000000,
+    0xc000000, 0xc000000, 0xc000000, 0xc000000, 0xc000000, 0xff800000, 0xff800000, 0x1f000000, 0x7fc00000, 0x71c00000,
+    0xe0e00000, 0xc0600000, 0xc0600000, 0xc0700000, 0xc0600000, 0xc0600000, 0xe0e00000, 0x71e00000, 0x7fc00000,
+    0x1f000000, 0x0, 0x0, 0xffe00000, 0xffe00000, 0x80000000, 0xc1800000, 0xe1c00000, 0x71e00000, 0x38700000,
+    0x1c380000, 0xe1c0000, 0xe1c0000, 0x1c380000, 0x38700000, 0x71e00000, 0xe1c00000, 0xc1800000, 0x80000000,
+    0x3c001c00, 0xfc001800, 0xcc003000, 0xc007000, 0xc006000, 0xc00e000, 0xc01c000, 0xc018000, 0xc038000, 0xc030000,
+    0xc0601c0, 0xff8e03c0, 0xff8c07c0, 0x1804c0, 0x380cc0, 0x3018c0, 0x7030c0, 0xe020c0, 0xc07ff0, 0x1c07ff0, 0x18000c0,
+    0x30000c0, 0x70000c0, 0x3c001c00, 0xfc001800, 0xcc003000, 0xc007000, 0xc006000, 0xc00e000, 0xc01c000, 0xc018000,
+    0xc038000, 0xc030000, 0xc061f00, 0xff8e3fc0, 0xff8c21e0, 0x1800e0, 0x3800e0, 0x3000c0, 0x700180, 0xe00300, 0xc00600,
+    0x1c00c00, 0x1803800, 0x3003fe0, 0x7003fe0, 0x7e001c00, 0xff001800, 0x83803000, 0x3807000, 0x3006000, 0x3e00e000,
+    0x3f01c000, 0x3818000, 0x1838000, 0x1830000, 0x838601c0, 0xff0e03c0, 0x7e0c07c0, 0x1804c0, 0x380cc0, 0x3018c0,
+    0x7030c0, 0xe020c0, 0xc07ff0, 0x1c07ff0, 0x18000c0, 0x30000c0, 0x70000c0, 0x3800000, 0x3800000, 0x3800000,
+    0x3800000, 0x0, 0x0, 0x3800000, 0x3800000, 0x3800000, 0x3800000, 0x3800000, 0x7000000, 0xf000000, 0x1e000000,
+    0x3c000000, 0x38000000, 0x70000000, 0xf0000000, 0xe0000000, 0xf0000000, 0xf0080000, 0x78380000, 0x7ff80000,
+    0x3ff00000, 0xfc00000, 0xc00000, 0xe00000, 0x700000, 0x380000, 0x0, 0x0, 0x0, 0x780000, 0x780000, 0xfc0000,
+    0xfc0000, 0x1cc0000, 0x1ce0000, 0x1ce0000, 0x3870000, 0x3870000, 0x7070000, 0x7038000, 0x7038000, 0xe01c000,
+    0xe01c000, 0xfffc000, 0x1fffe000, 0x1fffe000, 0x3c00e000, 0x38007000, 0x38007000, 0x70007800, 0x70003800,
+    0xf0003800, 0x1c0000, 0x180000, 0x300000, 0x700000, 0x0, 0x0, 0x0, 0x780000, 0x780000, 0xfc0000, 0xfc0000,
+    0x1cc0000, 0x1ce0000, 0x1ce0000, 0x3870000, 0x3870000, 0x7070000, 0x7038000, 0x7038000, 0xe01c000, 0xe01c000,
+    0xfffc000, 0x1fffe000, 0x1fffe000, 0x3c00e000, 0x38007000, 0x38007000, 0x70007800, 0x70003800, 0xf0003800, 0x780000,
+    0xfc0000, 0x1cc0000, 0x1860000, 0x0, 0x0, 0x0, 0x780000, 0x780000, 0xfc0000, 0xfc0000, 0x1cc0000, 0x1ce0000,
+    0x1ce0000, 0x3870000, 0x3870000, 0x7070000, 0x7038000, 0x7038000, 0xe01c000, 0xe01c000, 0xfffc000, 0x1fffe000,
+    0x1fffe000, 0x3c00e000, 0x38007000, 0x38007000, 0x70007800, 0x70003800, 0xf0003800, 0x1c30000, 0x3f30000, 0x33e0000,
+    0x31e0000, 0x0, 0x0, 0x0, 0x780000, 0x780000, 0xfc0000, 0xfc0000, 0x1cc0000, 0x1ce0000, 0x1ce0000, 0x3870000,
+    0x3870000, 0x7070000, 0x7038000, 0x7038000, 0xe01c000, 0xe01c000, 0xfffc000, 0x1fffe000, 0x1fffe000, 0x3c00e000,
+    0x38007000, 0x38007000, 0x70007800, 0x70003800, 0xf0003800, 0x38f0000, 0x38f0000, 0x38f0000, 0x0, 0x0, 0x0,
+    0x780000, 0x780000, 0xfc0000, 0xfc0000, 0x1cc0000, 0x1ce0000, 0x1ce0000, 0x3870000, 0x3870000, 0x7070000, 0x7038000,
+    0x7038000, 0xe01c000, 0xe01c000, 0xfffc000, 0x1fffe000, 0x1fffe000, 0x3c00e000, 0x38007000, 0x38007000, 0x70007800,
+    0x70003800, 0xf0003800, 0x780000, 0xfc0000, 0x1ce0000, 0x1860000, 0x1860000, 0x1860000, 0x1ce0000, 0xfc0000,
+    0xf80000, 0xfc0000, 0xfc0000, 0x1ce0000, 0x1ce0000, 0x1ce0000, 0x3870000, 0x3870000, 0x7070000, 0x7038000,
+    0x7038000, 0xe01c000, 0xe01c000, 0x1fffc000, 0x1fffe000, 0x1fffe000, 0x3c00f000, 0x38007000, 0x38007000, 0x70007800,
+    0x70003800, 0xf0003800, 0x3ffff8, 0x7ffff8, 0x7ffff8, 0xf38000, 0xe38000, 0xe38000, 0x1c38000, 0x1c38000, 0x3838000,
+    0x383fff0, 0x783fff0, 0x703fff0, 0x7038000, 0xe038000, 0xfff8000, 0x1fff8000, 0x1fff8000, 0x3c038000, 0x38038000,
+    0x38038000, 0x7003fff8, 0x7003fff8, 0xf003fff8, 0x1fe0000, 0x7ffc000, 0xfffe000, 0x1f01e000, 0x3c002000, 0x78000000,
+    0x70000000, 0xf0000000, 0xf0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xf0000000,
+    0xf0000000, 0x70000000, 0x78000000, 0x3c002000, 0x1f01e000, 0xfffe000, 0x7ffc000, 0x1fe0000, 0x100000, 0x180000,
+    0x1c0000, 0x11c0000, 0x1f80000, 0x1f00000, 0xe000000, 0x7000000, 0x3000000, 0x1800000, 0x0, 0x0, 0x0, 0xfffe0000,
+    0xfffe0000, 0xfffe0000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xfffc0000,
+    0xfffc0000, 0xfffc0000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xfffe0000, 0xfffe0000, 0xfffe0000, 0xe00000, 0x1c00000, 0x3800000, 0x3000000, 0x0, 0x0, 0x0,
+    0xfffe0000, 0xfffe0000, 0xfffe0000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xfffc0000, 0xfffc0000, 0xfffc0000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xfffe0000, 0xfffe0000, 0xfffe0000, 0x3800000, 0x7c00000, 0xc600000, 0x18300000, 0x0, 0x0,
+    0x0, 0xfffe0000, 0xfffe0000, 0xfffe0000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xfffc0000, 0xfffc0000, 0xfffc0000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xfffe0000, 0xfffe0000, 0xfffe0000, 0x1c700000, 0x1c700000, 0x1c700000, 0x0, 0x0, 0x0,
+    0xfffe0000, 0xfffe0000, 0xfffe0000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xfffc0000, 0xfffc0000, 0xfffc0000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xfffe0000, 0xfffe0000, 0xfffe0000, 0xe0000000, 0x70000000, 0x38000000, 0x1c000000, 0x0,
+    0x0, 0x0, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000,
+    0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000,
+    0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x38000000, 0x70000000, 0x60000000,
+    0xc0000000, 0x0, 0x0, 0x0, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x1e000000, 0x3e000000,
+    0x73000000, 0xe1800000, 0x0, 0x0, 0x0, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000,
+    0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000,
+    0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0xe3800000,
+    0xe3800000, 0xe3800000, 0x0, 0x0, 0x0, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000,
+    0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000,
+    0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1ffe0000,
+    0x1fffc000, 0x1fffe000, 0x1c03f000, 0x1c007800, 0x1c003c00, 0x1c003c00, 0x1c001c00, 0x1c001e00, 0x1c001e00,
+    0xfff00e00, 0xfff00e00, 0xfff00e00, 0x1c001e00, 0x1c001e00, 0x1c001c00, 0x1c003c00, 0x1c003c00, 0x1c007800,
+    0x1c03f000, 0x1fffe000, 0x1fffc000, 0x1ffe0000, 0x70c0000, 0xfcc0000, 0xcf80000, 0xc780000, 0x0, 0x0, 0x0,
+    0xf801c000, 0xf801c000, 0xfc01c000, 0xfc01c000, 0xfe01c000, 0xee01c000, 0xe701c000, 0xe701c000, 0xe381c000,
+    0xe381c000, 0xe1c1c000, 0xe1e1c000, 0xe0e1c000, 0xe0f1c000, 0xe071c000, 0xe039c000, 0xe039c000, 0xe01dc000,
+    0xe01fc000, 0xe00fc000, 0xe00fc000, 0xe007c000, 0xe007c000, 0x1c00000, 0xe00000, 0x700000, 0x300000, 0x0, 0x0, 0x0,
+    0x1fc0000, 0x7ff0000, 0x1fffc000, 0x3f07e000, 0x3c01e000, 0x7800f000, 0x70007800, 0xf0007800, 0xf0003800,
+    0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xf0003800, 0xf0007800, 0x70007800, 0x7800f000,
+    0x3c01e000, 0x3f07e000, 0x1fffc000, 0x7ff0000, 0x1fc0000, 0x1c0000, 0x380000, 0x300000, 0x600000, 0x0, 0x0, 0x0,
+    0x1fc0000, 0x7ff0000, 0x1fffc000, 0x3f07e000, 0x3c01e000, 0x7800f000, 0x70007800, 0xf0007800, 0xf0003800,
+    0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xf0003800, 0xf0007800, 0x70007800, 0x7800f000,
+    0x3c01e000, 0x3f07e000, 0x1fffc000, 0x7ff0000, 0x1fc0000, 0x700000, 0xf80000, 0x18c0000, 0x3860000, 0x0, 0x0, 0x0,
+    0x1fc0000, 0x7ff0000, 0x1fffc000, 0x3f07e000, 0x3c01e000, 0x7800f000, 0x70007800, 0xf0007800, 0xf0003800,
+    0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xf0003800, 0xf0007800, 0x70007800, 0x7800f000,
+    0x3c01e000, 0x3f07e000, 0x1fffc000, 0x7ff0000, 0x1fc0000, 0x1c30000, 0x3f70000, 0x33e0000, 0x21c0000, 0x0, 0x0, 0x0,
+    0x1fc0000, 0x7ff0000, 0x1fffc000, 0x3f07e000, 0x3c01e000, 0x7800f000, 0x70007800, 0xf0007800, 0xf0003800,
+    0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xf0003800, 0xf0007800, 0x70007800, 0x7800f000,
+    0x3c01e000, 0x3f07e000, 0x1fffc000, 0x7ff0000, 0x1fc0000, 0x38e0000, 0x38e0000, 0x38e0000, 0x0, 0x0, 0x0, 0x1fc0000,
+    0x7ff0000, 0x1fffc000, 0x3f07e000, 0x3c01e000, 0x7800f000, 0x70007800, 0xf0007800, 0xf0003800, 0xe0003800,
+    0xe0003800, 0xe0003800, 0xe0003800, 0xe0003800, 0xf0003800, 0xf0007800, 0x70007800, 0x7800f000, 0x3c01e000,
+    0x3f07e000, 0x1fffc000, 0x7ff0000, 0x1fc0000, 0x40010000, 0xe0038000, 0xf0078000, 0x780f0000, 0x3c1e0000,
+    0x1e3c0000, 0xf780000, 0x7f00000, 0x3e00000, 0x3e00000, 0x7f00000, 0xf780000, 0x1e3c0000, 0x3c1e0000, 0x780f0000,
+    0xf0078000, 0xe0038000, 0x40010000, 0x1fc1800, 0x7ff3800, 0x1ffff000, 0x3f07e000, 0x3c01e000, 0x7801f000,
+    0x7003f000, 0xf0077800, 0xf00e3800, 0xe01c3800, 0xe0383800, 0xe0703800, 0xe0e03800, 0xe1c03800, 0xe3803800,
+    0xf7007800, 0x7e007800, 0x7c00f000, 0x3c01f000, 0x3f07e000, 0x7fffc000, 0xe7ff0000, 0xc0fc0000, 0x7000000,
+    0x3800000, 0x1c00000, 0xe00000, 0x0, 0x0, 0x0, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000,
+    0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000,
+    0xe003c000, 0xe003c000, 0xe0038000, 0xf0038000, 0x70078000, 0x7c0f0000, 0x3ffe0000, 0x1ffc0000, 0x7f00000, 0x700000,
+    0xe00000, 0xc00000, 0x1800000, 0x0, 0x0, 0x0, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000,
+    0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000,
+    0xe003c000, 0xe003c000, 0xe0038000, 0xf0038000, 0x70078000, 0x7c0f0000, 0x3ffe0000, 0x1ffc0000, 0x7f00000,
+    0x1e00000, 0x3e00000, 0x7300000, 0xe180000, 0x0, 0x0, 0x0, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000,
+    0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000,
+    0xe003c000, 0xe003c000, 0xe003c000, 0xe0038000, 0xf0038000, 0x70078000, 0x7c0f0000, 0x3ffe0000, 0x1ffc0000,
+    0x7f00000, 0xe380000, 0xe380000, 0xe380000, 0x0, 0x0, 0x0, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000,
+    0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000, 0xe003c000,
+    0xe003c000, 0xe003c000, 0xe003c000, 0xe0038000, 0xf0038000, 0x70078000, 0x7c0f0000, 0x3ffe0000, 0x1ffc0000,
+    0x7f00000, 0x380000, 0x300000, 0x600000, 0xc00000, 0x0, 0x0, 0x0, 0xf000e000, 0x7001e000, 0x3801c000, 0x3c038000,
+    0x1c078000, 0xe0f0000, 0xf0e0000, 0x71c0000, 0x3bc0000, 0x3f80000, 0x1f00000, 0xf00000, 0xe00000, 0xe00000,
+    0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe00000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xffe00000, 0xfff80000, 0xfffc0000, 0xe03c0000, 0xe01e0000, 0xe00e0000, 0xe00e0000,
+    0xe00e0000, 0xe00e0000, 0xe01e0000, 0xe03c0000, 0xfffc0000, 0xfff80000, 0xffe00000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xfc00000, 0x3ff00000, 0x7ff00000, 0x78780000, 0xe0380000, 0xe01c0000,
+    0xe07c0000, 0xe1f00000, 0xe1c00000, 0xe3800000, 0xe3800000, 0xe3800000, 0xe3c00000, 0xe1f00000, 0xe0780000,
+    0xe01e0000, 0xe00e0000, 0xe0070000, 0xe0070000, 0xe00f0000, 0xe41e0000, 0xe7fe0000, 0xe7fc0000, 0xe3f00000,
+    0x38000000, 0x1c000000, 0xe000000, 0x7000000, 0x3000000, 0x1800000, 0x0, 0x0, 0x1fc00000, 0x7ff00000, 0x7ff80000,
+    0x603c0000, 0x1c0000, 0xc0000, 0xe0000, 0xffe0000, 0x3ffe0000, 0x7ffe0000, 0xf00e0000, 0xe00e0000, 0xe01e0000,
+    0xe01e0000, 0xf07e0000, 0x7ffe0000, 0x7fce0000, 0x1f8e0000, 0x700000, 0xe00000, 0xc00000, 0x1c00000, 0x3800000,
+    0x7000000, 0x0, 0x0, 0x1fc00000, 0x7ff00000, 0x7ff80000, 0x603c0000, 0x1c0000, 0xc0000, 0xe0000, 0xffe0000,
+    0x3ffe0000, 0x7ffe0000, 0xf00e0000, 0xe00e0000, 0xe01e0000, 0xe01e0000, 0xf07e0000, 0x7ffe0000, 0x7fce0000,
+    0x1f8e0000, 0x3800000, 0x7800000, 0x7c00000, 0xce00000, 0x1c600000, 0x18300000, 0x0, 0x0, 0x1fc00000, 0x7ff00000,
+    0x7ff80000, 0x603c0000, 0x1c0000, 0xc0000, 0xe0000, 0xffe0000, 0x3ffe0000, 0x7ffe0000, 0xf00e0000, 0xe00e0000,
+    0xe01e0000, 0xe01e0000, 0xf07e0000, 0x7ffe0000, 0x7fce0000, 0x1f8e0000, 0xe300000, 0x1f300000, 0x31f00000,
+    0x30e00000, 0x0, 0x0, 0x0, 0x1fc00000, 0x7ff00000, 0x7ff80000, 0x603c0000, 0x1c0000, 0xc0000, 0xe0000, 0xffe0000,
+    0x3ffe0000, 0x7ffe0000, 0xf00e0000, 0xe00e0000, 0xe01e0000, 0xe01e0000, 0xf07e0000, 0x7ffe0000, 0x7fce0000,
+    0x1f8e0000, 0x1c700000, 0x1c700000, 0x1c700000, 0x0, 0x0, 0x0, 0x1fc00000, 0x7ff00000, 0x7ff80000, 0x603c0000,
+    0x1c0000, 0xc0000, 0xe0000, 0xffe0000, 0x3ffe0000, 0x7ffe0000, 0xf00e0000, 0xe00e0000, 0xe01e0000, 0xe01e0000,
+    0xf07e0000, 0x7ffe0000, 0x7fce0000, 0x1f8e0000, 0x7800000, 0xfc00000, 0x1c600000, 0x18600000, 0x18300000,
+    0x18600000, 0x1c600000, 0xfc00000, 0x7800000, 0x0, 0x0, 0x1fc00000, 0x7ff00000, 0x7ff80000, 0x603c0000, 0x1c0000,
+    0xc0000, 0xe0000, 0xffe0000, 0x3ffe0000, 0x7ffe0000, 0xf00e0000, 0xe00e0000, 0xe01e0000, 0xe01e0000, 0xf07e0000,
+    0x7ffe0000, 0x7fce0000, 0x1f8e0000, 0x1fc07e00, 0x7ff1ff80, 0x7ffbffc0, 0x603f81c0, 0x1f00e0, 0xe0060, 0xe0070,
+    0xffffff0, 0x3ffffff0, 0x7ffffff0, 0xf00e0000, 0xe00e0000, 0xe01e0000, 0xe03f0020, 0xf07fc0e0, 0x7ff3ffe0,
+    0x7fe1ffc0, 0x1f807f00, 0x7f00000, 0x1ffc0000, 0x3ffc0000, 0x7c0c0000, 0x70000000, 0xf0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xf0000000, 0x70000000, 0x7c0c0000, 0x3ffc0000,
+    0x1ffc0000, 0x7f00000, 0xc00000, 0x600000, 0x600000, 0x600000, 0x7e00000, 0x7c00000, 0x1c000000, 0xe000000,
+    0x7000000, 0x3000000, 0x1800000, 0x1c00000, 0x0, 0x0, 0x7e00000, 0x1ff80000, 0x3ffc0000, 0x7c1e0000, 0x700e0000,
+    0xe0070000, 0xe0070000, 0xffff0000, 0xffff0000, 0xffff0000, 0xe0000000, 0xe0000000, 0xf0000000, 0x70020000,
+    0x7c0e0000, 0x3ffe0000, 0x1ffc0000, 0x7f00000, 0x380000, 0x700000, 0x600000, 0xc00000, 0x1c00000, 0x3800000, 0x0,
+    0x0, 0x7e00000, 0x1ff80000, 0x3ffc0000, 0x7c1e0000, 0x700e0000, 0xe0070000, 0xe0070000, 0xffff0000, 0xffff0000,
+    0xffff0000, 0xe0000000, 0xe0000000, 0xf0000000, 0x70020000, 0x7c0e0000, 0x3ffe0000, 0x1ffc0000, 0x7f00000,
+    0x1c00000, 0x3c00000, 0x7e00000, 0x6700000, 0xc300000, 0xc180000, 0x0, 0x0, 0x7e00000, 0x1ff80000, 0x3ffc0000,
+    0x7c1e0000, 0x700e0000, 0xe0070000, 0xe0070000, 0xffff0000, 0xffff0000, 0xffff0000, 0xe0000000, 0xe0000000,
+    0xf0000000, 0x70020000, 0x7c0e0000, 0x3ffe0000, 0x1ffc0000, 0x7f00000, 0xe380000, 0xe380000, 0xe380000, 0x0, 0x0,
+    0x0, 0x7e00000, 0x1ff80000, 0x3ffc0000, 0x7c1e0000, 0x700e0000, 0xe0070000, 0xe0070000, 0xffff0000, 0xffff0000,
+    0xffff0000, 0xe0000000, 0xe0000000, 0xf0000000, 0x70020000, 0x7c0e0000, 0x3ffe0000, 0x1ffc0000, 0x7f00000,
+    0xe0000000, 0xe0000000, 0x70000000, 0x38000000, 0x18000000, 0xc000000, 0x0, 0x0, 0x1c000000, 0x1c000000, 0x1c000000,
+    0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000,
+    0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x18000000, 0x38000000,
+    0x70000000, 0xe0000000, 0xc0000000, 0x0, 0x0, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0x1c000000, 0x3e000000, 0x36000000, 0x67000000, 0xe3000000,
+    0xc1800000, 0x0, 0x0, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000,
+    0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000,
+    0x1c000000, 0x1c000000, 0xe3800000, 0xe3800000, 0xe3800000, 0x0, 0x0, 0x0, 0x1c000000, 0x1c000000, 0x1c000000,
+    0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000,
+    0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1c000000, 0x1e000000, 0xf1c0000, 0x7f80000, 0x7c00000,
+    0x3fc00000, 0x20e00000, 0x700000, 0x7f80000, 0x1ffc0000, 0x3ffc0000, 0x7c1e0000, 0x700e0000, 0xe00e0000, 0xe0070000,
+    0xe0070000, 0xe0070000, 0xe0070000, 0xe00f0000, 0xe00e0000, 0x701e0000, 0x7c3c0000, 0x3ffc0000, 0x1ff80000,
+    0x7e00000, 0xe100000, 0x1f300000, 0x39f00000, 0x30e00000, 0x0, 0x0, 0x0, 0xe3e00000, 0xeff80000, 0xfff80000,
+    0xf83c0000, 0xf01c0000, 0xe01c0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000,
+    0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0xe00e0000, 0x1c000000, 0xe000000, 0x6000000, 0x7000000,
+    0x3800000, 0x1c00000, 0x0, 0x0, 0x7e00000, 0x1ff80000, 0x3ffc0000, 0x7c3c0000, 0x701e0000, 0xf00e0000, 0xe00f0000,
+    0xe0070000, 0xe0070000, 0xe0070000, 0xe0070000, 0xe00f0000, 0xf00e0000, 0x701e0000, 0x7c3c0000, 0x3ffc0000,
+    0x1ff80000, 0x7e00000, 0x380000, 0x700000, 0xe00000, 0x1c00000, 0x1800000, 0x3000000, 0x0, 0x0, 0x7e00000,
+    0x1ff80000, 0x3ffc0000, 0x7c3c0000, 0x701e0000, 0xf00e0000, 0xe00f0000, 0xe0070000, 0xe0070000, 0xe0070000,
+    0xe0070000, 0xe00f0000, 0xf00e0000, 0x701e0000, 0x7c3c0000, 0x3ffc0000, 0x1ff80000, 0x7e00000, 0x3800000, 0x3c00000,
+    0x7e00000, 0xe600000, 0xc300000, 0x18300000, 0x0, 0x0, 0x7e00000, 0x1ff80000, 0x3ffc0000, 0x7c3c0000, 0x701e0000,
+    0xf00e0000, 0xe00f0000, 0xe0070000, 0xe0070000, 0xe0070000, 0xe0070000, 0xe00f0000, 0xf00e0000, 0x701e0000,
+    0x7c3c0000, 0x3ffc0000, 0x1ff80000, 0x7e00000, 0xe180000, 0x1f180000, 0x19f00000, 0x18f00000, 0x0, 0x0, 0x0,
+    0x7e00000, 0x1ff80000, 0x3ffc0000, 0x7c3c0000, 0x701e0000, 0xf00e0000, 0xe00f0000, 0xe0070000, 0xe0070000,
+    0xe0070000, 0xe0070000, 0xe00f0000, 0xf00e0000, 0x701e0000, 0x7c3c0000, 0x3ffc0000, 0x1ff80000, 0x7e00000,
+    0x1c700000, 0x1c700000, 0x1c700000, 0x0, 0x0, 0x0, 0x7e00000, 0x1ff80000, 0x3ffc0000, 0x7c3c0000, 0x701e0000,
+    0xf00e0000, 0xe00f0000, 0xe0070000, 0xe0070000, 0xe0070000, 0xe0070000, 0xe00f0000, 0xf00e0000, 0x701e0000,
+    0x7c3c0000, 0x3ffc0000, 0x1ff80000, 0x7e00000, 0xf00000, 0xf00000, 0xf00000, 0xf00000, 0x0, 0x0, 0x0, 0xfffff000,
+    0xfffff000, 0xfffff000, 0x0, 0x0, 0x0, 0xf00000, 0xf00000, 0xf00000, 0xf00000, 0x8000, 0x3e18000, 0xffb8000,
+    0x1fff0000, 0x3e1e0000, 0x380f0000, 0x781f0000, 0x70370000, 0x70638000, 0x70c38000, 0x71c38000, 0x73838000,
+    0x77078000, 0x7e070000, 0x3c0f0000, 0x3e1f0000, 0x3ffe0000, 0x6ffc0000, 0xe3f00000, 0x40000000, 0x38000000,
+    0x1c000000, 0xc000000, 0x6000000, 0x7000000, 0x3800000, 0x0, 0x0, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000,
+    0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000,
+    0xe03c0000, 0xf07c0000, 0x7ffc0000, 0x3fdc0000, 0x1f1c0000, 0x700000, 0xe00000, 0x1c00000, 0x1800000, 0x3000000,
+    0x7000000, 0x0, 0x0, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000,
+    0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe03c0000, 0xf07c0000, 0x7ffc0000, 0x3fdc0000,
+    0x1f1c0000, 0x7000000, 0x7800000, 0xfc00000, 0xcc00000, 0x18600000, 0x30700000, 0x0, 0x0, 0xe01c0000, 0xe01c0000,
+    0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000,
+    0xe01c0000, 0xe01c0000, 0xe03c0000, 0xf07c0000, 0x7ffc0000, 0x3fdc0000, 0x1f1c0000, 0x38f00000, 0x38f00000,
+    0x38f00000, 0x0, 0x0, 0x0, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000,
+    0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe01c0000, 0xe03c0000, 0xf07c0000, 0x7ffc0000,
+    0x3fdc0000, 0x1f1c0000, 0x380000, 0x300000, 0x700000, 0xe00000, 0x1c00000, 0x1800000, 0x0, 0x0, 0xe0038000,
+    0x70070000, 0x70070000, 0x70070000, 0x380e0000, 0x380e0000, 0x1c1c0000, 0x1c1c0000, 0x1c1c0000, 0xe380000,
+    0xe380000, 0x6700000, 0x7700000, 0x7f00000, 0x3e00000, 0x3e00000, 0x1c00000, 0x1c00000, 0x1c00000, 0x3800000,
+    0x3800000, 0x7000000, 0x3f000000, 0x3e000000, 0x3c000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe0000000, 0xe0000000, 0xe3e00000, 0xeff80000, 0xfffc0000, 0xfc3c0000, 0xf01e0000, 0xf00e0000, 0xe00e0000,
+    0xe00e0000, 0xe0070000, 0xe0070000, 0xe00e0000, 0xe00e0000, 0xf00e0000, 0xf01e0000, 0xfc3c0000, 0xfffc0000,
+    0xeff80000, 0xe3e00000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000, 0xe0000000,
+    0xe380000, 0xe380000, 0xe380000, 0x0, 0x0, 0x0, 0xe0038000, 0x70070000, 0x70070000, 0x70070000, 0x380e0000,
+    0x380e0000, 0x1c1c0000, 0x1c1c0000, 0x1c1c0000, 0xe380000, 0xe380000, 0x6700000, 0x7700000, 0x7f00000, 0x3e00000,
+    0x3e00000, 0x1c00000, 0x1c00000, 0x1c00000, 0x3800000, 0x3800000, 0x7000000, 0x3f000000, 0x3e000000, 0x3c000000,
+};
+
+#endif /* SUBTITLE_FONT_H */
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Rasterize DejaVu Sans into the 1 bit font of subtitle_font.h.
+
+usage: gen_subtitle_font.py [DejaVuSans.ttf] > subtitle_font.h
+
+Needs Pillow. The output is committed, the build does not run this.
+"""
+
+import sys
+
+from PIL import Image, ImageDraw, ImageFont
+
+FONT_SIZE = 32
+# widest glyph kept, one uint32_t per row
+MAX_WIDTH = 32
+# U+0020-U+007E then U+00A0-U+00FF, sub_font_index() in ffplayer.c maps code points the same way
+CODE_POINTS = list(range(0x20, 0x7F)) + list(range(0xA0, 0x100))
+
+NOTICE = """\
+Copyright (c) 2003 by Bitstream, Inc. All Rights Reserved. Bitstream Vera is a trademark of Bitstream, Inc.
+DejaVu changes are in public domain.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of the fonts accompanying this
+license ("Fonts") and associated documentation files (the "Font Software"), to reproduce and distribute the
+Font Software, including without limitation the rights to use, copy, merge, publish, distribute, and/or sell
+copies of the Font Software, and to permit persons to whom the Font Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright and trademark notices and this permission notice shall be included in all copies of one
+or more of the Font Software typefaces.
+
+The Font Software may be modified, altered, or added to, and in particular the designs of glyphs or characters
+in the Fonts may be modified and additional glyphs or characters may be added to the Fonts, only if the fonts
+are renamed to names not containing either the words "Bitstream" or the word "Vera".
+
+This License becomes null and void to the extent applicable to Fonts or Font Software that has been modified
+and is distributed under the "Bitstream Vera" names.
+
+The Font Software may be sold as part of a larger software package but no copy of one or more of the Font
+Software typefaces may be sold by itself.
+
+THE FONT SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+LIMITED TO ANY WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF
+COPYRIGHT, PATENT, TRADEMARK, OR OTHER RIGHT. IN NO EVENT SHALL BITSTREAM OR THE GNOME FOUNDATION BE LIABLE
+FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, INCLUDING ANY GENERAL, SPECIAL, INDIRECT, INCIDENTAL, OR
+CONSEQUENTIAL DAMAGES, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF THE USE OR
+INABILITY TO USE THE FONT SOFTWARE OR FROM OTHER DEALINGS IN THE FONT SOFTWARE.
+
+Except as contained in this notice, the names of Gnome, the Gnome Foundation, and Bitstream Inc., shall not
+be used in advertising or otherwise to promote the sale, use or other dealings in this Font Software without
+prior written authorization from the Gnome Foundation or Bitstream Inc., respectively. For further
+information, contact: fonts at gnome dot org."""
+
+
+def rasterize(font):
+    ascent, descent = font.getmetrics()
+    height = ascent + descent
+    glyphs = []
+    rows = []
+
+    for cp in CODE_POINTS:
+        ch = chr(cp)
+        advance = int(round(font.getlength(ch)))
+
+        # drawn 8 pixels in so glyphs reaching left of the pen are kept
+        img = Image.new('L', (64, height), 0)
+        ImageDraw.Draw(img).text((8, 0), ch, font=font, fill=255)
+        px = img.load()
+
+        ink = [(x, y) for y in range(height) for x in range(64) if px[x, y] >= 128]
+        if not ink:
+            glyphs.append((advance, 0, 0, 0, 0, len(rows)))
+            continue
+
+        x0 = min(x for x, _ in ink)
+        x1 = min(max(x for x, _ in ink) + 1, x0 + MAX_WIDTH)
+        y0 = min(y for _, y in ink)
+        y1 = max(y for _, y in ink) + 1
+
+        first = len(rows)
+        for y in range(y0, y1):
+            bits = 0
+            for x in range(x0, x1):
+                if px[x, y] >= 128:
+                    bits |= 1 << (31 - (x - x0))
+            rows.append(bits)
+
+        glyphs.append((advance, x0 - 8, y0, x1 - x0, y1 - y0, first))
+
+    return height, ascent, glyphs, rows
+
+
+def wrap(items, out):
+    line = '   '
+    for item in items:
+        if len(line) + len(item) + 1 > 120:
+            out.append(line)
+            line = '   '
+        line += ' ' + item
+    out.append(line)
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else '/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf'
+    height, ascent, glyphs, rows = rasterize(ImageFont.truetype(path, FONT_SIZE))
+
+    out = [
+        '/* generated by tools/gen_subtitle_font.py, do not edit */',
+        '',
+        '#ifndef SUBTITLE_FONT_H',
+        '#define SUBTITLE_FONT_H',
+        '',
+        '#include <stdint.h>',
+        '',
+        '#define SUB_FONT_HEIGHT %d' % height,
+        '#define SUB_FONT_ASCENT %d' % ascent,
+        '',
+        '/*',
+        ' * DejaVu Sans %dpx, 1 bit, U+0020-U+007E then U+00A0-U+00FF: advance, x offset, top, width, height, first row.' % FONT_SIZE,
+        ' * Rasterized from DejaVuSans.ttf, which is under the following notice:',
+        ' *',
+    ]
+    out += [(' * ' + line).rstrip() for line in NOTICE.split('\n')]
+    out += [
+        ' */',
+        'static const struct',
+        '{',
+        '    uint8_t advance;',
+        '    int8_t xoff;',
+        '    uint8_t top;',
+        '    uint8_t w;',
+        '    uint8_t h;',
+        '    uint16_t row;',
+        '} sub_font_glyphs[] = {',
+    ]
+    wrap(['{%d, %d, %d, %d, %d, %d},' % g for g in glyphs], out)
+    out += [
+        '};',
+        '',
+        '/* glyph rows, leftmost pixel in bit 31 */',
+        'static const uint32_t sub_font_rows[] = {',
+    ]
+    wrap(['0x%x,' % r for r in rows], out)
+    out += [
+        '};',
+        '',
+        '#endif /* SUBTITLE_FONT_H */',
+    ]
+
+    sys.stdout.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()